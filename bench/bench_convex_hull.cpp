@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/2D/convex_hull.hpp"
+
+using namespace Geometry;
+
+static void BM_HullMonotoneChain(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  size_t hullSize = 0;
+  for (auto _ : state) {
+    std::vector<uint32_t> hull = ConvexHull::monotoneChain(points);
+    hullSize = hull.size();
+    benchmark::DoNotOptimize(hull.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+  state.counters["hull"] = (double) hullSize;
+}
+
+static void BM_HullParallel(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  size_t hullSize = 0;
+  for (auto _ : state) {
+    std::vector<uint32_t> hull = ConvexHull::parallelHull(points);
+    hullSize = hull.size();
+    benchmark::DoNotOptimize(hull.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+  state.counters["hull"] = (double) hullSize;
+}
+
+BENCHMARK(BM_HullMonotoneChain)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HullParallel)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,22 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/2D/delaunay.hpp"
+
+using namespace Geometry;
+
+static void BM_DelaunayTriangulate(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+
+  size_t triangles = 0;
+  for (auto _ : state) {
+    Triangulation result = Delaunay::triangulate(points);
+    triangles = result.triangleCount();
+    benchmark::DoNotOptimize(result.triangles.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+  state.counters["triangles/s"] = benchmark::Counter((double) triangles * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_DelaunayTriangulate)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
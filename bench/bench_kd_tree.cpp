@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/spatial/kd_tree.hpp"
+
+using namespace Spatial;
+
+static void BM_KdTreeBuild(benchmark::State &state) {
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), (size_t) state.range(0));
+  KdTree<Vector2D> tree;
+  for (auto _ : state) {
+    tree.build(points);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+static void BM_KdTreeNearest(benchmark::State &state) {
+  Bench::Distribution distribution = Bench::distributionArgument(state, 1);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(distribution, 1000000);
+  std::vector<Vector2D> queries = Bench::generatePoints<Vector2D>(distribution, (size_t) state.range(0), Bench::QUERY_SEED);
+  KdTree<Vector2D> tree;
+  tree.build(points);
+  std::vector<Neighbor> result;
+  for (auto _ : state) {
+    for (const Vector2D &query : queries) {
+      tree.nearest(query, 8, result);
+      benchmark::DoNotOptimize(result.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_KdTreeNearestBatch(benchmark::State &state) {
+  Bench::Distribution distribution = Bench::distributionArgument(state, 1);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(distribution, 1000000);
+  std::vector<Vector2D> queries = Bench::generatePoints<Vector2D>(distribution, (size_t) state.range(0), Bench::QUERY_SEED);
+  KdTree<Vector2D> tree;
+  tree.build(points);
+  std::vector<Neighbor> result;
+  for (auto _ : state) {
+    tree.nearestBatch(queries, 8, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_KdTreeBuild)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KdTreeNearest)->ArgsProduct({ { 100000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "queries", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KdTreeNearestBatch)->ArgsProduct({ { 100000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "queries", "distribution" })->Unit(benchmark::kMillisecond);
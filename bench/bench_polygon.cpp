@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../src/math/geometry.hpp"
+
+using namespace Geometry;
+
+/**
+ * @brief Previous Polygon::calculateVertices path: two trig calls through degreeToRadian per vertex
+ */
+static void trigVertices(Vector2D centerPt, float radius, unsigned int n, Vector2D *vertices) {
+  float omega = 360.0f / n;
+  for (unsigned int i = 0; i < n; i++) {
+    vertices[i].vector[0] = centerPt.vector[0] + radius * cos(Angles::degreeToRadian(i * omega));
+    vertices[i].vector[1] = centerPt.vector[1] + radius * sin(Angles::degreeToRadian(i * omega));
+  }
+}
+
+static void BM_PolygonVerticesTrig(benchmark::State &state) {
+  unsigned int n = (unsigned int) state.range(0);
+  std::vector<Vector2D> vertices(n);
+  Vector2D center = { 0.0f, 0.0f };
+  for (auto _ : state) {
+    trigVertices(center, 0.5f, n, vertices.data());
+    benchmark::DoNotOptimize(vertices.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_PolygonVerticesRotor(benchmark::State &state) {
+  unsigned int n = (unsigned int) state.range(0);
+  std::vector<Vector2D> vertices(n);
+  Vector2D center = { 0.0f, 0.0f };
+  for (auto _ : state) {
+    RegularPolygons::generateVertices(center, 0.5f, n, 0.0f, vertices.data());
+    benchmark::DoNotOptimize(vertices.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_PolygonVerticesTrig)->RangeMultiplier(10)->Range(10, 10000000);
+BENCHMARK(BM_PolygonVerticesRotor)->RangeMultiplier(10)->Range(10, 10000000);
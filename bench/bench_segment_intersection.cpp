@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/2D/segment_intersection.hpp"
+
+using namespace Geometry;
+
+/**
+ * @brief n segments of length up to length, centred on points drawn from distribution
+ */
+static std::vector<Segment> randomSegments(Bench::Distribution distribution, size_t n, float length) {
+  std::vector<Vector2D> centers = Bench::generatePoints<Vector2D>(distribution, n, 11);
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+  std::vector<Segment> segments(n);
+  for (size_t i = 0; i < n; i++) {
+    float x = centers[i].vector[0], y = centers[i].vector[1];
+    float dx = length * offset(rng), dy = length * offset(rng);
+    segments[i] = { { x - dx, y - dy }, { x + dx, y + dy } };
+  }
+  return segments;
+}
+
+static void BM_SegmentSweep(benchmark::State &state) {
+  std::vector<Segment> segments = randomSegments(Bench::distributionArgument(state, 1), (size_t) state.range(0), 1.0f / 500.0f);
+  size_t found = 0;
+  for (auto _ : state) {
+    SegmentIntersection::sweep(segments, [&](std::span<const Intersection> batch) { found += batch.size(); });
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+static void BM_SegmentGridSweep(benchmark::State &state) {
+  std::vector<Segment> segments = randomSegments(Bench::distributionArgument(state, 1), (size_t) state.range(0), 1.0f / 500.0f);
+  size_t found = 0;
+  for (auto _ : state) {
+    SegmentIntersection::gridSweep(segments, [&](std::span<const Intersection> batch) { found += batch.size(); });
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+BENCHMARK(BM_SegmentSweep)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SegmentGridSweep)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/2D/shapes.hpp"
+#include "../src/graphics/shader_file.hpp"
+#include "../src/math/geometry.hpp"
+
+using namespace Geometry;
+
+#ifndef COMPGEOM_SOURCE_DIR
+  # define COMPGEOM_SOURCE_DIR "."
+#endif
+
+static void BM_PolygonCalculateVertices(benchmark::State &state) {
+  Shapes::Polygon polygon(Shapes::LINE_SHAPE);
+  Vector2D center = { 0.25f, -0.25f };
+  polygon.setCenterPt(center);
+  polygon.setRadius(0.5f);
+  polygon.setRotation(15.0f);
+  polygon.setNumberOfSides((unsigned int) state.range(0));
+  for (auto _ : state) {
+    polygon.calculateVertices();
+    benchmark::DoNotOptimize(polygon.getVertices());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Per-frame shape churn: many small polygons moved and recomputed, as the render loop does
+ */
+static void BM_PolygonCalculateVerticesMany(benchmark::State &state) {
+  size_t count = (size_t) state.range(0);
+  std::vector<Vector2D> centers = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), count);
+  std::vector<Shapes::Polygon> polygons;
+  polygons.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    polygons.emplace_back(Shapes::FILL_SHAPE);
+    polygons[i].setRadius(0.01f);
+    polygons[i].setNumberOfSides(3 + (unsigned int) (i % 6));
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; i++) {
+      polygons[i].setCenterPt(centers[i]);
+      polygons[i].calculateVertices();
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_DegreeToRadian(benchmark::State &state) {
+  std::vector<float> degrees(4096), radians(4096);
+  for (size_t i = 0; i < degrees.size(); i++) degrees[i] = (float) i * 0.087890625f;
+  for (auto _ : state) {
+    for (size_t i = 0; i < degrees.size(); i++) radians[i] = Angles::degreeToRadian(degrees[i]);
+    benchmark::DoNotOptimize(radians.data());
+  }
+  state.SetItemsProcessed(state.iterations() * degrees.size());
+}
+
+static void BM_ReadShaderFile(benchmark::State &state) {
+  static const char *SHADERS[] = {
+    COMPGEOM_SOURCE_DIR "/src/shaders/basic/vertex_shader.vert",
+    COMPGEOM_SOURCE_DIR "/src/shaders/basic/fragment_shader.frag",
+    COMPGEOM_SOURCE_DIR "/src/shaders/basic/polygon_instanced.vert"
+  };
+  const char *path = SHADERS[state.range(0)];
+  size_t bytes = Graphics::readShaderFile(path).size();
+  if (bytes == 0) {
+    state.SkipWithError("shader file not found, set COMPGEOM_SOURCE_DIR");
+    return;
+  }
+  for (auto _ : state) {
+    std::string source = Graphics::readShaderFile(path);
+    benchmark::DoNotOptimize(source.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK(BM_PolygonCalculateVertices)->RangeMultiplier(10)->Range(3, 1000000);
+BENCHMARK(BM_PolygonCalculateVerticesMany)->ArgsProduct({ { 10000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "shapes", "distribution" });
+BENCHMARK(BM_DegreeToRadian);
+BENCHMARK(BM_ReadShaderFile)->DenseRange(0, 2)->ArgName("shader");
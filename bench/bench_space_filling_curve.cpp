@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/math/space_filling_curve.hpp"
+
+using namespace Geometry;
+
+static void BM_CurveKeys(benchmark::State &state) {
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 2), (size_t) state.range(0));
+  CurveType curve = state.range(1) == 0 ? MORTON_CURVE : HILBERT_CURVE;
+  std::vector<uint32_t> keys;
+  for (auto _ : state) {
+    SpaceFillingCurve::computeKeys(points, curve, keys);
+    benchmark::DoNotOptimize(keys.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+static void BM_HilbertSortPoints(benchmark::State &state) {
+  std::vector<Vector2D> original = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), (size_t) state.range(0));
+  std::vector<Vector2D> points;
+  for (auto _ : state) {
+    state.PauseTiming();
+    points = original;
+    state.ResumeTiming();
+    std::vector<uint32_t> order = SpaceFillingCurve::sortPoints(points);
+    benchmark::DoNotOptimize(order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * original.size());
+}
+
+BENCHMARK(BM_CurveKeys)->ArgsProduct({ { 1000000 }, { 0, 1 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "hilbert", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HilbertSortPoints)->ArgsProduct({ { 10000, 100000, 1000000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/spatial/spatial_hash.hpp"
+
+using namespace Spatial;
+
+// about one point per cell for points spread over [-1, 1]^2
+static float cellSizeFor(size_t n) {
+  return 2.0f / std::sqrt((float) n);
+}
+
+static void BM_SpatialHashRebuild(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  SpatialHashGrid grid(cellSizeFor(n));
+  for (auto _ : state) {
+    grid.build(points);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_SpatialHashNeighbors(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  float cellSize = cellSizeFor(n);
+  SpatialHashGrid grid(cellSize);
+  grid.build(points);
+  for (auto _ : state) {
+    size_t found = 0;
+    for (const Vector2D &p : points) grid.forEachNeighbor(p, cellSize, [&](uint32_t, float) { found++; });
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_SpatialHashRadiusAll(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  float cellSize = cellSizeFor(n);
+  SpatialHashGrid grid(cellSize);
+  std::vector<uint32_t> offsets;
+  std::vector<Neighbor> neighbors;
+  for (auto _ : state) {
+    grid.build(points);
+    grid.radiusAll(cellSize, offsets, neighbors);
+    benchmark::DoNotOptimize(neighbors.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_SpatialHashRebuild)->ArgsProduct({ { 10000, 100000, 1000000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SpatialHashNeighbors)->ArgsProduct({ { 10000, 100000, 1000000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SpatialHashRadiusAll)->ArgsProduct({ { 10000, 100000, 1000000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
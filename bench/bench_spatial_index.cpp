@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/spatial/loose_quadtree.hpp"
+#include "../src/spatial/rtree.hpp"
+
+using namespace Spatial;
+
+// half extent of the boxes and shapes placed at every point
+static const float ENTRY_SIZE = 0.002f;
+
+static std::vector<BoundingBox> boxesAround(const std::vector<Vector2D> &points) {
+  std::vector<BoundingBox> boxes(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    const Vector2D &p = points[i];
+    boxes[i] = { { p.vector[0] - ENTRY_SIZE, p.vector[1] - ENTRY_SIZE }, { p.vector[0] + ENTRY_SIZE, p.vector[1] + ENTRY_SIZE } };
+  }
+  return boxes;
+}
+
+static void BM_RTreeBuild(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<BoundingBox> boxes = boxesAround(Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n));
+  RTree tree;
+  for (auto _ : state) {
+    tree.build(boxes);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_RTreeWindowQuery(benchmark::State &state) {
+  Bench::Distribution distribution = Bench::distributionArgument(state, 1);
+  RTree tree;
+  tree.build(boxesAround(Bench::generatePoints<Vector2D>(distribution, 1000000)));
+  std::vector<BoundingBox> windows = boxesAround(Bench::generatePoints<Vector2D>(distribution, (size_t) state.range(0), Bench::QUERY_SEED));
+  std::vector<uint32_t> result;
+  for (auto _ : state) {
+    for (const BoundingBox &window : windows) {
+      tree.query(window, result);
+      benchmark::DoNotOptimize(result.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * windows.size());
+}
+
+static void BM_RTreeNearest(benchmark::State &state) {
+  Bench::Distribution distribution = Bench::distributionArgument(state, 1);
+  RTree tree;
+  tree.build(boxesAround(Bench::generatePoints<Vector2D>(distribution, 1000000)));
+  std::vector<Vector2D> queries = Bench::generatePoints<Vector2D>(distribution, (size_t) state.range(0), Bench::QUERY_SEED);
+  std::vector<Neighbor> result;
+  for (auto _ : state) {
+    for (const Vector2D &query : queries) {
+      tree.nearest(query, 8, result);
+      benchmark::DoNotOptimize(result.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+/**
+ * @brief One frame of moving shapes: every shape drifts a little and is re-filed, the common case the loose
+ * bounds keep in place
+ */
+static void BM_LooseQuadtreeUpdate(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> points = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  std::vector<std::unique_ptr<Shapes::Shape2D>> shapes;
+  LooseQuadtree tree({ 0.0f, 0.0f }, 1.0f);
+  for (Vector2D &p : points) {
+    shapes.emplace_back(Shapes::ShapeFactory::constructShape(Shapes::POLYGON, Shapes::FILL_SHAPE));
+    shapes.back()->setRadius(ENTRY_SIZE);
+    shapes.back()->setCenterPt(p);
+    tree.insertShape(shapes.back().get());
+  }
+
+  float step = ENTRY_SIZE * 0.1f;
+  for (auto _ : state) {
+    for (std::unique_ptr<Shapes::Shape2D> &shape : shapes) {
+      Vector2D center = shape->getCenterPt();
+      center.vector[0] += step;
+      shape->setCenterPt(center);
+      tree.updateShape(shape.get());
+    }
+    step = -step;
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_RTreeBuild)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RTreeWindowQuery)->ArgsProduct({ { 100000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "queries", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RTreeNearest)->ArgsProduct({ { 100000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "queries", "distribution" })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LooseQuadtreeUpdate)->ArgsProduct({ { 10000, 100000 }, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "shapes", "distribution" })->Unit(benchmark::kMillisecond);
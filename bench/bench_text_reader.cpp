@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/io/text_point_reader.hpp"
+
+using namespace IO;
+
+/**
+ * @brief Points printed the way exporters usually write them, 9 significant digits split by separator
+ */
+static std::string pointText(const std::vector<Vector3D> &points, char separator) {
+  std::string text;
+  char line[96];
+  for (const Vector3D &p : points) {
+    int length = std::snprintf(line, sizeof(line), "%.9g%c%.9g%c%.9g\n", p.vector[0], separator, p.vector[1], separator, p.vector[2]);
+    text.append(line, (size_t) length);
+  }
+  return text;
+}
+
+static void BM_ParseText(benchmark::State &state) {
+  std::vector<Vector3D> points = Bench::generatePoints<Vector3D>(Bench::UNIFORM, (size_t) state.range(0));
+  TextFormat format = state.range(1) == 0 ? XYZ_FORMAT : CSV_FORMAT;
+  std::string text = pointText(points, format == XYZ_FORMAT ? ' ' : ',');
+  Geometry::PointBuffer buffer;
+  for (auto _ : state) {
+    TextPointReader::parse(text, format, buffer);
+    benchmark::DoNotOptimize(buffer.x());
+  }
+  state.SetLabel(format == XYZ_FORMAT ? "xyz" : "csv");
+  state.SetBytesProcessed(state.iterations() * text.size());
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK(BM_ParseText)->ArgsProduct({ { 100000, 1000000, 10000000 }, { 0, 1 } })->ArgNames({ "n", "csv" })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "../src/2D/polygon_triangulation.hpp"
+
+using namespace Geometry;
+
+/**
+ * @brief Star shaped outline: n vertices around the unit circle with radii jittered by up to noise
+ */
+static std::vector<Vector2D> jitteredCircle(size_t n, float noise) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> radius(1.0f - noise, 1.0f);
+  std::vector<Vector2D> vertices(n);
+  for (size_t i = 0; i < n; i++) {
+    double angle = 2.0 * M_PI * i / n;
+    float r = radius(rng);
+    vertices[i] = { (float) (r * std::cos(angle)), (float) (r * std::sin(angle)) };
+  }
+  return vertices;
+}
+
+static void BM_EarClipping(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> vertices = jitteredCircle(n, 1e-4f);
+  PolygonTriangulator triangulator;
+  std::vector<uint32_t> triangles;
+  for (auto _ : state) {
+    triangulator.triangulate(vertices, {}, triangles);
+    benchmark::DoNotOptimize(triangles.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_EarClipping)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
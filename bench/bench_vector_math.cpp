@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "../src/math/vector_math.hpp"
+
+using namespace Geometry;
+
+static const size_t POINT_COUNT = 1 << 16;
+
+template <typename Vector, int dimensions>
+static std::vector<Vector> randomVectors(size_t n, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  std::vector<Vector> vectors(n);
+  for (Vector &v : vectors) {
+    for (int d = 0; d < dimensions; d++) v.vector[d] = coordinate(rng);
+  }
+  return vectors;
+}
+
+/**
+ * @brief Run one batch kernel at the SIMD level given by the first benchmark argument, reporting points per second
+ */
+template <typename Vector, int dimensions, typename Kernel>
+static void runKernel(benchmark::State &state, Kernel kernel) {
+  SimdLevel level = (SimdLevel) state.range(0);
+  if (level > CpuFeatures::detectSimdLevel()) {
+    state.SkipWithError("SIMD level not supported by this CPU");
+    return;
+  }
+  VectorBatch::setSimdLevel(level);
+  state.SetLabel(CpuFeatures::simdLevelName(level));
+
+  std::vector<Vector> a = randomVectors<Vector, dimensions>(POINT_COUNT, 1);
+  std::vector<Vector> b = randomVectors<Vector, dimensions>(POINT_COUNT, 2);
+  std::vector<Vector> vectorOut(POINT_COUNT);
+  std::vector<float> scalarOut(POINT_COUNT);
+  for (auto _ : state) {
+    kernel(a.data(), b.data(), vectorOut.data(), scalarOut.data(), POINT_COUNT);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+  VectorBatch::setSimdLevel(CpuFeatures::detectSimdLevel());
+}
+
+#define VECTOR_KERNEL_BENCHMARK(name, Vector, dimensions, call) \
+  static void name(benchmark::State &state) { \
+    runKernel<Vector, dimensions>(state, [](const Vector *a, const Vector *b, Vector *out, float *values, size_t n) { \
+      (void) a; (void) b; (void) out; (void) values; call; \
+    }); \
+  } \
+  BENCHMARK(name)->DenseRange(SIMD_SCALAR, SIMD_AVX2)
+
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DAdd, Vector2D, 2, VectorBatch::add(a, b, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DSub, Vector2D, 2, VectorBatch::sub(a, b, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DDot, Vector2D, 2, VectorBatch::dot(a, b, values, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DCross, Vector2D, 2, VectorBatch::cross(a, b, values, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DLength, Vector2D, 2, VectorBatch::length(a, values, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DNormalize, Vector2D, 2, VectorBatch::normalize(a, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector2DLerp, Vector2D, 2, VectorBatch::lerp(a, b, 0.25f, out, n));
+
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DAdd, Vector3D, 3, VectorBatch::add(a, b, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DSub, Vector3D, 3, VectorBatch::sub(a, b, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DDot, Vector3D, 3, VectorBatch::dot(a, b, values, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DCross, Vector3D, 3, VectorBatch::cross(a, b, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DLength, Vector3D, 3, VectorBatch::length(a, values, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DNormalize, Vector3D, 3, VectorBatch::normalize(a, out, n));
+VECTOR_KERNEL_BENCHMARK(BM_Vector3DLerp, Vector3D, 3, VectorBatch::lerp(a, b, 0.25f, out, n));
@@ -0,0 +1,22 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "distributions.hpp"
+#include "../src/2D/voronoi.hpp"
+
+using namespace Geometry;
+
+static void BM_VoronoiFortune(benchmark::State &state) {
+  size_t n = (size_t) state.range(0);
+  std::vector<Vector2D> sites = Bench::generatePoints<Vector2D>(Bench::distributionArgument(state, 1), n);
+  Vector2D boxMin = { -1.5f, -1.5f }, boxMax = { 1.5f, 1.5f };
+  size_t edges = 0;
+  for (auto _ : state) {
+    VoronoiDiagram diagram = Voronoi::build(sites, boxMin, boxMax);
+    edges = diagram.edges.size();
+    benchmark::DoNotOptimize(diagram.edges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+  state.counters["edges"] = (double) edges;
+}
+
+BENCHMARK(BM_VoronoiFortune)->ArgsProduct({ Bench::POINT_COUNTS, Bench::ALL_DISTRIBUTIONS })->ArgNames({ "n", "distribution" })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,104 @@
+#ifndef BENCH_DISTRIBUTIONS_HPP
+#define BENCH_DISTRIBUTIONS_HPP
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../src/vectors.hpp"
+
+/**
+ * @brief Seeded input sets shared by every benchmark, so runs on different commits measure identical inputs
+ */
+namespace Bench {
+  enum Distribution {
+    UNIFORM, GAUSSIAN, CLUSTERED, ON_CIRCLE
+  };
+
+  // benchmark argument lists covering every distribution and the usual input sizes
+  static const std::vector<int64_t> ALL_DISTRIBUTIONS = { UNIFORM, GAUSSIAN, CLUSTERED, ON_CIRCLE };
+  static const std::vector<int64_t> POINT_COUNTS = { 1000, 10000, 100000, 1000000 };
+
+  // indexed points and query points come from different seeds so queries are not exact hits
+  static const uint32_t POINT_SEED = 42;
+  static const uint32_t QUERY_SEED = 7;
+
+  // clusters drawn for CLUSTERED and their spread
+  static const unsigned int CLUSTER_COUNT = 64;
+  static const float CLUSTER_SIGMA = 0.02f;
+
+  inline const char *distributionName(Distribution distribution) {
+    switch (distribution) {
+      case UNIFORM: return "uniform";
+      case GAUSSIAN: return "gaussian";
+      case CLUSTERED: return "clustered";
+      case ON_CIRCLE: return "on-circle";
+    }
+    return "";
+  }
+
+  /**
+   * @brief n points in [-1, 1]^D: uniform, one gaussian (sigma 0.25) at the origin, gaussian blobs around
+   * CLUSTER_COUNT uniform centres, or exactly on the unit circle / sphere (the cocircular worst case for
+   * Delaunay and hull code). Out of range samples are clamped
+   */
+  template <typename Vector>
+  std::vector<Vector> generatePoints(Distribution distribution, size_t n, uint32_t seed = POINT_SEED) {
+    const unsigned int DIMENSIONS = sizeof(Vector) / sizeof(float);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::normal_distribution<float> wide(0.0f, 0.25f);
+    std::normal_distribution<float> narrow(0.0f, CLUSTER_SIGMA);
+
+    std::vector<Vector> centers(CLUSTER_COUNT);
+    for (Vector &center : centers) {
+      for (unsigned int d = 0; d < DIMENSIONS; d++) center.vector[d] = coordinate(rng);
+    }
+
+    std::vector<Vector> points(n);
+    for (Vector &p : points) {
+      switch (distribution) {
+        case UNIFORM:
+          for (unsigned int d = 0; d < DIMENSIONS; d++) p.vector[d] = coordinate(rng);
+          break;
+        case GAUSSIAN:
+          for (unsigned int d = 0; d < DIMENSIONS; d++) p.vector[d] = std::clamp(wide(rng), -1.0f, 1.0f);
+          break;
+        case CLUSTERED: {
+          const Vector &center = centers[rng() % CLUSTER_COUNT];
+          for (unsigned int d = 0; d < DIMENSIONS; d++) p.vector[d] = std::clamp(center.vector[d] + narrow(rng), -1.0f, 1.0f);
+          break;
+        }
+        case ON_CIRCLE: {
+          double length;
+          double direction[DIMENSIONS];
+          do {
+            length = 0.0;
+            for (unsigned int d = 0; d < DIMENSIONS; d++) {
+              direction[d] = coordinate(rng);
+              length += direction[d] * direction[d];
+            }
+          } while (length > 1.0 || length < 1e-6);
+          length = std::sqrt(length);
+          for (unsigned int d = 0; d < DIMENSIONS; d++) p.vector[d] = (float) (direction[d] / length);
+          break;
+        }
+      }
+    }
+    return points;
+  }
+
+  /**
+   * @brief Distribution named by benchmark argument index, also set as the run's label so the JSON output
+   * records which input every measurement used
+   */
+  inline Distribution distributionArgument(benchmark::State &state, int index) {
+    Distribution distribution = (Distribution) state.range(index);
+    state.SetLabel(distributionName(distribution));
+    return distribution;
+  }
+}
+
+#endif
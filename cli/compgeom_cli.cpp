@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "../src/2D/convex_hull.hpp"
+#include "../src/2D/delaunay.hpp"
+#include "../src/2D/polygon_triangulation.hpp"
+#include "../src/2D/polyline_simplification.hpp"
+#include "../src/2D/voronoi.hpp"
+#include "../src/io/point_file.hpp"
+#include "../src/io/text_point_reader.hpp"
+#include "../src/parallel/thread_pool.hpp"
+
+using namespace Geometry;
+
+/**
+ * @brief Headless batch front end: read a point or polygon file, run one algorithm, write the result and report
+ * timings plus peak memory on stderr. Links compgeom_core only, so it runs without a display
+ */
+
+static const char *USAGE =
+  "usage: compgeom-cli <hull|triangulate|voronoi|simplify|convert> <input> [options]\n"
+  "\n"
+  "Input is text with one \"x y\" vertex per line (commas also separate), '#' starts a comment and '-'\n"
+  "reads stdin. .csv, .ply and .obj files are read as CSV, ASCII PLY and OBJ vertices, z is dropped.\n"
+  "Blank lines separate rings: with --polygon the first ring is the outline and the rest are holes.\n"
+  "Files ending in .cgp are binary point files, mapped instead of parsed, and hold a single ring.\n"
+  "\n"
+  "options:\n"
+  "  -o, --output FILE   write the result to FILE instead of stdout\n"
+  "  -t, --threads N     threads to run on, 1 to 1024, 1 runs everything on the calling thread\n"
+  "                      (default: all cores)\n"
+  "  -q, --quiet         do not write the result, only report timings\n"
+  "  --polygon           triangulate: ear clip the rings instead of a Delaunay triangulation of the points\n"
+  "  --tolerance T       simplify: largest distance of a dropped vertex from the result, at least 0\n"
+  "                      (default 0.001)\n"
+  "  --closed            simplify: the input is a closed ring\n"
+  "\n"
+  "output:\n"
+  "  hull          \"x y\" per hull vertex, counterclockwise\n"
+  "  triangulate   \"a b c\" vertex indices per triangle, counterclockwise\n"
+  "  voronoi       \"x0 y0 x1 y1\" per edge, clipped to the input bounds plus a 10% margin\n"
+  "  simplify      \"x y\" per kept vertex\n"
+  "  convert       the input points, unchanged\n"
+  "Point results (hull, simplify, convert) are written as a binary point file when FILE ends in .cgp.\n";
+
+struct Options {
+  std::string algorithm;
+  std::string input;
+  std::string output;
+  unsigned int threads = 0;
+  bool quiet = false;
+  bool polygon = false;
+  bool closed = false;
+  double tolerance = 1e-3;
+};
+
+struct InputData {
+  std::vector<Vector2D> points;
+  // index of the first vertex of every ring after the first
+  std::vector<uint32_t> ringStarts;
+};
+
+class Stopwatch {
+  public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    double elapsedMs() const {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->start).count();
+    }
+  private:
+    std::chrono::steady_clock::time_point start;
+};
+
+static double peakResidentMB() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+  return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+// most threads --threads accepts, far above any core count but well short of exhausting the process
+static const unsigned long MAX_THREADS = 1024;
+
+/**
+ * @brief Parse a whole option value as a thread count in [1, MAX_THREADS]
+ */
+static bool parseThreads(const char *text, unsigned int &threads) {
+  // strtoul skips leading space and accepts a sign, both would let garbage through
+  if (!std::isdigit((unsigned char) text[0])) return false;
+  char *end;
+  errno = 0;
+  unsigned long count = std::strtoul(text, &end, 10);
+  if (*end != '\0' || errno == ERANGE || count == 0 || count > MAX_THREADS) return false;
+  threads = (unsigned int) count;
+  return true;
+}
+
+/**
+ * @brief Parse a whole option value as a finite, non-negative distance
+ */
+static bool parseTolerance(const char *text, double &tolerance) {
+  char *end;
+  errno = 0;
+  double value = std::strtod(text, &end);
+  if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(value) || value < 0.0) return false;
+  tolerance = value;
+  return true;
+}
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&]() -> const char * {
+      if (i + 1 >= argc) {
+        std::fprintf(stderr, "compgeom-cli: %s needs a value\n", arg.c_str());
+        return NULL;
+      }
+      return argv[++i];
+    };
+
+    if (arg == "-h" || arg == "--help") {
+      std::fputs(USAGE, stdout);
+      std::exit(0);
+    } else if (arg == "-o" || arg == "--output") {
+      const char *path = value();
+      if (path == NULL) return false;
+      options.output = path;
+    } else if (arg == "-t" || arg == "--threads") {
+      const char *count = value();
+      if (count == NULL) return false;
+      if (!parseThreads(count, options.threads)) {
+        std::fprintf(stderr, "compgeom-cli: %s expects a whole number from 1 to %lu, got \"%s\"\n", arg.c_str(), MAX_THREADS, count);
+        return false;
+      }
+    } else if (arg == "--tolerance") {
+      const char *tolerance = value();
+      if (tolerance == NULL) return false;
+      if (!parseTolerance(tolerance, options.tolerance)) {
+        std::fprintf(stderr, "compgeom-cli: %s expects a finite distance of at least 0, got \"%s\"\n", arg.c_str(), tolerance);
+        return false;
+      }
+    } else if (arg == "-q" || arg == "--quiet") {
+      options.quiet = true;
+    } else if (arg == "--polygon") {
+      options.polygon = true;
+    } else if (arg == "--closed") {
+      options.closed = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      std::fprintf(stderr, "compgeom-cli: unknown option %s\n", arg.c_str());
+      return false;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  if (positional.size() != 2) return false;
+  options.algorithm = positional[0];
+  options.input = positional[1];
+  return true;
+}
+
+/**
+ * @brief Read point files with the parallel text reader, or through the mapping for .cgp files
+ */
+static bool readPoints(const std::string &path, InputData &data) {
+  if (IO::isPointFilePath(path)) {
+    IO::MappedPointFile mapped;
+    if (!mapped.open(path)) {
+      std::fprintf(stderr, "compgeom-cli: %s is not a readable point file\n", path.c_str());
+      return false;
+    }
+    data.points.resize(mapped.size());
+    mapped.copyInterleaved(0, mapped.size(), data.points.data());
+    return true;
+  }
+
+  Geometry::PointBuffer buffer;
+  if (!IO::TextPointReader::read(path, buffer)) {
+    std::fprintf(stderr, "compgeom-cli: cannot read points from %s\n", path.c_str());
+    return false;
+  }
+  data.points.resize(buffer.size());
+  buffer.copyInterleaved(0, buffer.size(), data.points.data());
+  return true;
+}
+
+/**
+ * @brief Read "x y" lines into points, recording where every blank-line separated ring starts
+ *
+ * @return bool Whether the file could be opened and every vertex line parsed
+ */
+static bool readRings(const std::string &path, InputData &data) {
+  FILE *file = path == "-" ? stdin : std::fopen(path.c_str(), "r");
+  if (file == NULL) {
+    std::fprintf(stderr, "compgeom-cli: cannot open %s\n", path.c_str());
+    return false;
+  }
+
+  // getline grows the buffer to fit, a fixed one would split long lines into bogus vertices
+  char *line = NULL;
+  size_t capacity = 0;
+  size_t lineNumber = 0;
+  bool ringOpen = false;
+  bool ok = true;
+  while (getline(&line, &capacity, file) != -1) {
+    lineNumber++;
+    char *comment = std::strchr(line, '#');
+    if (comment != NULL) *comment = '\0';
+    for (char *c = line; *c; c++) {
+      if (*c == ',') *c = ' ';
+    }
+
+    char *cursor = line;
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') cursor++;
+    if (*cursor == '\0') {
+      // blank line ends the current ring
+      ringOpen = false;
+      continue;
+    }
+
+    char *end;
+    double x = std::strtod(cursor, &end);
+    if (end == cursor) {
+      ok = false;
+      break;
+    }
+    cursor = end;
+    double y = std::strtod(cursor, &end);
+    if (end == cursor) {
+      ok = false;
+      break;
+    }
+
+    if (!ringOpen && !data.points.empty()) data.ringStarts.push_back((uint32_t) data.points.size());
+    ringOpen = true;
+    data.points.push_back({ (float) x, (float) y });
+  }
+
+  if (!ok) std::fprintf(stderr, "compgeom-cli: %s:%zu: expected \"x y\"\n", path.c_str(), lineNumber);
+  std::free(line);
+  if (file != stdin) std::fclose(file);
+  return ok;
+}
+
+static FILE *openOutput(const Options &options) {
+  if (options.output.empty()) return stdout;
+  FILE *file = std::fopen(options.output.c_str(), "w");
+  if (file == NULL) std::fprintf(stderr, "compgeom-cli: cannot write %s\n", options.output.c_str());
+  return file;
+}
+
+static bool closeOutput(FILE *file) {
+  if (file == stdout) return std::fflush(stdout) == 0;
+  return std::fclose(file) == 0;
+}
+
+/**
+ * @brief Write the indexed points, or all of them when indices is NULL, as text or as a binary point file
+ */
+static bool writePoints(const Options &options, std::span<const Vector2D> points, const std::vector<uint32_t> *indices) {
+  if (IO::isPointFilePath(options.output)) {
+    Geometry::PointBuffer buffer;
+    if (indices == NULL) {
+      buffer.assign(points.data(), points.size());
+    } else {
+      buffer.resize(indices->size());
+      for (size_t i = 0; i < indices->size(); i++) buffer.set(i, points[(*indices)[i]]);
+    }
+    if (IO::PointFile::write(options.output, buffer)) return true;
+    std::fprintf(stderr, "compgeom-cli: cannot write %s\n", options.output.c_str());
+    return false;
+  }
+
+  FILE *file = openOutput(options);
+  if (file == NULL) return false;
+  size_t count = indices == NULL ? points.size() : indices->size();
+  for (size_t i = 0; i < count; i++) {
+    const Vector2D &p = points[indices == NULL ? i : (*indices)[i]];
+    std::fprintf(file, "%.9g %.9g\n", p.vector[0], p.vector[1]);
+  }
+  return closeOutput(file);
+}
+
+static bool writeTriangles(const Options &options, const std::vector<uint32_t> &triangles) {
+  FILE *file = openOutput(options);
+  if (file == NULL) return false;
+  for (size_t t = 0; t + 2 < triangles.size(); t += 3) std::fprintf(file, "%u %u %u\n", triangles[t], triangles[t + 1], triangles[t + 2]);
+  return closeOutput(file);
+}
+
+static bool writeSegments(const Options &options, const std::vector<Vector2D> &endpoints) {
+  FILE *file = openOutput(options);
+  if (file == NULL) return false;
+  for (size_t i = 0; i + 1 < endpoints.size(); i += 2) {
+    std::fprintf(file, "%.9g %.9g %.9g %.9g\n", endpoints[i].vector[0], endpoints[i].vector[1], endpoints[i + 1].vector[0], endpoints[i + 1].vector[1]);
+  }
+  return closeOutput(file);
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::fputs(USAGE, stderr);
+    return 2;
+  }
+  const std::string &algorithm = options.algorithm;
+  if (algorithm != "hull" && algorithm != "triangulate" && algorithm != "voronoi" && algorithm != "simplify" && algorithm != "convert") {
+    std::fprintf(stderr, "compgeom-cli: unknown algorithm %s\n", algorithm.c_str());
+    return 2;
+  }
+  if (IO::isPointFilePath(options.output) && (algorithm == "triangulate" || algorithm == "voronoi")) {
+    std::fprintf(stderr, "compgeom-cli: %s does not produce points, it cannot be written to a .cgp file\n", algorithm.c_str());
+    return 2;
+  }
+  if (options.threads != 0) Parallel::ThreadPool::setGlobalConcurrency(options.threads);
+
+  InputData data;
+  Stopwatch readTimer;
+  bool ringsNeeded = algorithm == "triangulate" && options.polygon;
+  // point files hold no ring breaks, with --polygon they are read as a single outline
+  bool textRings = options.input == "-" || (ringsNeeded && !IO::isPointFilePath(options.input));
+  if (!(textRings ? readRings(options.input, data) : readPoints(options.input, data))) return 1;
+  double readMs = readTimer.elapsedMs();
+  std::span<const Vector2D> points = data.points;
+  if (ringsNeeded) {
+    std::fprintf(stderr, "read         %zu vertices, %zu rings in %.2f ms\n", points.size(), data.ringStarts.size() + (points.empty() ? 0 : 1), readMs);
+  } else {
+    std::fprintf(stderr, "read         %zu vertices in %.2f ms\n", points.size(), readMs);
+  }
+
+  // results, only the ones of the chosen algorithm are filled
+  std::vector<uint32_t> indices;
+  std::vector<Vector2D> segments;
+  size_t resultCount = 0;
+  const char *resultName = "";
+
+  Stopwatch runTimer;
+  if (algorithm == "hull") {
+    indices = ConvexHull::parallelHull(points);
+    resultCount = indices.size();
+    resultName = "hull vertices";
+  } else if (algorithm == "triangulate" && options.polygon) {
+    indices = PolygonTriangulator::triangulatePolygon(points, data.ringStarts);
+    resultCount = indices.size() / 3;
+    resultName = "triangles";
+  } else if (algorithm == "triangulate") {
+    indices = Delaunay::triangulate(points).triangles;
+    resultCount = indices.size() / 3;
+    resultName = "triangles";
+  } else if (algorithm == "voronoi") {
+    Vector2D low = { 0.0f, 0.0f }, high = { 0.0f, 0.0f };
+    if (!points.empty()) {
+      low = high = points[0];
+      for (const Vector2D &p : points) {
+        for (unsigned int axis = 0; axis < 2; axis++) {
+          low.vector[axis] = std::min(low.vector[axis], p.vector[axis]);
+          high.vector[axis] = std::max(high.vector[axis], p.vector[axis]);
+        }
+      }
+    }
+    float margin = 0.1f * std::max({ high.vector[0] - low.vector[0], high.vector[1] - low.vector[1], 1e-6f });
+    low = { low.vector[0] - margin, low.vector[1] - margin };
+    high = { high.vector[0] + margin, high.vector[1] + margin };
+    VoronoiDiagram diagram = Voronoi::build(points, low, high);
+    segments = Voronoi::edgeSegments(diagram);
+    resultCount = segments.size() / 2;
+    resultName = "edges";
+  } else if (algorithm == "simplify") {
+    indices = PolylineSimplification::douglasPeucker(points, options.tolerance, options.closed);
+    resultCount = indices.size();
+    resultName = "kept vertices";
+  } else {
+    resultCount = points.size();
+    resultName = "points";
+  }
+  double runMs = runTimer.elapsedMs();
+  std::fprintf(stderr, "%-12s %zu %s in %.2f ms on %u threads\n", algorithm.c_str(), resultCount, resultName, runMs,
+    Parallel::ThreadPool::global().getConcurrency());
+
+  if (!options.quiet) {
+    Stopwatch writeTimer;
+    bool written;
+    if (algorithm == "hull" || algorithm == "simplify") {
+      written = writePoints(options, points, &indices);
+    } else if (algorithm == "convert") {
+      written = writePoints(options, points, NULL);
+    } else if (algorithm == "triangulate") {
+      written = writeTriangles(options, indices);
+    } else {
+      written = writeSegments(options, segments);
+    }
+    if (!written) return 1;
+    std::fprintf(stderr, "write        %.2f ms\n", writeTimer.elapsedMs());
+  }
+
+  std::fprintf(stderr, "peak rss     %.1f MB\n", peakResidentMB());
+  return 0;
+}
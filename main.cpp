@@ -1,11 +1,16 @@
 #include <stddef.h>
 #include "src/2D/shapes.hpp"
+#include "src/graphics/batch_renderer.hpp"
+#include "src/graphics/instanced_renderer.hpp"
+#include "src/logging/logger.hpp"
+#include "src/spatial/loose_quadtree.hpp"
 
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
 
 using namespace Shapes;
 using namespace Graphics;
+using namespace Spatial;
 
 int run();
 
@@ -15,11 +20,10 @@ void mainLoop(SDL_Window* window);
 int sdlDie(const char* exitMessage);
 
 // define shaders
-const std::string vertexShaderCode = GraphicsUtilities::read_shader_file("./src/shaders/basic/vertex_shader.vert");
-GLchar* vertexShaderSource = (GLchar *) vertexShaderCode.c_str();
-
-const std::string fragmentShaderCode = GraphicsUtilities::read_shader_file("./src/shaders/basic/fragment_shader.frag");
-GLchar* fragmentShaderSource = (GLchar *) fragmentShaderCode.c_str();
+const char* vertexShaderPath = "./src/shaders/basic/vertex_shader.vert";
+const char* fragmentShaderPath = "./src/shaders/basic/fragment_shader.frag";
+const char* instancedVertexShaderPath = "./src/shaders/basic/polygon_instanced.vert";
+const char* instancedFragmentShaderPath = "./src/shaders/basic/fragment_shader_other.frag";
 
 // program entry point
 int main(void)
@@ -82,45 +86,58 @@ int run() {
 void mainLoop(SDL_Window* window) {
   SDL_Event e;
   bool quit = false;
+
+  // programs are compiled and linked once, then reused for every event
+  ShaderRegistry shaderRegistry;
+  unsigned int shaderProgram = shaderRegistry.getProgram(vertexShaderPath, fragmentShaderPath);
+  unsigned int instancedShaderProgram = shaderRegistry.getProgram(instancedVertexShaderPath, instancedFragmentShaderPath);
+  if (shaderProgram == 0 || instancedShaderProgram == 0) return;
+  shaderRegistry.reportTimings();
+
+  // every shape is gathered into one buffer per drawing style and drawn in a single call
+  BatchRenderer renderer;
+
+  Polygon *polygon = (Polygon*) ShapeFactory::constructShape(POLYGON, VERTEX_SHAPE);
+  Vector2D center = { 0.0f, 0.0f };
+  polygon->setNumberOfSides(4);
+  polygon->setCenterPt(center);
+  polygon->setRadius(0.5f);
+  polygon->calculateVertices();
+  renderer.addShape(polygon);
+
+  // bounding circles of the scene's shapes in clip space, for picking under the cursor
+  LooseQuadtree shapeTree(center, 1.0f);
+  shapeTree.insertShape(polygon);
+  std::vector<Shape2D*> picked;
+
+  // regular polygons drawn from their parameters alone, vertices are generated on the GPU
+  InstancedPolygonRenderer instancedRenderer;
+  PolygonInstance hexagon = { center, 0.75f, 30.0f };
+  instancedRenderer.addInstance(6, LINE_SHAPE, hexagon);
+
   while (quit == false) {
     SDL_GL_SwapWindow(window);
     while (SDL_PollEvent(&e)){
       if( e.type == SDL_QUIT ) { quit = true; }
+      else if (e.type == SDL_MOUSEBUTTONDOWN) {
+        Vector2D cursor = { 2.0f * e.button.x / SCREEN_WIDTH - 1.0f, 1.0f - 2.0f * e.button.y / SCREEN_HEIGHT };
+        shapeTree.queryPoint(cursor, picked);
+        LOG_DEBUG("Viewer", "picked %zu shape(s) at (%f, %f)", picked.size(), cursor.vector[0], cursor.vector[1]);
+      }
       else {
         // prevents crazy flickering (TODO - research color/depth buffer bits)
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // create vertex shader
-        unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-        GraphicsUtilities::createShader(vertexShaderSource, vertexShader);
-
-        // create fragment shader
-        unsigned int fragmentShader= glCreateShader(GL_FRAGMENT_SHADER);
-        GraphicsUtilities::createShader(fragmentShaderSource, fragmentShader);
-
-        // create shader program
-        Shaders shaderProgram = Shaders(vertexShader, fragmentShader);
-
-        // cleanup and delete shaders
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-
-        Polygon *polygon = (Polygon*) ShapeFactory::constructShape(POLYGON, VERTEX_SHAPE);
-        Vector2D center = { 0.0f, 0.0f };
-        polygon->setNumberOfSides(4);
-        polygon->setCenterPt(center);
-        polygon->setRadius(0.5f);
-        polygon->calculateVertices();
-
-        GraphicsUtilities::drawPoints(
-          shaderProgram.getShaderProgram(),
-          polygon->getVertices(),
-          polygon->getNumberOfSides()
-        );
+        renderer.draw(shaderProgram);
+        instancedRenderer.draw(instancedShaderProgram);
       }
     }
   }
+
+  renderer.removeShape(polygon);
+  shapeTree.removeShape(polygon);
+  delete polygon;
 }
 
 /**
@@ -0,0 +1,16 @@
+# Build and run the benchmarks, keeping JSON results per commit in bench/results/<commit>.json
+# Extra arguments go to the benchmark binary, e.g. sh scripts/bench.sh --benchmark_filter=Delaunay
+set -e
+commit=$(git rev-parse --short HEAD)
+mkdir -p build bench/results
+
+cd build
+cmake -DCMAKE_BUILD_TYPE=Release ..
+make comp_geometry_bench
+
+cd ..
+./build/comp_geometry_bench \
+  --benchmark_out=bench/results/$commit.json \
+  --benchmark_out_format=json \
+  --benchmark_context=commit=$commit \
+  "$@"
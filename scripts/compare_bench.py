@@ -0,0 +1,44 @@
+"""Compare two benchmark JSON files written by scripts/bench.sh.
+
+usage: python3 scripts/compare_bench.py bench/results/<old>.json bench/results/<new>.json [threshold]
+
+Prints the time ratio of every benchmark present in both runs and exits with status 1 when any of them got
+slower by more than threshold (default 0.10, i.e. 10%).
+"""
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        runs = json.load(file)["benchmarks"]
+    # aggregates (mean, median, ...) only appear with --benchmark_repetitions, compare the plain runs
+    return {run["name"]: run for run in runs if run.get("run_type", "iteration") == "iteration"}
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        return 2
+    old, new = load(sys.argv[1]), load(sys.argv[2])
+    threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 0.10
+
+    regressions = 0
+    for name in sorted(old.keys() & new.keys()):
+        before, after = old[name]["cpu_time"], new[name]["cpu_time"]
+        ratio = after / before if before > 0 else 1.0
+        flag = ""
+        if ratio > 1.0 + threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-80s %12.3f %12.3f %s %+7.1f%%%s" % (name, before, after, new[name]["time_unit"], (ratio - 1.0) * 100, flag))
+
+    for name in sorted(old.keys() - new.keys()):
+        print("%-80s removed" % name)
+    for name in sorted(new.keys() - old.keys()):
+        print("%-80s added" % name)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include "convex_hull.hpp"
+#include "../math/predicates.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Geometry {
+  // points tested per block by the octagon filter, small enough for the signs to stay in L1
+  static const uint32_t FILTER_BLOCK = 1024;
+
+  static inline bool lexicographicLess(const Vector2D &a, const Vector2D &b) {
+    return a.vector[0] < b.vector[0] || (a.vector[0] == b.vector[0] && a.vector[1] < b.vector[1]);
+  }
+
+  static inline bool samePoint(const Vector2D &a, const Vector2D &b) {
+    return a.vector[0] == b.vector[0] && a.vector[1] == b.vector[1];
+  }
+
+  /**
+   * @brief Monotone chain over a subset of the points. indices is sorted in place
+   */
+  std::vector<uint32_t> ConvexHull::chainOfIndices(std::span<const Vector2D> points, std::vector<uint32_t> &indices) {
+    std::sort(indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) {
+      return lexicographicLess(points[a], points[b]);
+    });
+    indices.erase(std::unique(indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) {
+      return samePoint(points[a], points[b]);
+    }), indices.end());
+
+    size_t n = indices.size();
+    if (n < 3) return indices;
+
+    std::vector<uint32_t> hull(2 * n);
+    size_t k = 0;
+
+    // lower chain, left to right
+    for (size_t i = 0; i < n; i++) {
+      while (k >= 2 && Predicates::orient2d(points[hull[k - 2]], points[hull[k - 1]], points[indices[i]]) <= 0.0) k--;
+      hull[k++] = indices[i];
+    }
+
+    // upper chain, right to left
+    size_t lowerSize = k + 1;
+    for (size_t i = n - 1; i-- > 0;) {
+      while (k >= lowerSize && Predicates::orient2d(points[hull[k - 2]], points[hull[k - 1]], points[indices[i]]) <= 0.0) k--;
+      hull[k++] = indices[i];
+    }
+
+    // the last point repeats the first
+    hull.resize(k - 1);
+    return hull;
+  }
+
+  std::vector<uint32_t> ConvexHull::monotoneChain(std::span<const Vector2D> points) {
+    std::vector<uint32_t> indices(points.size());
+    for (uint32_t i = 0; i < indices.size(); i++) indices[i] = i;
+    return chainOfIndices(points, indices);
+  }
+
+  std::vector<uint32_t> ConvexHull::aklToussaintFilter(std::span<const Vector2D> points, uint32_t first, uint32_t last) {
+    std::vector<uint32_t> survivors;
+    if (last - first < 16) {
+      for (uint32_t i = first; i < last; i++) survivors.push_back(i);
+      return survivors;
+    }
+
+    // extreme points in counterclockwise direction order:
+    // -x, -(x+y), -y, (x-y), x, (x+y), y, -(x-y)
+    uint32_t extreme[8];
+    float best[8];
+    for (int d = 0; d < 8; d++) {
+      extreme[d] = first;
+    }
+    auto score = [](const Vector2D &p, int direction) {
+      float x = p.vector[0], y = p.vector[1];
+      switch (direction) {
+        case 0: return -x;
+        case 1: return -(x + y);
+        case 2: return -y;
+        case 3: return x - y;
+        case 4: return x;
+        case 5: return x + y;
+        case 6: return y;
+        default: return y - x;
+      }
+    };
+    for (int d = 0; d < 8; d++) best[d] = score(points[first], d);
+    for (uint32_t i = first + 1; i < last; i++) {
+      for (int d = 0; d < 8; d++) {
+        float s = score(points[i], d);
+        if (s > best[d]) {
+          best[d] = s;
+          extreme[d] = i;
+        }
+      }
+    }
+
+    // octagon edges, skipping the ones collapsed by a point extreme in two directions
+    std::vector<std::pair<Vector2D, Vector2D>> edges;
+    for (int d = 0; d < 8; d++) {
+      const Vector2D &a = points[extreme[d]];
+      const Vector2D &b = points[extreme[(d + 1) % 8]];
+      if (!samePoint(a, b)) edges.emplace_back(a, b);
+    }
+
+    // a point strictly left of every edge is strictly inside the octagon and can't be on the hull;
+    // a degenerate octagon (fewer than 3 distinct corners) has no strict interior and culls nothing
+    int8_t inside[FILTER_BLOCK];
+    int8_t signs[FILTER_BLOCK];
+    for (uint32_t block = first; block < last; block += FILTER_BLOCK) {
+      uint32_t count = std::min(FILTER_BLOCK, last - block);
+      std::fill(inside, inside + count, edges.size() >= 3 ? 1 : 0);
+      for (const auto &[a, b] : edges) {
+        Predicates::orient2dBatch(a, b, points.data() + block, count, signs);
+        for (uint32_t i = 0; i < count; i++) inside[i] &= (signs[i] > 0);
+      }
+      for (uint32_t i = 0; i < count; i++) {
+        if (!inside[i]) survivors.push_back(block + i);
+      }
+    }
+    return survivors;
+  }
+
+  std::vector<uint32_t> ConvexHull::parallelHull(std::span<const Vector2D> points, unsigned int threadCount) {
+    uint32_t n = (uint32_t) points.size();
+
+    // below this many points per chunk the culling pass costs more than it saves
+    const uint32_t minChunk = 1 << 14;
+    unsigned int chunks = Parallel::chunkCount(n, threadCount, minChunk);
+
+    std::vector<std::vector<uint32_t>> chunkHulls(chunks);
+    Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+      std::vector<uint32_t> survivors = aklToussaintFilter(points, (uint32_t) first, (uint32_t) last);
+      chunkHulls[chunk] = chainOfIndices(points, survivors);
+    });
+
+    // the hull of the union of chunk hulls is the hull of the whole set
+    std::vector<uint32_t> candidates;
+    for (const std::vector<uint32_t> &chunkHull : chunkHulls) {
+      candidates.insert(candidates.end(), chunkHull.begin(), chunkHull.end());
+    }
+    return chainOfIndices(points, candidates);
+  }
+
+  Shapes::Polygon *ConvexHull::toPolygon(std::span<const Vector2D> points, const std::vector<uint32_t> &hull, Shapes::ShapeDrawingStyle drawingStyle) {
+    std::vector<Vector2D> vertices(hull.size());
+    for (size_t i = 0; i < hull.size(); i++) vertices[i] = points[hull[i]];
+
+    Shapes::Polygon *polygon = (Shapes::Polygon *) Shapes::ShapeFactory::constructShape(Shapes::POLYGON, drawingStyle);
+    polygon->setVertices(vertices.data(), (unsigned int) vertices.size());
+    return polygon;
+  }
+}
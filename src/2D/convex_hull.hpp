@@ -0,0 +1,52 @@
+#ifndef CONVEX_HULL_HPP
+#define CONVEX_HULL_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "shapes.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Convex hulls of Vector2D sets. Every variant returns indices into the input, in counterclockwise order
+   * starting at the lexicographically smallest point, without collinear or duplicate points. All orientation
+   * tests go through the exact predicates, so the result is correct for degenerate input too.
+   */
+  class ConvexHull {
+    public:
+      /**
+       * @brief Andrew's monotone chain, O(n log n) on a single thread
+       */
+      static std::vector<uint32_t> monotoneChain(std::span<const Vector2D> points);
+
+      /**
+       * @brief Multi-threaded merge hull for very large inputs. Each task culls interior points of its chunk
+       * with the Akl-Toussaint octagon and hulls the survivors, the chunk hulls are then merged with one more pass
+       *
+       * @param points Input points
+       * @param threadCount Chunks to split the points into, 0 uses the global pool's concurrency
+       */
+      static std::vector<uint32_t> parallelHull(std::span<const Vector2D> points, unsigned int threadCount = 0);
+
+      /**
+       * @brief Akl-Toussaint heuristic: indices of points in [first, last) that are not strictly inside the octagon
+       * spanned by the range's extreme points in 8 directions. Tested with the batch orient2d filter, 4 points per
+       * AVX2 instruction where available
+       */
+      static std::vector<uint32_t> aklToussaintFilter(std::span<const Vector2D> points, uint32_t first, uint32_t last);
+
+      /**
+       * @brief Hull as a drawable polygon
+       *
+       * @param points Input points the hull indices refer to
+       * @param hull Indices returned by one of the hull functions
+       * @param drawingStyle Drawing style of the polygon
+       * @return Shapes::Polygon* Heap allocated polygon owned by the caller
+       */
+      static Shapes::Polygon *toPolygon(std::span<const Vector2D> points, const std::vector<uint32_t> &hull, Shapes::ShapeDrawingStyle drawingStyle);
+    private:
+      static std::vector<uint32_t> chainOfIndices(std::span<const Vector2D> points, std::vector<uint32_t> &indices);
+  };
+}
+
+#endif
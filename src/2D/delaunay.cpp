@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "delaunay.hpp"
+#include "../math/predicates.hpp"
+#include "../math/space_filling_curve.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Geometry {
+  static const uint32_t NONE = Triangulation::NO_NEIGHBOR;
+
+  // BRIO rounds smaller than this are not split further
+  static const size_t MIN_ROUND = 64;
+
+  static inline uint64_t xorshift(uint64_t &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+
+  std::vector<uint32_t> Delaunay::brioOrder(std::span<const Vector2D> points, uint64_t seed) {
+    size_t n = points.size();
+    std::vector<uint32_t> order(n);
+    for (uint32_t i = 0; i < n; i++) order[i] = i;
+    if (n == 0) return order;
+
+    uint64_t state = seed | 1;
+    for (size_t i = n - 1; i > 0; i--) {
+      std::swap(order[i], order[xorshift(state) % (i + 1)]);
+    }
+
+    std::vector<uint32_t> keys;
+    SpaceFillingCurve::computeKeys(points, HILBERT_CURVE, keys);
+
+    // rounds [0, n/2^k), ..., [n/4, n/2), [n/2, n): each round is about as large as everything before it
+    size_t end = n;
+    while (end > 0) {
+      size_t begin = end / 2 < MIN_ROUND ? 0 : end / 2;
+      Parallel::parallelSort(order.begin() + begin, order.begin() + end, [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+      end = begin;
+    }
+    return order;
+  }
+
+  /**
+   * @brief Working state of one triangulation: points widened to doubles plus the ghost vertex, and per-triangle vertex/neighbour arrays.
+   * The outside of the hull is covered by ghost triangles, each joining a hull edge to one symbolic vertex at
+   * infinity, so the mesh is always closed and no finite super triangle can hide hull edges. Slots of
+   * triangles removed by a cavity are reused immediately
+   */
+  class DelaunayBuilder {
+    public:
+      struct Point { double x, y; };
+
+      std::vector<Point> points;
+      std::vector<uint32_t> vertices;
+      std::vector<uint32_t> neighbors;
+      std::vector<uint32_t> marks;
+      // the vertex at infinity, one past the input points
+      uint32_t ghost;
+      uint32_t epoch = 0;
+      uint32_t lastTriangle = 0;
+      uint64_t walkState;
+
+      // scratch reused by every insertion
+      struct BoundaryEdge { uint32_t a, b, outer, outerSlot; };
+      std::vector<uint32_t> cavity;
+      std::vector<uint32_t> stack;
+      std::vector<BoundaryEdge> boundary;
+      std::vector<uint32_t> triangleStartingAt;
+      std::vector<uint32_t> triangleStartingAtEpoch;
+
+      DelaunayBuilder(std::span<const Vector2D> input, uint64_t seed) : ghost((uint32_t) input.size()), walkState(seed | 1) {
+        size_t n = input.size();
+        this->points.resize(n + 1);
+        for (size_t i = 0; i < n; i++) this->points[i] = { input[i].vector[0], input[i].vector[1] };
+        // never read by a predicate, NaN keeps the duplicate check from matching it
+        this->points[n] = { NAN, NAN };
+
+        size_t expectedTriangles = 2 * n + 2;
+        this->vertices.reserve(3 * expectedTriangles);
+        this->neighbors.reserve(3 * expectedTriangles);
+        this->marks.reserve(expectedTriangles);
+        this->triangleStartingAt.assign(n + 1, NONE);
+        this->triangleStartingAtEpoch.assign(n + 1, 0);
+      }
+
+      /**
+       * @brief Start the mesh from the counterclockwise triangle (a, b, c) and the three ghost triangles
+       * outside its edges
+       */
+      void seed(uint32_t a, uint32_t b, uint32_t c) {
+        uint32_t g = this->ghost;
+        this->vertices = { a, b, c, b, a, g, c, b, g, a, c, g };
+        this->neighbors.assign(12, NONE);
+        this->marks.assign(4, 0);
+
+        // pair up every edge with its reverse
+        for (uint32_t t = 0; t < 4; t++) {
+          for (uint32_t k = 0; k < 3; k++) {
+            uint32_t from = this->vertices[3 * t + (k + 1) % 3], to = this->vertices[3 * t + (k + 2) % 3];
+            for (uint32_t u = 0; u < 4; u++) {
+              for (uint32_t j = 0; u != t && j < 3; j++) {
+                if (this->vertices[3 * u + (j + 1) % 3] == to && this->vertices[3 * u + (j + 2) % 3] == from) this->neighbors[3 * t + k] = u;
+              }
+            }
+          }
+        }
+        this->lastTriangle = 0;
+      }
+
+      /**
+       * @brief Slot of the vertex at infinity in t, 3 for a finite triangle
+       */
+      uint32_t ghostSlot(uint32_t t) const {
+        const uint32_t *v = &this->vertices[3 * t];
+        return v[0] == this->ghost ? 0 : v[1] == this->ghost ? 1 : v[2] == this->ghost ? 2 : 3;
+      }
+
+      double orient(uint32_t a, uint32_t b, const Point &p) {
+        const Point &pa = this->points[a];
+        const Point &pb = this->points[b];
+        return Predicates::orient2d(pa.x, pa.y, pb.x, pb.y, p.x, p.y);
+      }
+
+      /**
+       * @brief Whether p conflicts with t: strictly inside the circumcircle of a finite triangle, or, for a ghost
+       * triangle, strictly outside its hull edge or on the open edge itself (the limit of the circumcircle as
+       * the third vertex moves to infinity)
+       */
+      bool inCircumcircle(uint32_t t, const Point &p) {
+        const uint32_t *v = &this->vertices[3 * t];
+        uint32_t g = this->ghostSlot(t);
+        if (g == 3) {
+          return Predicates::incircle(&this->points[v[0]].x, &this->points[v[1]].x, &this->points[v[2]].x, &p.x) > 0.0;
+        }
+
+        const Point &a = this->points[v[(g + 1) % 3]];
+        const Point &b = this->points[v[(g + 2) % 3]];
+        double side = Predicates::orient2d(a.x, a.y, b.x, b.y, p.x, p.y);
+        if (side != 0.0) return side > 0.0;
+        // collinear, compare along an axis the edge is not perpendicular to
+        if (a.x != b.x) return (p.x > a.x && p.x < b.x) || (p.x < a.x && p.x > b.x);
+        return (p.y > a.y && p.y < b.y) || (p.y < a.y && p.y > b.y);
+      }
+
+      /**
+       * @brief Remembering stochastic walk: cross any edge that has p strictly on its outer side, starting the
+       * edge checks at a random corner and never crossing straight back. Crossing a hull edge lands in a ghost
+       * triangle that p conflicts with, which ends the walk
+       *
+       * @return uint32_t A triangle conflicting with p: a finite one containing p (inside or on its boundary)
+       * or a ghost one
+       */
+      uint32_t locate(const Point &p) {
+        uint32_t t = this->lastTriangle;
+        uint32_t g = this->ghostSlot(t);
+        if (g != 3) {
+          if (this->inCircumcircle(t, p)) return t;
+          t = this->neighbors[3 * t + g];
+        }
+
+        uint32_t previous = NONE;
+        for (;;) {
+          if (this->ghostSlot(t) != 3) return t;
+          uint32_t start = (uint32_t) (xorshift(this->walkState) % 3);
+          uint32_t next = NONE;
+          for (uint32_t i = 0; i < 3; i++) {
+            uint32_t k = (start + i) % 3;
+            uint32_t neighbor = this->neighbors[3 * t + k];
+            if (neighbor == previous) continue;
+            if (this->orient(this->vertices[3 * t + (k + 1) % 3], this->vertices[3 * t + (k + 2) % 3], p) < 0.0) {
+              next = neighbor;
+              break;
+            }
+          }
+          if (next == NONE) return t;
+          previous = t;
+          t = next;
+        }
+      }
+
+      void insert(uint32_t index) {
+        const Point &p = this->points[index];
+        uint32_t t0 = this->locate(p);
+        for (uint32_t k = 0; k < 3; k++) {
+          const Point &corner = this->points[this->vertices[3 * t0 + k]];
+          if (corner.x == p.x && corner.y == p.y) return;
+        }
+
+        // grow the cavity from the containing triangle through every neighbour whose circumcircle holds p;
+        // marks: epoch = in cavity, epoch + 1 = tested and kept
+        this->epoch += 2;
+        uint32_t badMark = this->epoch;
+        uint32_t keptMark = this->epoch + 1;
+        this->cavity.clear();
+        this->boundary.clear();
+        this->stack.clear();
+
+        this->marks[t0] = badMark;
+        this->stack.push_back(t0);
+        while (!this->stack.empty()) {
+          uint32_t t = this->stack.back();
+          this->stack.pop_back();
+          this->cavity.push_back(t);
+
+          for (uint32_t k = 0; k < 3; k++) {
+            uint32_t neighbor = this->neighbors[3 * t + k];
+            if (this->marks[neighbor] == badMark) continue;
+            if (this->marks[neighbor] != keptMark && this->inCircumcircle(neighbor, p)) {
+              this->marks[neighbor] = badMark;
+              this->stack.push_back(neighbor);
+              continue;
+            }
+            this->marks[neighbor] = keptMark;
+
+            uint32_t outerSlot = 0;
+            while (this->neighbors[3 * neighbor + outerSlot] != t) outerSlot++;
+            this->boundary.push_back({
+              this->vertices[3 * t + (k + 1) % 3],
+              this->vertices[3 * t + (k + 2) % 3],
+              neighbor,
+              outerSlot
+            });
+          }
+        }
+
+        // fan the cavity boundary around p: reuse the cavity's slots, the boundary always has 2 more edges
+        size_t newCount = this->boundary.size();
+        for (size_t i = 0; i < newCount; i++) {
+          uint32_t t;
+          if (i < this->cavity.size()) {
+            t = this->cavity[i];
+          } else {
+            t = (uint32_t) this->marks.size();
+            this->vertices.insert(this->vertices.end(), 3, NONE);
+            this->neighbors.insert(this->neighbors.end(), 3, NONE);
+            this->marks.push_back(0);
+          }
+
+          const BoundaryEdge &edge = this->boundary[i];
+          this->vertices[3 * t] = edge.a;
+          this->vertices[3 * t + 1] = edge.b;
+          this->vertices[3 * t + 2] = index;
+          this->neighbors[3 * t + 2] = edge.outer;
+          this->marks[t] = 0;
+          this->neighbors[3 * edge.outer + edge.outerSlot] = t;
+
+          this->triangleStartingAt[edge.a] = t;
+          this->triangleStartingAtEpoch[edge.a] = badMark;
+        }
+
+        // new triangle (a, b, p) borders (b, c, p) across edge (b, p) and (z, a, p) across edge (p, a)
+        for (size_t i = 0; i < newCount; i++) {
+          uint32_t t = i < this->cavity.size() ? this->cavity[i] : (uint32_t) (this->marks.size() - (newCount - i));
+          uint32_t b = this->vertices[3 * t + 1];
+          uint32_t next = this->triangleStartingAt[b];
+          this->neighbors[3 * t] = next;
+          this->neighbors[3 * next + 1] = t;
+        }
+
+        this->lastTriangle = this->cavity[0];
+      }
+
+      /**
+       * @brief Drop the ghost triangles and compact the rest, hull edges get NO_NEIGHBOR
+       */
+      Triangulation extract(uint32_t inputCount) {
+        uint32_t triangleCount = (uint32_t) this->marks.size();
+        std::vector<uint32_t> newIndex(triangleCount, NONE);
+        uint32_t kept = 0;
+        for (uint32_t t = 0; t < triangleCount; t++) {
+          const uint32_t *v = &this->vertices[3 * t];
+          if (v[0] < inputCount && v[1] < inputCount && v[2] < inputCount) newIndex[t] = kept++;
+        }
+
+        Triangulation result;
+        result.triangles.resize(3 * (size_t) kept);
+        result.adjacency.resize(3 * (size_t) kept);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+          if (newIndex[t] == NONE) continue;
+          for (uint32_t k = 0; k < 3; k++) {
+            uint32_t neighbor = this->neighbors[3 * t + k];
+            result.triangles[3 * newIndex[t] + k] = this->vertices[3 * t + k];
+            result.adjacency[3 * newIndex[t] + k] = neighbor == NONE ? NONE : newIndex[neighbor];
+          }
+        }
+        return result;
+      }
+  };
+
+  Triangulation Delaunay::triangulate(std::span<const Vector2D> points, uint64_t seed) {
+    if (points.size() < 3) return Triangulation();
+
+    std::vector<uint32_t> order = brioOrder(points, seed);
+    DelaunayBuilder builder(points, seed);
+
+    // first triangle: the first point, the next one apart from it and the next one off their line
+    size_t second = 1, third;
+    const Vector2D &first = points[order[0]];
+    while (second < order.size() && points[order[second]].vector[0] == first.vector[0] && points[order[second]].vector[1] == first.vector[1]) second++;
+    for (third = second + 1; third < order.size(); third++) {
+      if (builder.orient(order[0], order[second], builder.points[order[third]]) != 0.0) break;
+    }
+    if (third >= order.size()) return Triangulation();
+
+    uint32_t a = order[0], b = order[second], c = order[third];
+    if (builder.orient(a, b, builder.points[c]) < 0.0) std::swap(a, b);
+    builder.seed(a, b, c);
+    for (size_t i = 1; i < order.size(); i++) {
+      if (i != second && i != third) builder.insert(order[i]);
+    }
+    return builder.extract((uint32_t) points.size());
+  }
+}
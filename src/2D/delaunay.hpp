@@ -0,0 +1,48 @@
+#ifndef DELAUNAY_HPP
+#define DELAUNAY_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../vectors.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Flat triangle mesh: three counterclockwise vertex indices per triangle, usable directly as a
+   * GL_TRIANGLES index buffer, and for each triangle edge the triangle on the other side
+   */
+  struct Triangulation {
+    static const uint32_t NO_NEIGHBOR = UINT32_MAX;
+
+    // vertex indices into the input points, 3 per triangle
+    std::vector<uint32_t> triangles;
+    // adjacency[3 * t + k] is the triangle across the edge opposite triangles[3 * t + k]
+    std::vector<uint32_t> adjacency;
+
+    size_t triangleCount() const { return this->triangles.size() / 3; }
+  };
+
+  /**
+   * @brief Incremental Bowyer-Watson Delaunay triangulation. Points are inserted in BRIO order (random rounds of
+   * doubling size, each sorted along a Hilbert curve), located with a remembering stochastic walk from the last
+   * inserted triangle, and stored in flat vertex/adjacency arrays instead of pointer-linked nodes.
+   * Exact predicates make the result robust to degenerate input, duplicate points are inserted once.
+   */
+  class Delaunay {
+    public:
+      /**
+       * @brief Triangulate a point set
+       *
+       * @param points Input points, at least 3 non-collinear ones are needed for any triangle
+       * @param seed Seed for the randomized insertion order, the same seed gives the same triangulation
+       */
+      static Triangulation triangulate(std::span<const Vector2D> points, uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+      /**
+       * @brief Insertion order used by triangulate: BRIO rounds, each in Hilbert order
+       */
+      static std::vector<uint32_t> brioOrder(std::span<const Vector2D> points, uint64_t seed);
+  };
+}
+
+#endif
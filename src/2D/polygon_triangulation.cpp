@@ -0,0 +1,645 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include "polygon_triangulation.hpp"
+#include "../math/space_filling_curve.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Ring vertex, prev/next walk the remaining polygon
+   */
+  struct TriangulationNode {
+    uint32_t i;
+    // position in the triangulator's node storage
+    uint32_t slot;
+    double x;
+    double y;
+    TriangulationNode *prev;
+    TriangulationNode *next;
+    bool steiner;
+    bool removed;
+    // in the reflex index or its late list
+    bool indexed;
+  };
+
+  typedef TriangulationNode Node;
+
+  /**
+   * @brief Twice the signed area of (p, q, r), negative when the turn is counterclockwise (earcut's convention)
+   */
+  static inline double area(const Node *p, const Node *q, const Node *r) {
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+  }
+
+  static inline bool equals(const Node *p, const Node *q) {
+    return p->x == q->x && p->y == q->y;
+  }
+
+  static inline bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+      (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+      (bx - px) * (cy - py) >= (cx - px) * (by - py);
+  }
+
+  static inline bool pointInTriangle(const Node *a, const Node *b, const Node *c, const Node *p) {
+    return pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y);
+  }
+
+  static inline int sign(double value) {
+    return (value > 0.0) - (value < 0.0);
+  }
+
+  // for collinear p, q, r: whether q lies on segment pr
+  static inline bool onSegment(const Node *p, const Node *q, const Node *r) {
+    return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+      q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+  }
+
+  static bool intersects(const Node *p1, const Node *q1, const Node *p2, const Node *q2) {
+    int o1 = sign(area(p1, q1, p2));
+    int o2 = sign(area(p1, q1, q2));
+    int o3 = sign(area(p2, q2, p1));
+    int o4 = sign(area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4) return true;
+    if (o1 == 0 && onSegment(p1, p2, q1)) return true;
+    if (o2 == 0 && onSegment(p1, q2, q1)) return true;
+    if (o3 == 0 && onSegment(p2, p1, q2)) return true;
+    if (o4 == 0 && onSegment(p2, q1, q2)) return true;
+    return false;
+  }
+
+  // whether diagonal ab crosses any polygon edge not incident to a or b
+  static bool intersectsPolygon(const Node *a, const Node *b) {
+    const Node *p = a;
+    do {
+      if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i && intersects(p, p->next, a, b)) return true;
+      p = p->next;
+    } while (p != a);
+    return false;
+  }
+
+  // whether diagonal ab starts into the polygon interior at a
+  static bool locallyInside(const Node *a, const Node *b) {
+    return area(a->prev, a, a->next) < 0.0 ?
+      area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0 :
+      area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+  }
+
+  // whether the midpoint of ab is inside the polygon, by ray crossing parity
+  static bool middleInside(const Node *a, const Node *b) {
+    const Node *p = a;
+    bool inside = false;
+    double px = 0.5 * (a->x + b->x);
+    double py = 0.5 * (a->y + b->y);
+    do {
+      if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+        (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+        inside = !inside;
+      }
+      p = p->next;
+    } while (p != a);
+    return inside;
+  }
+
+  static bool isValidDiagonal(const Node *a, const Node *b) {
+    return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b) &&
+      ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+        (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0)) ||
+       (equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0));
+  }
+
+  // whether the sector at m contains the sector at p, both being the same point
+  static bool sectorContainsSector(const Node *m, const Node *p) {
+    return area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0;
+  }
+
+  static Node *getLeftmost(Node *start) {
+    Node *p = start;
+    Node *leftmost = start;
+    do {
+      if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) leftmost = p;
+      p = p->next;
+    } while (p != start);
+    return leftmost;
+  }
+
+  /**
+   * @brief Smallest Morton key above zValue that lies inside the box spanned by zMin and zMax (Tropf and Herzog's
+   * BIGMIN), used to jump over the parts of the key range that leave the query box
+   */
+  static uint32_t nextZInBox(uint32_t zValue, uint32_t zMin, uint32_t zMax) {
+    uint32_t bigMin = 0;
+    // above the highest bit where the box corners differ every key in range shares their prefix
+    for (int bit = 31 - std::countl_zero(zMin ^ zMax); bit >= 0; bit--) {
+      uint32_t mask = 1u << bit;
+      // lower bits of the same axis: x on even bits, y on odd bits
+      uint32_t lower = ((bit & 1) ? 0xAAAAAAAAu : 0x55555555u) & (mask - 1);
+      bool z = (zValue & mask) != 0;
+      bool low = (zMin & mask) != 0;
+      bool high = (zMax & mask) != 0;
+
+      if (!z && !low && high) {
+        bigMin = (zMin | mask) & ~lower;
+        zMax = (zMax & ~mask) | lower;
+      } else if (!z && low && high) {
+        return zMin;
+      } else if (z && !low && !high) {
+        return bigMin;
+      } else if (z && !low && high) {
+        zMin = (zMin | mask) & ~lower;
+      }
+    }
+    return bigMin;
+  }
+
+  PolygonTriangulator::~PolygonTriangulator() {
+    for (Node *chunk : this->chunks) delete[] chunk;
+  }
+
+  std::vector<uint32_t> PolygonTriangulator::triangulatePolygon(std::span<const Vector2D> vertices, std::span<const uint32_t> holeStarts) {
+    PolygonTriangulator triangulator;
+    std::vector<uint32_t> triangles;
+    triangulator.triangulate(vertices, holeStarts, triangles);
+    return triangles;
+  }
+
+  void PolygonTriangulator::triangulate(std::span<const Vector2D> vertices, std::span<const uint32_t> holeStarts, std::vector<uint32_t> &triangles) {
+    triangles.clear();
+    this->nodeCount = 0;
+    this->output = &triangles;
+
+    size_t outerEnd = holeStarts.empty() ? vertices.size() : holeStarts[0];
+    Node *outerNode = this->linkedList(vertices, 0, outerEnd, true);
+    if (outerNode == NULL || outerNode->next == outerNode->prev) return;
+
+    triangles.reserve(3 * (vertices.size() + 2 * holeStarts.size()));
+    if (!holeStarts.empty()) outerNode = this->eliminateHoles(vertices, holeStarts, outerNode);
+
+    this->invSize = 0.0;
+    if (vertices.size() > HASH_THRESHOLD) {
+      double maxX = vertices[0].vector[0];
+      double maxY = vertices[0].vector[1];
+      this->minX = maxX;
+      this->minY = maxY;
+      for (size_t i = 1; i < outerEnd; i++) {
+        this->minX = std::min(this->minX, (double) vertices[i].vector[0]);
+        this->minY = std::min(this->minY, (double) vertices[i].vector[1]);
+        maxX = std::max(maxX, (double) vertices[i].vector[0]);
+        maxY = std::max(maxY, (double) vertices[i].vector[1]);
+      }
+      // 16 bits per axis fill the interleaved 32 bit key
+      double size = std::max(maxX - this->minX, maxY - this->minY);
+      this->invSize = size != 0.0 ? 65535.0 / size : 0.0;
+    }
+
+    this->earcutLinked(outerNode, 0);
+  }
+
+  PolygonTriangulator::Node *PolygonTriangulator::createNode(uint32_t index, double x, double y) {
+    size_t chunk = this->nodeCount / CHUNK_SIZE;
+    if (chunk == this->chunks.size()) this->chunks.push_back(new Node[CHUNK_SIZE]);
+    Node *node = &this->chunks[chunk][this->nodeCount % CHUNK_SIZE];
+    *node = Node { index, (uint32_t) this->nodeCount, x, y, NULL, NULL, false, false, false };
+    this->nodeCount++;
+    return node;
+  }
+
+  PolygonTriangulator::Node *PolygonTriangulator::nodeAt(uint32_t slot) {
+    return &this->chunks[slot / CHUNK_SIZE][slot % CHUNK_SIZE];
+  }
+
+  PolygonTriangulator::Node *PolygonTriangulator::insertNode(uint32_t index, double x, double y, Node *last) {
+    Node *p = this->createNode(index, x, y);
+    if (last == NULL) {
+      p->prev = p;
+      p->next = p;
+    } else {
+      p->next = last->next;
+      p->prev = last;
+      last->next->prev = p;
+      last->next = p;
+    }
+    return p;
+  }
+
+  void PolygonTriangulator::removeNode(Node *p) {
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+    p->removed = true;
+  }
+
+  /**
+   * @brief Ring of vertices [start, end) in the requested orientation, whatever the input's
+   */
+  PolygonTriangulator::Node *PolygonTriangulator::linkedList(std::span<const Vector2D> vertices, size_t start, size_t end, bool counterclockwise) {
+    if (end <= start) return NULL;
+
+    double sum = 0.0;
+    for (size_t i = start, j = end - 1; i < end; j = i++) {
+      sum += ((double) vertices[j].vector[0] - vertices[i].vector[0]) * ((double) vertices[i].vector[1] + vertices[j].vector[1]);
+    }
+
+    Node *last = NULL;
+    if (counterclockwise == (sum > 0.0)) {
+      for (size_t i = start; i < end; i++) {
+        last = this->insertNode((uint32_t) i, vertices[i].vector[0], vertices[i].vector[1], last);
+      }
+    } else {
+      for (size_t i = end; i-- > start;) {
+        last = this->insertNode((uint32_t) i, vertices[i].vector[0], vertices[i].vector[1], last);
+      }
+    }
+
+    if (last != NULL && equals(last, last->next)) {
+      this->removeNode(last);
+      last = last->next;
+    }
+    return last;
+  }
+
+  /**
+   * @brief Drop duplicate and collinear vertices between start and end
+   */
+  PolygonTriangulator::Node *PolygonTriangulator::filterPoints(Node *start, Node *end) {
+    if (start == NULL) return start;
+    if (end == NULL) end = start;
+
+    Node *p = start;
+    bool again;
+    do {
+      again = false;
+      if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0)) {
+        this->removeNode(p);
+        p = end = p->prev;
+        if (p == p->next) break;
+        again = true;
+      } else {
+        p = p->next;
+      }
+    } while (again || p != end);
+    return end;
+  }
+
+  /**
+   * @brief Main loop: clip ears until none is found, then filter, cure local intersections and finally split
+   * the remaining ring, each as a further pass
+   */
+  void PolygonTriangulator::earcutLinked(Node *ear, int pass) {
+    if (ear == NULL) return;
+    // filtering and curing splice the ring and can turn the surviving neighbours reflex, so every pass starts
+    // from a fresh index
+    if (this->invSize != 0.0) this->indexReflex(ear);
+
+    Node *stop = ear;
+    while (ear->prev != ear->next) {
+      Node *prev = ear->prev;
+      Node *next = ear->next;
+
+      if (this->invSize != 0.0 ? this->isEarHashed(ear) : this->isEar(ear)) {
+        this->output->push_back(prev->i);
+        this->output->push_back(ear->i);
+        this->output->push_back(next->i);
+        this->removeNode(ear);
+        if (this->invSize != 0.0) {
+          // only on self intersecting rings can a clip turn a neighbour reflex
+          this->noteReflex(prev);
+          this->noteReflex(next);
+          if (++this->clippedSinceCompaction > this->reflexIndex.size() / 2) this->compactReflex();
+        }
+
+        // skipping the next vertex leads to less sliver triangles
+        ear = next->next;
+        stop = next->next;
+        continue;
+      }
+
+      ear = next;
+      if (ear == stop) {
+        if (pass == 0) {
+          this->earcutLinked(this->filterPoints(ear), 1);
+        } else if (pass == 1) {
+          ear = this->cureLocalIntersections(this->filterPoints(ear));
+          this->earcutLinked(ear, 2);
+        } else if (pass == 2) {
+          this->splitEarcut(ear);
+        }
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief Plain ear test: convex, and no reflex vertex of the ring inside the triangle
+   */
+  bool PolygonTriangulator::isEar(Node *ear) {
+    Node *a = ear->prev;
+    Node *b = ear;
+    Node *c = ear->next;
+    if (area(a, b, c) >= 0.0) return false;
+
+    for (Node *p = c->next; p != a; p = p->next) {
+      if (pointInTriangle(a, b, c, p) && area(p->prev, p, p->next) >= 0.0) return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Ear test against the reflex index only: the sorted key range of the triangle's bounding box is
+   * scanned, jumping straight past runs of keys that fall outside the box
+   */
+  bool PolygonTriangulator::isEarHashed(Node *ear) {
+    Node *a = ear->prev;
+    Node *b = ear;
+    Node *c = ear->next;
+    if (area(a, b, c) >= 0.0) return false;
+
+    double minTX = std::min({ a->x, b->x, c->x });
+    double minTY = std::min({ a->y, b->y, c->y });
+    double maxTX = std::max({ a->x, b->x, c->x });
+    double maxTY = std::max({ a->y, b->y, c->y });
+    uint32_t qMinX = this->quantize(minTX, this->minX);
+    uint32_t qMinY = this->quantize(minTY, this->minY);
+    uint32_t qMaxX = this->quantize(maxTX, this->minX);
+    uint32_t qMaxY = this->quantize(maxTY, this->minY);
+    uint32_t minZ = SpaceFillingCurve::mortonKey32(qMinX, qMinY);
+    uint32_t maxZ = SpaceFillingCurve::mortonKey32(qMaxX, qMaxY);
+
+    for (const Node *p : this->lateReflex) {
+      if (!p->removed && p != a && p != c && pointInTriangle(a, b, c, p) && area(p->prev, p, p->next) >= 0.0) return false;
+    }
+
+    // consecutive ears are neighbours on the ring, so the search starts where the previous one ended
+    size_t i = this->seekReflex(this->lastReflexPosition, minZ);
+    int misses = 0;
+    this->lastReflexPosition = i;
+    while (i < this->reflexIndex.size() && this->reflexIndex[i].z <= maxZ) {
+      const ReflexEntry &entry = this->reflexIndex[i];
+      uint32_t qx = this->quantize(entry.x, this->minX);
+      uint32_t qy = this->quantize(entry.y, this->minY);
+      if (qx < qMinX || qx > qMaxX || qy < qMinY || qy > qMaxY) {
+        // short excursions out of the box are cheaper to step over than to jump
+        if (++misses < 8) {
+          i++;
+          continue;
+        }
+        misses = 0;
+        uint32_t next = nextZInBox(entry.z, minZ, maxZ);
+        if (next <= entry.z) break;
+        i = this->seekReflex(i + 1, next);
+        continue;
+      }
+      // coordinates are cached in the entry so only candidates inside the triangle touch the node; removed and
+      // no longer reflex vertices stay in the index until the next compaction
+      if (entry.x >= minTX && entry.x <= maxTX && entry.y >= minTY && entry.y <= maxTY &&
+        pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, entry.x, entry.y)) {
+        const Node *p = this->nodeAt(entry.node);
+        if (!p->removed && p != a && p != c && area(p->prev, p, p->next) >= 0.0) return false;
+      }
+      i++;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Clip the small self intersections a-p-p.next-b where edges (a, p) and (p.next, b) cross
+   */
+  PolygonTriangulator::Node *PolygonTriangulator::cureLocalIntersections(Node *start) {
+    Node *p = start;
+    do {
+      Node *a = p->prev;
+      Node *b = p->next->next;
+      if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+        this->output->push_back(a->i);
+        this->output->push_back(p->i);
+        this->output->push_back(b->i);
+        this->removeNode(p);
+        this->removeNode(p->next);
+        p = start = b;
+      }
+      p = p->next;
+    } while (p != start);
+    return this->filterPoints(p);
+  }
+
+  /**
+   * @brief Last resort: split the ring along any valid diagonal and triangulate both halves
+   */
+  void PolygonTriangulator::splitEarcut(Node *start) {
+    Node *a = start;
+    do {
+      Node *b = a->next->next;
+      while (b != a->prev) {
+        if (a->i != b->i && isValidDiagonal(a, b)) {
+          Node *c = this->splitPolygon(a, b);
+          a = this->filterPoints(a, a->next);
+          c = this->filterPoints(c, c->next);
+          this->earcutLinked(a, 0);
+          this->earcutLinked(c, 0);
+          return;
+        }
+        b = b->next;
+      }
+      a = a->next;
+    } while (a != start);
+  }
+
+  /**
+   * @brief Bridge every hole into the outer ring, left to right
+   */
+  PolygonTriangulator::Node *PolygonTriangulator::eliminateHoles(std::span<const Vector2D> vertices, std::span<const uint32_t> holeStarts, Node *outerNode) {
+    this->holeQueue.clear();
+    for (size_t h = 0; h < holeStarts.size(); h++) {
+      size_t start = holeStarts[h];
+      size_t end = h + 1 < holeStarts.size() ? holeStarts[h + 1] : vertices.size();
+      Node *list = this->linkedList(vertices, start, end, false);
+      if (list == NULL) continue;
+      if (list == list->next) list->steiner = true;
+      this->holeQueue.push_back(getLeftmost(list));
+    }
+    std::sort(this->holeQueue.begin(), this->holeQueue.end(), [](const Node *a, const Node *b) {
+      return a->x < b->x || (a->x == b->x && a->y < b->y);
+    });
+
+    for (Node *hole : this->holeQueue) {
+      outerNode = this->eliminateHole(hole, outerNode);
+    }
+    return outerNode;
+  }
+
+  PolygonTriangulator::Node *PolygonTriangulator::eliminateHole(Node *hole, Node *outerNode) {
+    Node *bridge = this->findHoleBridge(hole, outerNode);
+    if (bridge == NULL) return outerNode;
+
+    Node *bridgeReverse = this->splitPolygon(bridge, hole);
+    this->filterPoints(bridgeReverse, bridgeReverse->next);
+    return this->filterPoints(bridge, bridge->next);
+  }
+
+  /**
+   * @brief David Eberly's hole bridging: cast a ray left from the hole's leftmost vertex, then pick the visible
+   * outer vertex with the smallest angle to the ray
+   */
+  PolygonTriangulator::Node *PolygonTriangulator::findHoleBridge(Node *hole, Node *outerNode) {
+    Node *p = outerNode;
+    double hx = hole->x;
+    double hy = hole->y;
+    double qx = -std::numeric_limits<double>::infinity();
+    Node *m = NULL;
+
+    do {
+      if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+        double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+        if (x <= hx && x > qx) {
+          qx = x;
+          m = p->x < p->next->x ? p : p->next;
+          if (x == hx) return m;
+        }
+      }
+      p = p->next;
+    } while (p != outerNode);
+
+    if (m == NULL) return NULL;
+
+    Node *stop = m;
+    double mx = m->x;
+    double my = m->y;
+    double tanMin = std::numeric_limits<double>::infinity();
+    p = m;
+    do {
+      if (hx >= p->x && p->x >= mx && hx != p->x &&
+        pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+        double tan = std::fabs(hy - p->y) / (hx - p->x);
+        if (locallyInside(p, hole) &&
+          (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p)))))) {
+          m = p;
+          tanMin = tan;
+        }
+      }
+      p = p->next;
+    } while (p != stop);
+    return m;
+  }
+
+  /**
+   * @brief Link a and b with a diagonal, splitting the ring in two. Returns the copy of b on the second ring
+   */
+  PolygonTriangulator::Node *PolygonTriangulator::splitPolygon(Node *a, Node *b) {
+    Node *a2 = this->createNode(a->i, a->x, a->y);
+    Node *b2 = this->createNode(b->i, b->x, b->y);
+    Node *an = a->next;
+    Node *bp = b->prev;
+
+    a->next = b;
+    b->prev = a;
+    a2->next = an;
+    an->prev = a2;
+    b2->next = a2;
+    a2->prev = b2;
+    bp->next = b2;
+    b2->prev = bp;
+    return b2;
+  }
+
+  /**
+   * @brief Index the ring's reflex vertices by Morton key. Only reflex vertices can make a convex vertex fail the
+   * ear test, and on a simple ring clipping ears never turns a convex vertex reflex, so the index only loses
+   * members; self intersecting rings add theirs through noteReflex
+   */
+  void PolygonTriangulator::indexReflex(Node *start) {
+    this->unsortedReflex.clear();
+    this->reflexKeys.clear();
+    this->lateReflex.clear();
+    Node *p = start;
+    do {
+      p->indexed = area(p->prev, p, p->next) >= 0.0;
+      if (p->indexed) {
+        uint32_t z = this->zOrder(p->x, p->y);
+        this->unsortedReflex.push_back({ z, (float) p->x, (float) p->y, p->slot });
+        this->reflexKeys.push_back(z);
+      }
+      p = p->next;
+    } while (p != start);
+
+    // on the calling thread: a triangulator may itself run inside a pool task. Gathering lets the loads overlap,
+    // following the permutation's cycles would chain one cache miss after the other
+    SpaceFillingCurve::radixSort(this->reflexKeys, this->reflexOrder, 1);
+    this->reflexIndex.resize(this->unsortedReflex.size());
+    for (size_t i = 0; i < this->reflexOrder.size(); i++) this->reflexIndex[i] = this->unsortedReflex[this->reflexOrder[i]];
+    this->clippedSinceCompaction = 0;
+    this->lastReflexPosition = 0;
+  }
+
+  /**
+   * @brief First index entry with key >= z, galloping outwards from a nearby position
+   */
+  size_t PolygonTriangulator::seekReflex(size_t from, uint32_t z) {
+    const std::vector<ReflexEntry> &index = this->reflexIndex;
+    size_t size = index.size();
+    from = std::min(from, size);
+    size_t low, high;
+    if (from < size && index[from].z < z) {
+      size_t step = 1;
+      low = from + 1;
+      high = from + 1;
+      while (high < size && index[high].z < z) {
+        low = high + 1;
+        step *= 2;
+        high = from + step;
+      }
+      high = std::min(high, size);
+    } else {
+      size_t step = 1;
+      high = from;
+      low = from;
+      while (low > 0 && index[low - 1].z >= z) {
+        high = low - 1;
+        low = from >= step ? from - step : 0;
+        step *= 2;
+      }
+    }
+    return std::lower_bound(index.begin() + low, index.begin() + high, z, [](const ReflexEntry &entry, uint32_t key) {
+      return entry.z < key;
+    }) - index.begin();
+  }
+
+  /**
+   * @brief Drop index entries whose vertex was clipped or turned convex, amortized over the ears clipped since
+   */
+  void PolygonTriangulator::compactReflex() {
+    auto dead = [&](const ReflexEntry &entry) {
+      Node *p = this->nodeAt(entry.node);
+      if (p->removed || area(p->prev, p, p->next) < 0.0) {
+        p->indexed = false;
+        return true;
+      }
+      return false;
+    };
+    this->reflexIndex.erase(std::remove_if(this->reflexIndex.begin(), this->reflexIndex.end(), dead), this->reflexIndex.end());
+    this->clippedSinceCompaction = 0;
+    this->lastReflexPosition = 0;
+  }
+
+  /**
+   * @brief Keep a vertex that turned reflex after it was indexed in a short unsorted list the ear test scans
+   * as well, and rebuild the index once that list outgrows the square root of the index
+   */
+  void PolygonTriangulator::noteReflex(Node *p) {
+    if (p->indexed || p->prev == p->next || area(p->prev, p, p->next) < 0.0) return;
+    p->indexed = true;
+    this->lateReflex.push_back(p);
+    if (this->lateReflex.size() * this->lateReflex.size() > this->reflexIndex.size() + 64) this->indexReflex(p);
+  }
+
+  uint32_t PolygonTriangulator::quantize(double value, double min) {
+    return (uint32_t) ((value - min) * this->invSize);
+  }
+
+  /**
+   * @brief Morton code of a point quantized to 16 bits per axis within the outer ring's bounding box
+   */
+  uint32_t PolygonTriangulator::zOrder(double x, double y) {
+    return SpaceFillingCurve::mortonKey32(this->quantize(x, this->minX), this->quantize(y, this->minY));
+  }
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include "polyline_simplification.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Geometry {
+  // spans longer than this are split as pool tasks, shorter ones run on the caller's stack
+  static const uint32_t PARALLEL_SPAN = 1 << 15;
+
+  /**
+   * @brief Squared distance from p to the segment ab, in double so tolerances well below float spacing work
+   */
+  static inline double segmentDistanceSquared(const Vector2D &p, const Vector2D &a, const Vector2D &b) {
+    double abx = (double) b.vector[0] - a.vector[0], aby = (double) b.vector[1] - a.vector[1];
+    double apx = (double) p.vector[0] - a.vector[0], apy = (double) p.vector[1] - a.vector[1];
+    double lengthSquared = abx * abx + aby * aby;
+    double t = lengthSquared > 0.0 ? std::clamp((apx * abx + apy * aby) / lengthSquared, 0.0, 1.0) : 0.0;
+    double dx = apx - t * abx, dy = apy - t * aby;
+    return dx * dx + dy * dy;
+  }
+
+  /**
+   * @brief Mark the vertices of (first, last) to keep. An explicit stack of spans replaces recursion so long
+   * inputs cannot overflow the call stack; a span that is still large after splitting forks into a task
+   */
+  static void simplifySpan(std::span<const Vector2D> points, uint32_t first, uint32_t last, double toleranceSquared, std::vector<uint8_t> &keep) {
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.push_back({ first, last });
+    Parallel::TaskGroup group;
+
+    while (!stack.empty()) {
+      auto [low, high] = stack.back();
+      stack.pop_back();
+      if (high - low < 2) continue;
+
+      double farthest = -1.0;
+      uint32_t split = low;
+      for (uint32_t i = low + 1; i < high; i++) {
+        double distance = segmentDistanceSquared(points[i], points[low], points[high]);
+        if (distance > farthest) {
+          farthest = distance;
+          split = i;
+        }
+      }
+      if (farthest <= toleranceSquared) continue;
+
+      // different spans never share an interior vertex, so tasks write disjoint parts of keep
+      keep[split] = 1;
+      if (split - low > PARALLEL_SPAN) {
+        group.run([&points, low, split, toleranceSquared, &keep]() { simplifySpan(points, low, split, toleranceSquared, keep); });
+      } else {
+        stack.push_back({ low, split });
+      }
+      stack.push_back({ split, high });
+    }
+    group.wait();
+  }
+
+  std::vector<uint32_t> PolylineSimplification::douglasPeucker(std::span<const Vector2D> points, double tolerance, bool closed) {
+    uint32_t n = (uint32_t) points.size();
+    std::vector<uint32_t> kept;
+    if (n <= 2) {
+      for (uint32_t i = 0; i < n; i++) kept.push_back(i);
+      return kept;
+    }
+
+    std::vector<uint8_t> keep(n, 0);
+    double toleranceSquared = tolerance * tolerance;
+    keep[0] = 1;
+    if (closed) {
+      // the ring closes back at vertex 0, so the vertex farthest from it anchors the second half
+      uint32_t opposite = 1;
+      double farthest = -1.0;
+      for (uint32_t i = 1; i < n; i++) {
+        double distance = segmentDistanceSquared(points[i], points[0], points[0]);
+        if (distance > farthest) {
+          farthest = distance;
+          opposite = i;
+        }
+      }
+      keep[opposite] = 1;
+      simplifySpan(points, 0, opposite, toleranceSquared, keep);
+
+      // second half runs from opposite back round to vertex 0, simplified over a copy that repeats vertex 0
+      std::vector<Vector2D> tail(points.begin() + opposite, points.end());
+      tail.push_back(points[0]);
+      std::vector<uint8_t> tailKeep(tail.size(), 0);
+      simplifySpan(tail, 0, (uint32_t) tail.size() - 1, toleranceSquared, tailKeep);
+      for (uint32_t i = 1; i + 1 < tail.size(); i++) keep[opposite + i] = tailKeep[i];
+    } else {
+      keep[n - 1] = 1;
+      simplifySpan(points, 0, n - 1, toleranceSquared, keep);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+      if (keep[i]) kept.push_back(i);
+    }
+    return kept;
+  }
+}
@@ -0,0 +1,29 @@
+#ifndef POLYLINE_SIMPLIFICATION_HPP
+#define POLYLINE_SIMPLIFICATION_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../vectors.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Ramer-Douglas-Peucker simplification of polylines and closed rings. Returns ascending indices of the
+   * kept vertices; every dropped vertex lies within tolerance of the segment that replaces it
+   */
+  class PolylineSimplification {
+    public:
+      /**
+       * @brief Keep the vertex farthest from the chord of a span when it is further than tolerance and split
+       * there, until every span is flat. Large spans are split as tasks on the global thread pool
+       *
+       * @param points Polyline vertices in order
+       * @param tolerance Largest distance a dropped vertex may be from the simplified line
+       * @param closed Treat points as a ring: the first vertex is kept and the vertex farthest from it splits
+       * the ring into two polylines
+       */
+      static std::vector<uint32_t> douglasPeucker(std::span<const Vector2D> points, double tolerance, bool closed = false);
+  };
+}
+
+#endif
@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include "segment_intersection.hpp"
+#include "../math/predicates.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Geometry {
+  static const uint32_t NONE = UINT32_MAX;
+
+  struct SweepPoint {
+    double x, y;
+
+    bool operator==(const SweepPoint &other) const { return this->x == other.x && this->y == other.y; }
+    bool operator<(const SweepPoint &other) const { return this->x < other.x || (this->x == other.x && this->y < other.y); }
+  };
+
+  /**
+   * @brief Segment with a the lexicographically smaller endpoint, id is the index reported to the caller
+   */
+  struct SweepSegment {
+    SweepPoint a;
+    SweepPoint b;
+    uint32_t id;
+  };
+
+  static inline double orient(const SweepPoint &a, const SweepPoint &b, const SweepPoint &c) {
+    return Predicates::orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+  }
+
+  /**
+   * @brief Collects intersections into a fixed batch and hands full batches to the callback, optionally
+   * under a lock shared by several reporters
+   */
+  class BatchReporter {
+    public:
+      size_t count = 0;
+
+      BatchReporter(const IntersectionCallback &report, std::mutex *lock) : report(report), lock(lock) {
+        this->batch.reserve(SegmentIntersection::BATCH_SIZE);
+      }
+
+      void add(uint32_t first, uint32_t second, const SweepPoint &point) {
+        if (first > second) std::swap(first, second);
+        this->batch.push_back({ first, second, { (float) point.x, (float) point.y } });
+        this->count++;
+        if (this->batch.size() == SegmentIntersection::BATCH_SIZE) this->flush();
+      }
+
+      void flush() {
+        if (this->batch.empty()) return;
+        if (this->lock != NULL) {
+          std::lock_guard<std::mutex> guard(*this->lock);
+          this->report(this->batch);
+        } else {
+          this->report(this->batch);
+        }
+        this->batch.clear();
+      }
+    private:
+      const IntersectionCallback &report;
+      std::mutex *lock;
+      std::vector<Intersection> batch;
+  };
+
+  /**
+   * @brief Which intersection points a sweep may report: all of them, or those inside one grid cell
+   */
+  struct CellFilter {
+    bool enabled = false;
+    double minX = 0.0, minY = 0.0;
+    double invCellSize = 0.0;
+    long cellX = 0, cellY = 0;
+    long cells = 1;
+
+    bool owns(const SweepPoint &p) const {
+      if (!this->enabled) return true;
+      long x = std::clamp((long) std::floor((p.x - this->minX) * this->invCellSize), 0L, this->cells - 1);
+      long y = std::clamp((long) std::floor((p.y - this->minY) * this->invCellSize), 0L, this->cells - 1);
+      return x == this->cellX && y == this->cellY;
+    }
+  };
+
+  /**
+   * @brief Bentley-Ottmann sweep over x. The status is a skip list without keys: its order is the order of the
+   * segments along the sweep line, searches descend with the exact side test and a crossing swaps the segments
+   * held by two adjacent nodes, so every event costs O(log n) expected. Buffers are kept between runs so one
+   * sweep per thread can process many grid cells without reallocating
+   */
+  class SweepLine {
+    public:
+      void run(const std::vector<SweepSegment> &input, const CellFilter &filter, BatchReporter &reporter) {
+        this->segments = &input;
+        this->filter = &filter;
+        this->reporter = &reporter;
+        size_t n = input.size();
+
+        this->endpoints.clear();
+        for (uint32_t i = 0; i < n; i++) {
+          this->endpoints.push_back({ input[i].a, i, true });
+          this->endpoints.push_back({ input[i].b, i, false });
+        }
+        std::sort(this->endpoints.begin(), this->endpoints.end(), [](const Endpoint &e, const Endpoint &f) {
+          return e.point < f.point;
+        });
+        this->crossings.clear();
+        this->resetStatus(n);
+
+        size_t next = 0;
+        while (next < this->endpoints.size() || !this->crossings.empty()) {
+          bool endpointFirst = next < this->endpoints.size() &&
+            (this->crossings.empty() || !(this->crossings.front().point < this->endpoints[next].point));
+          if (endpointFirst) {
+            size_t end = next;
+            while (end < this->endpoints.size() && this->endpoints[end].point == this->endpoints[next].point) end++;
+            this->handleEndpoints(next, end);
+            next = end;
+          } else {
+            std::pop_heap(this->crossings.begin(), this->crossings.end(), LaterCrossing());
+            Crossing crossing = this->crossings.back();
+            this->crossings.pop_back();
+            this->handleCrossing(crossing);
+          }
+        }
+      }
+
+    private:
+      struct Endpoint {
+        SweepPoint point;
+        uint32_t segment;
+        bool left;
+      };
+
+      struct Crossing {
+        SweepPoint point;
+        uint32_t lower;
+        uint32_t upper;
+      };
+
+      struct LaterCrossing {
+        bool operator()(const Crossing &c, const Crossing &d) const { return d.point < c.point; }
+      };
+
+      // skip list levels, each one a quarter as dense as the one below
+      static const unsigned int MAX_LEVEL = 16;
+
+      const std::vector<SweepSegment> *segments = NULL;
+      const CellFilter *filter = NULL;
+      BatchReporter *reporter = NULL;
+      std::vector<Endpoint> endpoints;
+      std::vector<Crossing> crossings;
+      std::vector<uint32_t> through;
+      std::vector<uint32_t> continuing;
+
+      // status nodes: one per segment plus the head, node n. nodeOf and nodeSegment are inverse permutations
+      // changed by crossings, links[linkOffset[node] + level] is the next node on a level or NONE
+      uint32_t head = 0;
+      std::vector<uint32_t> nodeSegment;
+      std::vector<uint32_t> nodeOf;
+      std::vector<uint32_t> previous;
+      std::vector<uint32_t> linkOffset;
+      std::vector<uint32_t> links;
+      std::vector<uint8_t> heights;
+      std::vector<uint8_t> linked;
+      uint32_t update[MAX_LEVEL];
+      uint64_t levelState = 0x9e3779b97f4a7c15ULL;
+
+      const SweepSegment &segment(uint32_t s) { return (*this->segments)[s]; }
+
+      uint32_t &next(uint32_t node, unsigned int level) { return this->links[this->linkOffset[node] + level]; }
+
+      unsigned int randomHeight() {
+        this->levelState ^= this->levelState << 13;
+        this->levelState ^= this->levelState >> 7;
+        this->levelState ^= this->levelState << 17;
+        unsigned int height = 1;
+        for (uint64_t bits = this->levelState; height < MAX_LEVEL && (bits & 3) == 0; bits >>= 2) height++;
+        return height;
+      }
+
+      void resetStatus(size_t n) {
+        this->head = (uint32_t) n;
+        this->nodeSegment.resize(n);
+        this->nodeOf.resize(n);
+        this->previous.assign(n + 1, NONE);
+        this->heights.resize(n + 1);
+        this->linkOffset.resize(n + 1);
+        this->linked.assign(n, 0);
+        uint32_t total = 0;
+        for (uint32_t node = 0; node <= n; node++) {
+          if (node < n) this->nodeSegment[node] = this->nodeOf[node] = node;
+          this->heights[node] = (uint8_t) (node == n ? MAX_LEVEL : this->randomHeight());
+          this->linkOffset[node] = total;
+          total += this->heights[node];
+        }
+        this->links.assign(total, NONE);
+      }
+
+      void report(uint32_t s, uint32_t t, const SweepPoint &point) {
+        if (this->filter->owns(point)) this->reporter->add(this->segment(s).id, this->segment(t).id, point);
+      }
+
+      /**
+       * @brief -1 if the status segment passes below p, 0 if it contains p, +1 if above
+       */
+      int side(uint32_t s, const SweepPoint &p) {
+        const SweepSegment &seg = this->segment(s);
+        if (seg.a.x == seg.b.x) {
+          if (seg.b.y < p.y) return -1;
+          if (seg.a.y > p.y) return 1;
+          return 0;
+        }
+        double o = orient(seg.a, seg.b, p);
+        return o > 0.0 ? -1 : (o < 0.0 ? 1 : 0);
+      }
+
+      /**
+       * @brief Order just right of their common point p: s below t. Vertical segments come last, collinear
+       * ones by index
+       */
+      bool belowAfter(uint32_t s, uint32_t t, const SweepPoint &p) {
+        double o = orient(p, this->segment(s).b, this->segment(t).b);
+        if (o != 0.0) return o > 0.0;
+        return s < t;
+      }
+
+      bool collinear(uint32_t s, uint32_t t) {
+        const SweepSegment &u = this->segment(s);
+        const SweepSegment &v = this->segment(t);
+        return orient(u.a, u.b, v.a) == 0.0 && orient(u.a, u.b, v.b) == 0.0;
+      }
+
+      /**
+       * @brief Schedule the crossing of the segment in lowerNode and the one above it, if they still have to
+       * cross, i.e. cross properly and upper ends below lower's line
+       */
+      void checkPair(uint32_t lowerNode, const SweepPoint &p) {
+        if (lowerNode == this->head || this->next(lowerNode, 0) == NONE) return;
+        uint32_t lower = this->nodeSegment[lowerNode];
+        uint32_t upper = this->nodeSegment[this->next(lowerNode, 0)];
+        const SweepSegment &l = this->segment(lower);
+        const SweepSegment &u = this->segment(upper);
+
+        double o1 = orient(l.a, l.b, u.a);
+        double o2 = orient(l.a, l.b, u.b);
+        if (!(o2 < 0.0 && o1 > 0.0)) return;
+        double o3 = orient(u.a, u.b, l.a);
+        double o4 = orient(u.a, u.b, l.b);
+        if (!((o3 < 0.0 && o4 > 0.0) || (o3 > 0.0 && o4 < 0.0))) return;
+
+        double dx = l.b.x - l.a.x, dy = l.b.y - l.a.y;
+        double ex = u.b.x - u.a.x, ey = u.b.y - u.a.y;
+        double t = ((u.a.x - l.a.x) * ey - (u.a.y - l.a.y) * ex) / (dx * ey - dy * ex);
+        SweepPoint q = { l.a.x + t * dx, l.a.y + t * dy };
+        // a rounded crossing can land behind the sweep, it is then due immediately
+        if (q < p) q = p;
+
+        this->crossings.push_back({ q, lower, upper });
+        std::push_heap(this->crossings.begin(), this->crossings.end(), LaterCrossing());
+      }
+
+      void handleCrossing(const Crossing &crossing) {
+        uint32_t lower = crossing.lower;
+        uint32_t upper = crossing.upper;
+        // stale unless the pair is still adjacent and uncrossed
+        if (!this->linked[lower] || !this->linked[upper] || this->next(this->nodeOf[lower], 0) != this->nodeOf[upper]) return;
+
+        this->report(lower, upper, crossing.point);
+        uint32_t below = this->nodeOf[lower];
+        uint32_t above = this->nodeOf[upper];
+        this->nodeSegment[below] = upper;
+        this->nodeSegment[above] = lower;
+        this->nodeOf[upper] = below;
+        this->nodeOf[lower] = above;
+
+        this->checkPair(this->previous[below], crossing.point);
+        this->checkPair(above, crossing.point);
+      }
+
+      /**
+       * @brief Every segment starting, ending or passing through p: report the pairs meeting at p, then
+       * replace the ones passing through by the segments continuing past p in their new order
+       */
+      void handleEndpoints(size_t first, size_t last) {
+        const SweepPoint p = this->endpoints[first].point;
+
+        // update[level] becomes the last node on each level whose segment passes below p
+        uint32_t node = this->head;
+        for (unsigned int level = MAX_LEVEL; level-- > 0;) {
+          for (uint32_t step = this->next(node, level); step != NONE && this->side(this->nodeSegment[step], p) < 0; step = this->next(node, level)) node = step;
+          this->update[level] = node;
+        }
+        uint32_t below = this->update[0];
+
+        // segments through p: those in the status range first, in their order before p, then those starting here
+        this->through.clear();
+        for (uint32_t step = this->next(below, 0); step != NONE && this->side(this->nodeSegment[step], p) == 0; step = this->next(step, 0)) {
+          this->through.push_back(this->nodeSegment[step]);
+        }
+        size_t passing = this->through.size();
+        for (size_t e = first; e < last; e++) {
+          if (this->endpoints[e].left) this->through.push_back(this->endpoints[e].segment);
+        }
+
+        for (size_t i = 0; i < this->through.size(); i++) {
+          for (size_t j = i + 1; j < this->through.size(); j++) {
+            uint32_t s = this->through[i];
+            uint32_t t = this->through[j];
+            const SweepSegment &u = this->segment(s);
+            const SweepSegment &v = this->segment(t);
+            bool interior = j < passing && !(u.b == p) && !(v.b == p);
+            if (interior) {
+              // p is inside both: they cross here unless the crossing was already swapped
+              if (!this->belowAfter(s, t, p)) this->report(s, t, p);
+            } else if (!this->collinear(s, t) || p == std::max(u.a, v.a)) {
+              // overlaps are reported once, where they begin
+              this->report(s, t, p);
+            }
+          }
+        }
+
+        this->continuing.clear();
+        for (uint32_t s : this->through) {
+          if (!(this->segment(s).b == p)) this->continuing.push_back(s);
+        }
+        std::sort(this->continuing.begin(), this->continuing.end(), [&](uint32_t s, uint32_t t) { return this->belowAfter(s, t, p); });
+
+        // the passing segments directly follow update[level] on every level: unlink them, then link the
+        // continuing ones in their new order
+        for (size_t i = 0; i < passing; i++) this->linked[this->through[i]] = 0;
+        for (unsigned int level = 0; level < MAX_LEVEL; level++) {
+          uint32_t step = this->next(this->update[level], level);
+          while (step != NONE && !this->linked[this->nodeSegment[step]]) step = this->next(step, level);
+          this->next(this->update[level], level) = step;
+        }
+        if (this->next(below, 0) != NONE) this->previous[this->next(below, 0)] = below;
+        for (uint32_t s : this->continuing) {
+          uint32_t inserted = this->nodeOf[s];
+          this->previous[inserted] = this->update[0];
+          for (unsigned int level = 0; level < this->heights[inserted]; level++) {
+            this->next(inserted, level) = this->next(this->update[level], level);
+            this->next(this->update[level], level) = inserted;
+            this->update[level] = inserted;
+          }
+          if (this->next(inserted, 0) != NONE) this->previous[this->next(inserted, 0)] = inserted;
+          this->linked[s] = 1;
+        }
+
+        this->checkPair(below, p);
+        if (!this->continuing.empty()) this->checkPair(this->nodeOf[this->continuing.back()], p);
+      }
+  };
+
+  static SweepSegment toSweepSegment(const Segment &segment, uint32_t id) {
+    SweepPoint a = { segment.a.vector[0], segment.a.vector[1] };
+    SweepPoint b = { segment.b.vector[0], segment.b.vector[1] };
+    if (b < a) std::swap(a, b);
+    return { a, b, id };
+  }
+
+  size_t SegmentIntersection::sweep(std::span<const Segment> segments, const IntersectionCallback &report) {
+    std::vector<SweepSegment> input(segments.size());
+    for (uint32_t i = 0; i < segments.size(); i++) input[i] = toSweepSegment(segments[i], i);
+
+    BatchReporter reporter(report, NULL);
+    SweepLine sweepLine;
+    sweepLine.run(input, CellFilter(), reporter);
+    reporter.flush();
+    return reporter.count;
+  }
+
+  // segments per cell the grid is sized for
+  static const size_t SEGMENTS_PER_CELL = 64;
+  static const long MAX_GRID_CELLS = 2048;
+
+  size_t SegmentIntersection::gridSweep(std::span<const Segment> segments, const IntersectionCallback &report, unsigned int threadCount) {
+    size_t n = segments.size();
+    if (n == 0) return 0;
+
+    std::vector<SweepSegment> input(n);
+    double minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    for (uint32_t i = 0; i < n; i++) {
+      input[i] = toSweepSegment(segments[i], i);
+      minX = std::min({ minX, input[i].a.x, input[i].b.x });
+      maxX = std::max({ maxX, input[i].a.x, input[i].b.x });
+      minY = std::min({ minY, input[i].a.y, input[i].b.y });
+      maxY = std::max({ maxY, input[i].a.y, input[i].b.y });
+    }
+
+    CellFilter grid;
+    grid.enabled = true;
+    grid.minX = minX;
+    grid.minY = minY;
+    grid.cells = std::clamp((long) std::sqrt((double) n / SEGMENTS_PER_CELL), 1L, MAX_GRID_CELLS);
+    double extent = std::max({ maxX - minX, maxY - minY, 1e-30 });
+    grid.invCellSize = grid.cells / extent;
+
+    // bucket by bounding box, widened slightly so a rounded crossing point never lands outside both buckets
+    double slack = extent * 1e-9;
+    auto cellRange = [&](double low, double high, double origin) {
+      long first = std::clamp((long) std::floor((low - slack - origin) * grid.invCellSize), 0L, grid.cells - 1);
+      long last = std::clamp((long) std::floor((high + slack - origin) * grid.invCellSize), 0L, grid.cells - 1);
+      return std::make_pair(first, last);
+    };
+
+    size_t cellCount = (size_t) (grid.cells * grid.cells);
+    std::vector<uint32_t> offsets(cellCount + 1, 0);
+    for (const SweepSegment &s : input) {
+      auto [x0, x1] = cellRange(s.a.x, s.b.x, minX);
+      auto [y0, y1] = cellRange(std::min(s.a.y, s.b.y), std::max(s.a.y, s.b.y), minY);
+      for (long y = y0; y <= y1; y++) {
+        for (long x = x0; x <= x1; x++) offsets[y * grid.cells + x + 1]++;
+      }
+    }
+    for (size_t c = 0; c < cellCount; c++) offsets[c + 1] += offsets[c];
+    std::vector<uint32_t> members(offsets.back());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t i = 0; i < n; i++) {
+      const SweepSegment &s = input[i];
+      auto [x0, x1] = cellRange(s.a.x, s.b.x, minX);
+      auto [y0, y1] = cellRange(std::min(s.a.y, s.b.y), std::max(s.a.y, s.b.y), minY);
+      for (long y = y0; y <= y1; y++) {
+        for (long x = x0; x <= x1; x++) members[fill[y * grid.cells + x]++] = i;
+      }
+    }
+
+    // cell costs vary a lot, a few chunks per thread lets idle workers steal the stragglers
+    unsigned int chunks = (unsigned int) std::min<size_t>(cellCount, 4 * (size_t) Parallel::chunkCount(cellCount, threadCount, 1));
+
+    std::mutex lock;
+    std::atomic<size_t> total(0);
+    Parallel::forEachChunk(cellCount, chunks, [&](size_t firstCell, size_t lastCell, unsigned int) {
+      BatchReporter reporter(report, &lock);
+      SweepLine sweepLine;
+      std::vector<SweepSegment> local;
+      CellFilter filter = grid;
+
+      for (size_t c = firstCell; c < lastCell; c++) {
+        if (offsets[c + 1] - offsets[c] < 2) continue;
+        local.clear();
+        for (uint32_t m = offsets[c]; m < offsets[c + 1]; m++) local.push_back(input[members[m]]);
+        filter.cellX = (long) (c % grid.cells);
+        filter.cellY = (long) (c / grid.cells);
+        sweepLine.run(local, filter, reporter);
+      }
+      reporter.flush();
+      total += reporter.count;
+    });
+    return total;
+  }
+}
@@ -0,0 +1,65 @@
+#ifndef SEGMENT_INTERSECTION_HPP
+#define SEGMENT_INTERSECTION_HPP
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include "../vectors.hpp"
+
+namespace Geometry {
+  struct Segment {
+    Vector2D a;
+    Vector2D b;
+  };
+
+  /**
+   * @brief Pair of intersecting segments, first < second, and a point they share. For collinear overlaps the
+   * point is the leftmost shared point
+   */
+  struct Intersection {
+    uint32_t first;
+    uint32_t second;
+    Vector2D point;
+  };
+
+  /**
+   * @brief Receives intersections in batches of up to SegmentIntersection::BATCH_SIZE, the span is only
+   * valid during the call
+   */
+  typedef std::function<void(std::span<const Intersection>)> IntersectionCallback;
+
+  /**
+   * @brief All-pairs segment intersection reporting. Every intersecting pair is reported exactly once,
+   * including touching endpoints, T-junctions and collinear overlaps; results stream to the callback in
+   * batches instead of being collected.
+   */
+  class SegmentIntersection {
+    public:
+      static const size_t BATCH_SIZE = 4096;
+
+      /**
+       * @brief Bentley-Ottmann sweep, O((n + k) log n). Endpoint events come from one sorted array and
+       * crossings from a binary heap, the status is a skip list of segment indices. Containment and
+       * crossing decisions use the exact predicates, computed crossing points only order the events
+       *
+       * @param segments Input segments
+       * @param report Callback for each batch of intersections
+       * @return size_t Number of intersecting pairs
+       */
+      static size_t sweep(std::span<const Segment> segments, const IntersectionCallback &report);
+
+      /**
+       * @brief Parallel variant for dense inputs: segments are bucketed into a uniform grid by bounding box,
+       * every cell is swept on its own by a task on the global thread pool, and a pair is only reported by the cell that
+       * contains its intersection point. The callback is serialized, never called concurrently
+       *
+       * @param segments Input segments
+       * @param report Callback for each batch of intersections
+       * @param threadCount Tasks to split the work into, 0 uses the global pool's concurrency
+       * @return size_t Number of intersecting pairs
+       */
+      static size_t gridSweep(std::span<const Segment> segments, const IntersectionCallback &report, unsigned int threadCount = 0);
+  };
+}
+
+#endif
@@ -1,5 +1,7 @@
-#include <iostream>
+#include <algorithm>
+#include <utility>
 #include "shapes.hpp"
+#include "../logging/logger.hpp"
 #include "../math/geometry.hpp"
 
 using namespace Geometry;
@@ -13,45 +15,83 @@ namespace Shapes {
    * @param vertex Starting at the bottom right, vertex to calculate coordinates for (counterclockwise)
    * @return Vector vertex coordinates
    */
-  Vector2D *Polygon::calculatePolygonVertex(unsigned int vertex) {
-    Vector2D *polygonVertex = new Vector2D();
-    polygonVertex->vector[0] = this->centerPt.vector[0]
+  Vector2D Polygon::calculatePolygonVertex(unsigned int vertex) {
+    Vector2D polygonVertex;
+    polygonVertex.vector[0] = this->centerPt.vector[0]
       + this->radius * cos(
-        Angles::degreeToRadian(vertex * this->omega)
+        Angles::degreeToRadian(this->rotation + vertex * this->omega)
       );
-    polygonVertex->vector[1] = this->centerPt.vector[1]
+    polygonVertex.vector[1] = this->centerPt.vector[1]
       + this->radius * sin(
-        Angles::degreeToRadian(vertex * this->omega)
+        Angles::degreeToRadian(this->rotation + vertex * this->omega)
       );
-    std::cout << polygonVertex->vector[0] << std::endl;
-    std::cout << polygonVertex->vector[1] << std::endl;
+    LOG_TRACE("Shapes", "polygon vertex %u: (%f, %f)", vertex, polygonVertex.vector[0], polygonVertex.vector[1]);
     return polygonVertex;
   }
 
   /**
-   * @brief Calculates vertex positions for polygon with n sides
+   * @brief Calculates vertex positions for polygon with n sides, reusing the vertex storage when it is large enough
    */
   void Polygon::calculateVertices() {
-    this->vertices = new Vector2D[this->numberOfSides];
-    for (unsigned int i = 0; i < this->numberOfSides; i++) {
-      this->vertices[i] = *calculatePolygonVertex(i);
+    if (this->verticesCapacity < this->numberOfSides) {
+      delete[] this->vertices;
+      this->vertices = new Vector2D[this->numberOfSides];
+      this->verticesCapacity = this->numberOfSides;
     }
+    this->writeVertices(this->vertices);
+  }
+
+  /**
+   * @brief Write the polygon's vertex positions into caller-provided storage, e.g. a shared batch buffer
+   *
+   * @param vertices Storage for getNumberOfSides() vertices
+   */
+  void Polygon::writeVertices(Vector2D *vertices) {
+    RegularPolygons::generateVertices(this->centerPt, this->radius, this->numberOfSides, this->rotation, vertices);
   }
 
   Polygon::Polygon(ShapeDrawingStyle drawingStyle) {
     this->drawingStyle = drawingStyle;
   }
 
+  Shape2D::Shape2D(Shape2D &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  /**
+   * @brief Take over other's state and vertex array, leaving other without vertices
+   */
+  Shape2D &Shape2D::operator=(Shape2D &&other) noexcept {
+    if (this == &other) return *this;
+    delete[] this->vertices;
+    this->omega = other.omega;
+    this->radius = other.radius;
+    this->sideLen = other.sideLen;
+    this->rotation = other.rotation;
+    this->numberOfSides = other.numberOfSides;
+    this->drawingStyle = other.drawingStyle;
+    this->centerPt = other.centerPt;
+    this->startPt = other.startPt;
+    this->vertices = other.vertices;
+    this->verticesCapacity = other.verticesCapacity;
+    other.vertices = NULL;
+    other.verticesCapacity = 0;
+    return *this;
+  }
+
   // getters
   unsigned int Shape2D::getNumberOfSides() { return this->numberOfSides; }
   float Shape2D::getRadius() { return this->radius; }
   float Shape2D::getSideLen() { return this->sideLen; }
+  float Shape2D::getRotation() { return this->rotation; }
   Vector2D Shape2D::getCenterPt() { return this->centerPt; }
   Vector2D Shape2D::getStartPt() { return this->startPt; }
   Vector2D *Shape2D::getVertices() { return this->vertices; }
+  ShapeDrawingStyle Shape2D::getDrawingStyle() { return this->drawingStyle; }
 
   // setters
   void Shape2D::setRadius(float radius) { this->radius = radius; }
+  void Shape2D::setRotation(float rotation) { this->rotation = rotation; }
   void Shape2D::setNumberOfSides(unsigned int numberOfSides) {
     if (numberOfSides > 0) {
       this->numberOfSides = numberOfSides;
@@ -60,4 +100,38 @@ namespace Shapes {
   }
   void Shape2D::setCenterPt(Vector2D &centerPt) { this->centerPt = centerPt; }
   void Shape2D::setStartPt(Vector2D &startPt) { this->startPt = startPt; }
+
+  /**
+   * @brief Copy an arbitrary outline into the shape. The center point and radius become the shape's bounding circle
+   * (vertex centroid and farthest vertex), so spatial structures keyed on them keep working
+   *
+   * @param vertices Outline vertices
+   * @param n Number of vertices
+   */
+  void Shape2D::setVertices(const Vector2D *vertices, unsigned int n) {
+    if (this->verticesCapacity < n) {
+      delete[] this->vertices;
+      this->vertices = new Vector2D[n];
+      this->verticesCapacity = n;
+    }
+    std::copy(vertices, vertices + n, this->vertices);
+    this->numberOfSides = n;
+    if (n == 0) return;
+    this->omega = 360.0f / n;
+
+    double sumX = 0.0, sumY = 0.0;
+    for (unsigned int i = 0; i < n; i++) {
+      sumX += vertices[i].vector[0];
+      sumY += vertices[i].vector[1];
+    }
+    this->centerPt = { { (float) (sumX / n), (float) (sumY / n) } };
+
+    float maxDistanceSquared = 0.0f;
+    for (unsigned int i = 0; i < n; i++) {
+      float dx = vertices[i].vector[0] - this->centerPt.vector[0];
+      float dy = vertices[i].vector[1] - this->centerPt.vector[1];
+      maxDistanceSquared = std::max(maxDistanceSquared, dx * dx + dy * dy);
+    }
+    this->radius = std::sqrt(maxDistanceSquared);
+  }
 }
@@ -2,7 +2,7 @@
 #define SHAPES_HPP
 
 #include <cmath>
-#include "../graphics/graphics.hpp"
+#include "../vectors.hpp"
 
 namespace Shapes {
   enum ShapeType {
@@ -10,36 +10,54 @@ namespace Shapes {
   };
 
   enum ShapeDrawingStyle {
-    VERTEX_SHAPE, LINE_SHAPE
+    VERTEX_SHAPE, LINE_SHAPE, FILL_SHAPE
   };
 
   class Shape2D {
     public:
+      Shape2D() {};
+      Shape2D(Shape2D &&other) noexcept;
+      Shape2D &operator=(Shape2D &&other) noexcept;
+      virtual ~Shape2D() { delete[] this->vertices; }
+
+      // the vertex array is owned, shapes move but do not copy
+      Shape2D(const Shape2D &) = delete;
+      Shape2D &operator=(const Shape2D &) = delete;
+
       // getters
       float getRadius();
       unsigned int getNumberOfSides();
       float getSideLen();
+      float getRotation();
       Vector2D getCenterPt();
       Vector2D getStartPt();
       Vector2D *getVertices();
+      ShapeDrawingStyle getDrawingStyle();
 
       // setters
       void setRadius(float radius);
       void setNumberOfSides(unsigned int numberOfSides);
+      void setRotation(float rotation);
 
       // not all shapes will have a center point
       void setCenterPt(Vector2D &centerPt);
       void setStartPt(Vector2D &startPt);
 
+      // arbitrary (non-regular) outlines, e.g. algorithm output
+      void setVertices(const Vector2D *vertices, unsigned int n);
+
     protected:
-      float omega;
-      float radius;
-      float sideLen;
-      unsigned int numberOfSides;
+      float omega = 0.0f;
+      float radius = 0.0f;
+      float sideLen = 0.0f;
+      float rotation = 0.0f; // degrees, counterclockwise
+      unsigned int numberOfSides = 0;
+      ShapeDrawingStyle drawingStyle = VERTEX_SHAPE;
 
-      Vector2D centerPt;
-      Vector2D startPt;
-      Vector2D *vertices;
+      Vector2D centerPt = { 0.0f, 0.0f };
+      Vector2D startPt = { 0.0f, 0.0f };
+      Vector2D *vertices = NULL;
+      unsigned int verticesCapacity = 0;
 
       // other functions
       virtual void calculateVertices() {};
@@ -47,11 +65,10 @@ namespace Shapes {
 
   class Polygon: public Shape2D {
     public:
-      Vector2D *calculatePolygonVertex(unsigned int vertex);
+      Vector2D calculatePolygonVertex(unsigned int vertex);
       virtual void calculateVertices();
+      void writeVertices(Vector2D *vertices);
       Polygon(ShapeDrawingStyle drawingStyle);
-    private:
-      ShapeDrawingStyle drawingStyle;
   };
 
   class ShapeFactory {
@@ -0,0 +1,631 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include "voronoi.hpp"
+#include "../math/predicates.hpp"
+#include "../memory/arena.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Geometry {
+  static const uint32_t NONE = VoronoiDiagram::NONE;
+
+  struct SweepPoint { double x, y; };
+
+  struct Arc;
+
+  /**
+   * @brief Circle event: the arc shrinks to a point at sweep position y. Cleared (arc = NULL) instead of
+   * removed from the heap when the arc's neighbours change
+   */
+  struct CircleEvent {
+    double y;
+    double x;
+    double centerX;
+    double centerY;
+    Arc *arc;
+  };
+
+  /**
+   * @brief Beach line arc and red-black tree node. The breakpoint to the right of the arc traces rightEdge,
+   * moving towards its to end when rightSign is +1 and towards its from end when -1
+   */
+  struct Arc {
+    uint32_t site;
+    uint32_t rightEdge;
+    int rightSign;
+    bool red;
+    Arc *parent;
+    Arc *left;
+    Arc *right;
+    Arc *prev;
+    Arc *next;
+    CircleEvent *event;
+  };
+
+  struct LaterEvent {
+    bool operator()(const CircleEvent *a, const CircleEvent *b) const {
+      return a->y > b->y || (a->y == b->y && a->x > b->x);
+    }
+  };
+
+  /**
+   * @brief x of the breakpoint between the arcs of p (left) and q (right) with the sweep line at y = l. Solved
+   * relative to p, picking the root where p's parabola drops below q's, in the cancellation free form
+   */
+  static double breakpoint(const SweepPoint &p, const SweepPoint &q, double l) {
+    if (p.y == q.y) return 0.5 * (p.x + q.x);
+    if (p.y == l) return p.x;
+    if (q.y == l) return q.x;
+
+    double dp = 2.0 * (p.y - l);
+    double dq = 2.0 * (q.y - l);
+    double qx = q.x - p.x;
+    double a = 1.0 / dp - 1.0 / dq;
+    double b = 2.0 * qx / dq;
+    double c = -qx * qx / dq + 0.5 * (p.y - q.y);
+    double s = std::sqrt(std::max(0.0, b * b - 4.0 * a * c));
+    double x = b >= 0.0 ? (-b - s) / (2.0 * a) : 2.0 * c / (s - b);
+    return p.x + x;
+  }
+
+  /**
+   * @brief Sweep state: the beach line tree, the event heap and the unclipped diagram under construction
+   */
+  class FortuneSweep {
+    public:
+      std::vector<SweepPoint> sites;
+      std::vector<SweepPoint> vertices;
+      std::vector<VoronoiDiagram::Edge> edges;
+
+      FortuneSweep(std::span<const Vector2D> input) : arcs(arena), events(arena) {
+        this->sites.resize(input.size());
+        for (size_t i = 0; i < input.size(); i++) {
+          this->sites[i] = { input[i].vector[0], input[i].vector[1] };
+        }
+        this->vertices.reserve(2 * input.size());
+        this->edges.reserve(3 * input.size());
+
+        this->nil = this->arena.create<Arc>();
+        *this->nil = Arc { NONE, NONE, 0, false, NULL, NULL, NULL, NULL, NULL, NULL };
+        this->root = this->nil;
+      }
+
+      void run() {
+        std::vector<uint32_t> order(this->sites.size());
+        for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+        Parallel::parallelSort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+          const SweepPoint &pa = this->sites[a];
+          const SweepPoint &pb = this->sites[b];
+          // index breaks ties so the first of several duplicates is the one that gets a cell
+          return pa.y < pb.y || (pa.y == pb.y && (pa.x < pb.x || (pa.x == pb.x && a < b)));
+        });
+
+        size_t next = 0;
+        while (next < order.size() || !this->queue.empty()) {
+          // circle events win ties so vertices at a site's height close before the site splits the beach line
+          bool siteFirst = next < order.size() && (this->queue.empty() ||
+            this->sites[order[next]].y < this->queue.top()->y ||
+            (this->sites[order[next]].y == this->queue.top()->y && this->sites[order[next]].x < this->queue.top()->x));
+
+          if (siteFirst) {
+            uint32_t site = order[next++];
+            const SweepPoint &p = this->sites[site];
+            if (next >= 2 && this->sites[order[next - 2]].x == p.x && this->sites[order[next - 2]].y == p.y) continue;
+            this->siteEvent(site);
+          } else {
+            CircleEvent *event = this->queue.top();
+            this->queue.pop();
+            if (event->arc != NULL) this->circleEvent(event);
+            this->events.release(event);
+          }
+        }
+      }
+
+    private:
+      Memory::BumpArena arena;
+      Memory::NodePool<Arc> arcs;
+      Memory::NodePool<CircleEvent> events;
+      std::priority_queue<CircleEvent *, std::vector<CircleEvent *>, LaterEvent> queue;
+      Arc *nil;
+      Arc *root;
+      double sweepY = -std::numeric_limits<double>::infinity();
+
+      Arc *createArc(uint32_t site) {
+        Arc *arc = this->arcs.create();
+        *arc = Arc { site, NONE, 0, true, this->nil, this->nil, this->nil, NULL, NULL, NULL };
+        return arc;
+      }
+
+      uint32_t createEdge(uint32_t leftSite, uint32_t rightSite) {
+        this->edges.push_back({ leftSite, rightSite, NONE, NONE });
+        return (uint32_t) (this->edges.size() - 1);
+      }
+
+      void endEdge(uint32_t edge, int sign, uint32_t vertex) {
+        if (sign > 0) {
+          this->edges[edge].to = vertex;
+        } else {
+          this->edges[edge].from = vertex;
+        }
+      }
+
+      Arc *arcAbove(double x) {
+        Arc *node = this->root;
+        for (;;) {
+          if (node->prev != NULL && x < breakpoint(this->sites[node->prev->site], this->sites[node->site], this->sweepY)) {
+            if (node->left == this->nil) return node;
+            node = node->left;
+          } else if (node->next != NULL && x > breakpoint(this->sites[node->site], this->sites[node->next->site], this->sweepY)) {
+            if (node->right == this->nil) return node;
+            node = node->right;
+          } else {
+            return node;
+          }
+        }
+      }
+
+      void siteEvent(uint32_t site) {
+        const SweepPoint &p = this->sites[site];
+        this->sweepY = p.y;
+
+        if (this->root == this->nil) {
+          this->root = this->createArc(site);
+          this->root->red = false;
+          return;
+        }
+
+        Arc *above = this->arcAbove(p.x);
+        Arc *arc = this->createArc(site);
+
+        if (this->sites[above->site].y == p.y) {
+          // only while every arc still sits on the first sweep line: a vertical edge, open towards -y
+          uint32_t edge = this->createEdge(above->site, site);
+          arc->rightEdge = above->rightEdge;
+          arc->rightSign = above->rightSign;
+          above->rightEdge = edge;
+          above->rightSign = 1;
+          this->insertAfter(above, arc);
+          return;
+        }
+
+        // split the arc above into above | arc | copy, both new breakpoints trace the same edge
+        this->invalidate(above);
+        Arc *copy = this->createArc(above->site);
+        uint32_t edge = this->createEdge(above->site, site);
+        copy->rightEdge = above->rightEdge;
+        copy->rightSign = above->rightSign;
+        above->rightEdge = edge;
+        above->rightSign = 1;
+        arc->rightEdge = edge;
+        arc->rightSign = -1;
+        this->insertAfter(above, arc);
+        this->insertAfter(arc, copy);
+
+        this->checkCircle(above);
+        this->checkCircle(copy);
+      }
+
+      void circleEvent(CircleEvent *event) {
+        Arc *arc = event->arc;
+        Arc *left = arc->prev;
+        Arc *right = arc->next;
+        this->sweepY = event->y;
+
+        this->vertices.push_back({ event->centerX, event->centerY });
+        uint32_t vertex = (uint32_t) (this->vertices.size() - 1);
+        this->endEdge(left->rightEdge, left->rightSign, vertex);
+        this->endEdge(arc->rightEdge, arc->rightSign, vertex);
+
+        arc->event = NULL;
+        this->invalidate(left);
+        this->invalidate(right);
+        this->remove(arc);
+        this->arcs.release(arc);
+
+        uint32_t edge = this->createEdge(left->site, right->site);
+        this->edges[edge].from = vertex;
+        left->rightEdge = edge;
+        left->rightSign = 1;
+
+        this->checkCircle(left);
+        this->checkCircle(right);
+      }
+
+      void invalidate(Arc *arc) {
+        if (arc->event != NULL) {
+          arc->event->arc = NULL;
+          arc->event = NULL;
+        }
+      }
+
+      /**
+       * @brief Schedule the disappearance of arc if its breakpoints converge, i.e. its left, own and right
+       * sites turn counterclockwise
+       */
+      void checkCircle(Arc *arc) {
+        Arc *left = arc->prev;
+        Arc *right = arc->next;
+        if (left == NULL || right == NULL || left->site == right->site) return;
+
+        const SweepPoint &a = this->sites[left->site];
+        const SweepPoint &b = this->sites[arc->site];
+        const SweepPoint &c = this->sites[right->site];
+        if (Predicates::orient2d(a.x, a.y, b.x, b.y, c.x, c.y) <= 0.0) return;
+
+        // circumcenter relative to b
+        double ax = a.x - b.x, ay = a.y - b.y;
+        double cx = c.x - b.x, cy = c.y - b.y;
+        double d = 2.0 * (ax * cy - ay * cx);
+        double aa = ax * ax + ay * ay;
+        double cc = cx * cx + cy * cy;
+        double ux = (cy * aa - ay * cc) / d;
+        double uy = (ax * cc - cx * aa) / d;
+
+        CircleEvent *event = this->events.create();
+        event->centerX = b.x + ux;
+        event->centerY = b.y + uy;
+        event->y = std::max(event->centerY + std::sqrt(ux * ux + uy * uy), this->sweepY);
+        event->x = event->centerX;
+        event->arc = arc;
+        arc->event = event;
+        this->queue.push(event);
+      }
+
+      // red-black tree, CLRS with a shared nil sentinel, plus the in-order prev/next thread
+
+      void rotateLeft(Arc *x) {
+        Arc *y = x->right;
+        x->right = y->left;
+        if (y->left != this->nil) y->left->parent = x;
+        y->parent = x->parent;
+        if (x->parent == this->nil) {
+          this->root = y;
+        } else if (x == x->parent->left) {
+          x->parent->left = y;
+        } else {
+          x->parent->right = y;
+        }
+        y->left = x;
+        x->parent = y;
+      }
+
+      void rotateRight(Arc *x) {
+        Arc *y = x->left;
+        x->left = y->right;
+        if (y->right != this->nil) y->right->parent = x;
+        y->parent = x->parent;
+        if (x->parent == this->nil) {
+          this->root = y;
+        } else if (x == x->parent->right) {
+          x->parent->right = y;
+        } else {
+          x->parent->left = y;
+        }
+        y->right = x;
+        x->parent = y;
+      }
+
+      void insertAfter(Arc *x, Arc *z) {
+        if (x->right == this->nil) {
+          x->right = z;
+          z->parent = x;
+        } else {
+          x->next->left = z;
+          z->parent = x->next;
+        }
+        z->prev = x;
+        z->next = x->next;
+        if (x->next != NULL) x->next->prev = z;
+        x->next = z;
+
+        while (z->parent->red) {
+          Arc *grandparent = z->parent->parent;
+          if (z->parent == grandparent->left) {
+            Arc *uncle = grandparent->right;
+            if (uncle->red) {
+              z->parent->red = false;
+              uncle->red = false;
+              grandparent->red = true;
+              z = grandparent;
+            } else {
+              if (z == z->parent->right) {
+                z = z->parent;
+                this->rotateLeft(z);
+              }
+              z->parent->red = false;
+              z->parent->parent->red = true;
+              this->rotateRight(z->parent->parent);
+            }
+          } else {
+            Arc *uncle = grandparent->left;
+            if (uncle->red) {
+              z->parent->red = false;
+              uncle->red = false;
+              grandparent->red = true;
+              z = grandparent;
+            } else {
+              if (z == z->parent->left) {
+                z = z->parent;
+                this->rotateRight(z);
+              }
+              z->parent->red = false;
+              z->parent->parent->red = true;
+              this->rotateLeft(z->parent->parent);
+            }
+          }
+        }
+        this->root->red = false;
+      }
+
+      void transplant(Arc *u, Arc *v) {
+        if (u->parent == this->nil) {
+          this->root = v;
+        } else if (u == u->parent->left) {
+          u->parent->left = v;
+        } else {
+          u->parent->right = v;
+        }
+        v->parent = u->parent;
+      }
+
+      void remove(Arc *z) {
+        if (z->prev != NULL) z->prev->next = z->next;
+        if (z->next != NULL) z->next->prev = z->prev;
+
+        Arc *y = z;
+        Arc *x;
+        bool removedRed = y->red;
+        if (z->left == this->nil) {
+          x = z->right;
+          this->transplant(z, z->right);
+        } else if (z->right == this->nil) {
+          x = z->left;
+          this->transplant(z, z->left);
+        } else {
+          y = z->right;
+          while (y->left != this->nil) y = y->left;
+          removedRed = y->red;
+          x = y->right;
+          if (y->parent == z) {
+            x->parent = y;
+          } else {
+            this->transplant(y, y->right);
+            y->right = z->right;
+            y->right->parent = y;
+          }
+          this->transplant(z, y);
+          y->left = z->left;
+          y->left->parent = y;
+          y->red = z->red;
+        }
+        if (removedRed) return;
+
+        while (x != this->root && !x->red) {
+          if (x == x->parent->left) {
+            Arc *w = x->parent->right;
+            if (w->red) {
+              w->red = false;
+              x->parent->red = true;
+              this->rotateLeft(x->parent);
+              w = x->parent->right;
+            }
+            if (!w->left->red && !w->right->red) {
+              w->red = true;
+              x = x->parent;
+            } else {
+              if (!w->right->red) {
+                w->left->red = false;
+                w->red = true;
+                this->rotateRight(w);
+                w = x->parent->right;
+              }
+              w->red = x->parent->red;
+              x->parent->red = false;
+              w->right->red = false;
+              this->rotateLeft(x->parent);
+              x = this->root;
+            }
+          } else {
+            Arc *w = x->parent->left;
+            if (w->red) {
+              w->red = false;
+              x->parent->red = true;
+              this->rotateRight(x->parent);
+              w = x->parent->left;
+            }
+            if (!w->right->red && !w->left->red) {
+              w->red = true;
+              x = x->parent;
+            } else {
+              if (!w->left->red) {
+                w->right->red = false;
+                w->red = true;
+                this->rotateLeft(w);
+                w = x->parent->left;
+              }
+              w->red = x->parent->red;
+              x->parent->red = false;
+              w->left->red = false;
+              this->rotateRight(x->parent);
+              x = this->root;
+            }
+          }
+        }
+        x->red = false;
+      }
+  };
+
+  /**
+   * @brief Liang-Barsky: shrink [t0, t1] so origin + t * direction stays inside the box
+   */
+  static bool clipLine(SweepPoint origin, SweepPoint direction, const SweepPoint &low, const SweepPoint &high, double &t0, double &t1) {
+    double p[4] = { -direction.x, direction.x, -direction.y, direction.y };
+    double q[4] = { origin.x - low.x, high.x - origin.x, origin.y - low.y, high.y - origin.y };
+    for (int i = 0; i < 4; i++) {
+      if (p[i] == 0.0) {
+        if (q[i] < 0.0) return false;
+        continue;
+      }
+      double t = q[i] / p[i];
+      if (p[i] < 0.0) {
+        t0 = std::max(t0, t);
+      } else {
+        t1 = std::min(t1, t);
+      }
+    }
+    return t0 <= t1;
+  }
+
+  VoronoiDiagram Voronoi::build(std::span<const Vector2D> sites, Vector2D boxMin, Vector2D boxMax) {
+    VoronoiDiagram diagram;
+    diagram.boxMin = boxMin;
+    diagram.boxMax = boxMax;
+    diagram.cellOffsets.assign(sites.size() + 1, 0);
+    if (sites.empty()) return diagram;
+
+    std::vector<SweepPoint> rawVertices;
+    std::vector<VoronoiDiagram::Edge> rawEdges;
+    {
+      FortuneSweep sweep(sites);
+      sweep.run();
+      rawVertices = std::move(sweep.vertices);
+      rawEdges = std::move(sweep.edges);
+    }
+
+    // clip every edge as a segment of its bisector, keeping shared vertices shared
+    SweepPoint low = { boxMin.vector[0], boxMin.vector[1] };
+    SweepPoint high = { boxMax.vector[0], boxMax.vector[1] };
+    std::vector<uint32_t> vertexIndex(rawVertices.size(), NONE);
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    auto keepVertex = [&](uint32_t raw) {
+      if (vertexIndex[raw] == NONE) {
+        vertexIndex[raw] = (uint32_t) diagram.vertices.size();
+        diagram.vertices.push_back({ (float) rawVertices[raw].x, (float) rawVertices[raw].y });
+      }
+      return vertexIndex[raw];
+    };
+    auto addVertex = [&](SweepPoint p) {
+      diagram.vertices.push_back({ (float) p.x, (float) p.y });
+      return (uint32_t) (diagram.vertices.size() - 1);
+    };
+
+    // clipped edges are compacted in place over the raw ones to keep the peak footprint down
+    size_t kept = 0;
+    for (size_t e = 0; e < rawEdges.size(); e++) {
+      VoronoiDiagram::Edge edge = rawEdges[e];
+      Vector2D l = sites[edge.leftSite];
+      Vector2D r = sites[edge.rightSite];
+      SweepPoint origin = { 0.5 * ((double) l.vector[0] + r.vector[0]), 0.5 * ((double) l.vector[1] + r.vector[1]) };
+      SweepPoint direction = { (double) l.vector[1] - r.vector[1], (double) r.vector[0] - l.vector[0] };
+      double lengthSquared = direction.x * direction.x + direction.y * direction.y;
+
+      auto parameter = [&](uint32_t raw) {
+        return ((rawVertices[raw].x - origin.x) * direction.x + (rawVertices[raw].y - origin.y) * direction.y) / lengthSquared;
+      };
+      double t0 = edge.from == NONE ? -infinity : parameter(edge.from);
+      double t1 = edge.to == NONE ? infinity : parameter(edge.to);
+      double clipped0 = t0, clipped1 = t1;
+      if (!clipLine(origin, direction, low, high, clipped0, clipped1)) continue;
+      if (clipped0 == clipped1 && (edge.from == NONE || edge.to == NONE)) continue;
+
+      uint32_t from = clipped0 == t0 ? keepVertex(edge.from) : addVertex({ origin.x + clipped0 * direction.x, origin.y + clipped0 * direction.y });
+      uint32_t to = clipped1 == t1 ? keepVertex(edge.to) : addVertex({ origin.x + clipped1 * direction.x, origin.y + clipped1 * direction.y });
+      rawEdges[kept++] = { edge.leftSite, edge.rightSite, from, to };
+    }
+    rawEdges.resize(kept);
+    rawEdges.shrink_to_fit();
+    diagram.edges = std::move(rawEdges);
+    std::vector<SweepPoint>().swap(rawVertices);
+
+    // CSR cell index
+    for (const VoronoiDiagram::Edge &edge : diagram.edges) {
+      diagram.cellOffsets[edge.leftSite + 1]++;
+      diagram.cellOffsets[edge.rightSite + 1]++;
+    }
+    for (size_t i = 1; i < diagram.cellOffsets.size(); i++) {
+      diagram.cellOffsets[i] += diagram.cellOffsets[i - 1];
+    }
+    diagram.cellEdges.resize(diagram.cellOffsets.back());
+    std::vector<uint32_t> fill(diagram.cellOffsets.begin(), diagram.cellOffsets.end() - 1);
+    for (uint32_t e = 0; e < diagram.edges.size(); e++) {
+      diagram.cellEdges[fill[diagram.edges[e].leftSite]++] = e;
+      diagram.cellEdges[fill[diagram.edges[e].rightSite]++] = e;
+    }
+
+    // box corners belong to the nearest site's cell
+    SweepPoint corners[4] = { { low.x, low.y }, { high.x, low.y }, { high.x, high.y }, { low.x, high.y } };
+    double best[4] = { infinity, infinity, infinity, infinity };
+    for (uint32_t i = 0; i < sites.size(); i++) {
+      for (int k = 0; k < 4; k++) {
+        double dx = sites[i].vector[0] - corners[k].x;
+        double dy = sites[i].vector[1] - corners[k].y;
+        if (dx * dx + dy * dy < best[k]) {
+          best[k] = dx * dx + dy * dy;
+          diagram.cornerSites[k] = i;
+        }
+      }
+    }
+    return diagram;
+  }
+
+  std::vector<Vector2D> Voronoi::cellPolygon(const VoronoiDiagram &diagram, std::span<const Vector2D> sites, uint32_t site) {
+    std::vector<uint32_t> indices;
+    for (uint32_t i = diagram.cellOffsets[site]; i < diagram.cellOffsets[site + 1]; i++) {
+      const VoronoiDiagram::Edge &edge = diagram.edges[diagram.cellEdges[i]];
+      indices.push_back(edge.from);
+      indices.push_back(edge.to);
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    std::vector<Vector2D> outline;
+    outline.reserve(indices.size() + 4);
+    for (uint32_t index : indices) outline.push_back(diagram.vertices[index]);
+    Vector2D corners[4] = {
+      { diagram.boxMin.vector[0], diagram.boxMin.vector[1] }, { diagram.boxMax.vector[0], diagram.boxMin.vector[1] },
+      { diagram.boxMax.vector[0], diagram.boxMax.vector[1] }, { diagram.boxMin.vector[0], diagram.boxMax.vector[1] }
+    };
+    for (int k = 0; k < 4; k++) {
+      if (diagram.cornerSites[k] == site) outline.push_back(corners[k]);
+    }
+
+    // cells are convex and contain their site, so sorting by angle around it gives the outline
+    Vector2D center = sites[site];
+    std::sort(outline.begin(), outline.end(), [&](const Vector2D &a, const Vector2D &b) {
+      return std::atan2(a.vector[1] - center.vector[1], a.vector[0] - center.vector[0]) <
+        std::atan2(b.vector[1] - center.vector[1], b.vector[0] - center.vector[0]);
+    });
+    return outline;
+  }
+
+  std::vector<Vector2D> Voronoi::edgeSegments(const VoronoiDiagram &diagram) {
+    std::vector<Vector2D> segments;
+    segments.reserve(2 * diagram.edges.size());
+    for (const VoronoiDiagram::Edge &edge : diagram.edges) {
+      segments.push_back(diagram.vertices[edge.from]);
+      segments.push_back(diagram.vertices[edge.to]);
+    }
+    return segments;
+  }
+
+  std::vector<Shapes::Polygon *> Voronoi::toEdgeShapes(const VoronoiDiagram &diagram) {
+    std::vector<Shapes::Polygon *> shapes;
+    shapes.reserve(diagram.edges.size());
+    for (const VoronoiDiagram::Edge &edge : diagram.edges) {
+      Vector2D ends[2] = { diagram.vertices[edge.from], diagram.vertices[edge.to] };
+      Shapes::Polygon *shape = (Shapes::Polygon *) Shapes::ShapeFactory::constructShape(Shapes::POLYGON, Shapes::LINE_SHAPE);
+      shape->setVertices(ends, 2);
+      shapes.push_back(shape);
+    }
+    return shapes;
+  }
+
+  Shapes::Polygon *Voronoi::toCellPolygon(const VoronoiDiagram &diagram, std::span<const Vector2D> sites, uint32_t site, Shapes::ShapeDrawingStyle drawingStyle) {
+    std::vector<Vector2D> outline = cellPolygon(diagram, sites, site);
+    Shapes::Polygon *polygon = (Shapes::Polygon *) Shapes::ShapeFactory::constructShape(Shapes::POLYGON, drawingStyle);
+    polygon->setVertices(outline.data(), (unsigned int) outline.size());
+    return polygon;
+  }
+}
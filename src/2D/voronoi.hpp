@@ -0,0 +1,78 @@
+#ifndef VORONOI_HPP
+#define VORONOI_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "shapes.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Voronoi diagram clipped to a box, stored compactly: every edge is the pair of sites it separates plus
+   * two indices into the shared vertex array, and each site's edges are listed in a CSR index
+   */
+  struct VoronoiDiagram {
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Edge {
+      uint32_t leftSite;
+      uint32_t rightSite;
+      uint32_t from;
+      uint32_t to;
+    };
+
+    std::vector<Vector2D> vertices;
+    std::vector<Edge> edges;
+    // edges bounding site i are cellEdges[cellOffsets[i] .. cellOffsets[i + 1])
+    std::vector<uint32_t> cellOffsets;
+    std::vector<uint32_t> cellEdges;
+    // site whose cell contains each box corner: (min, min), (max, min), (max, max), (min, max)
+    uint32_t cornerSites[4] = { NONE, NONE, NONE, NONE };
+    Vector2D boxMin = { 0.0f, 0.0f };
+    Vector2D boxMax = { 0.0f, 0.0f };
+  };
+
+  /**
+   * @brief Fortune's sweep line Voronoi construction. The beach line is a red-black tree of arcs threaded with
+   * prev/next links, circle events sit in a binary heap and are invalidated lazily. Arcs and events are drawn
+   * from a bump arena with free lists, so memory stays proportional to the beach line and the diagram itself
+   * and everything is released in one go when the sweep ends.
+   */
+  class Voronoi {
+    public:
+      /**
+       * @brief Build the diagram of sites clipped to [boxMin, boxMax]
+       *
+       * @param sites Sites, expected inside the box. Duplicates after the first get an empty cell
+       * @param boxMin Lower left corner of the clipping box
+       * @param boxMax Upper right corner of the clipping box
+       */
+      static VoronoiDiagram build(std::span<const Vector2D> sites, Vector2D boxMin, Vector2D boxMax);
+
+      /**
+       * @brief Outline of one cell, counterclockwise, including the box corners it owns
+       */
+      static std::vector<Vector2D> cellPolygon(const VoronoiDiagram &diagram, std::span<const Vector2D> sites, uint32_t site);
+
+      /**
+       * @brief Two vertices per edge, ready for GL_LINES
+       */
+      static std::vector<Vector2D> edgeSegments(const VoronoiDiagram &diagram);
+
+      /**
+       * @brief Every edge as a two vertex LINE_SHAPE polygon for the batch renderer
+       *
+       * @return std::vector<Shapes::Polygon*> Heap allocated polygons owned by the caller
+       */
+      static std::vector<Shapes::Polygon *> toEdgeShapes(const VoronoiDiagram &diagram);
+
+      /**
+       * @brief One cell as a drawable polygon
+       *
+       * @return Shapes::Polygon* Heap allocated polygon owned by the caller
+       */
+      static Shapes::Polygon *toCellPolygon(const VoronoiDiagram &diagram, std::span<const Vector2D> sites, uint32_t site, Shapes::ShapeDrawingStyle drawingStyle);
+  };
+}
+
+#endif
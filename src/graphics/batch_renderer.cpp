@@ -0,0 +1,152 @@
+#include <algorithm>
+#include "batch_renderer.hpp"
+
+using namespace Shapes;
+
+namespace Graphics {
+  /**
+   * @brief Register a shape to be drawn, its vertices are gathered on the next draw
+   *
+   * @param shape Shape with calculated vertices, owned by the caller
+   */
+  void BatchRenderer::addShape(Shape2D *shape) {
+    if (this->slots.count(shape) > 0) return;
+
+    ShapeSlot slot = { this->shapes.size(), 0, 0 };
+    this->shapes.push_back(shape);
+    this->slots.emplace(shape, slot);
+    this->dirty = true;
+  }
+
+  /**
+   * @brief Stop drawing a shape, the last registered shape takes over its index
+   */
+  void BatchRenderer::removeShape(Shape2D *shape) {
+    auto found = this->slots.find(shape);
+    if (found == this->slots.end()) return;
+
+    size_t index = found->second.shapeIndex;
+    Shape2D *last = this->shapes.back();
+    this->shapes[index] = last;
+    this->slots[last].shapeIndex = index;
+    this->shapes.pop_back();
+    this->slots.erase(shape);
+    this->dirty = true;
+  }
+
+  /**
+   * @brief Re-upload a shape whose vertices moved. When its vertex count is unchanged only
+   * its range of the batch buffer is rewritten, otherwise the batches are rebuilt on the next draw.
+   * Filled shapes keep their triangulation, which stays valid as long as the outline is only moved,
+   * rotated or scaled; call markDirty after reshaping one
+   */
+  void BatchRenderer::updateShape(Shape2D *shape) {
+    auto found = this->slots.find(shape);
+    if (found == this->slots.end() || this->dirty) return;
+
+    ShapeSlot &slot = found->second;
+    if (shape->getVertices() == NULL || shape->getNumberOfSides() != slot.count) {
+      this->dirty = true;
+      return;
+    }
+
+    Batch &batch = this->batchFor(shape->getDrawingStyle());
+    std::copy(shape->getVertices(), shape->getVertices() + slot.count, batch.vertices.begin() + slot.first);
+    batch.buffer.updateVertices(slot.first, shape->getVertices(), slot.count);
+  }
+
+  void BatchRenderer::clear() {
+    this->shapes.clear();
+    this->slots.clear();
+    this->dirty = true;
+  }
+
+  /**
+   * @brief Force every batch to be gathered again on the next draw, e.g. after many shapes changed at once
+   */
+  void BatchRenderer::markDirty() { this->dirty = true; }
+
+  size_t BatchRenderer::getShapeCount() { return this->shapes.size(); }
+
+  BatchRenderer::Batch &BatchRenderer::batchFor(ShapeDrawingStyle drawingStyle) {
+    switch (drawingStyle) {
+      case LINE_SHAPE:
+        return this->lineBatch;
+      case FILL_SHAPE:
+        return this->fillBatch;
+      default:
+        return this->pointBatch;
+    }
+  }
+
+  /**
+   * @brief Gather the vertices of every shape into its style's batch and upload each batch in one call.
+   * Filled outlines are triangulated into the fill batch's index list. The CPU side vectors keep their
+   * capacity, so steady state rebuilds do not allocate
+   */
+  void BatchRenderer::rebuild() {
+    for (Batch *batch : { &this->pointBatch, &this->lineBatch, &this->fillBatch }) {
+      batch->vertices.clear();
+      batch->firsts.clear();
+      batch->counts.clear();
+      batch->indices.clear();
+    }
+
+    for (Shape2D *shape : this->shapes) {
+      ShapeSlot &slot = this->slots[shape];
+      Vector2D *vertices = shape->getVertices();
+      size_t count = vertices == NULL ? 0 : shape->getNumberOfSides();
+
+      Batch &batch = this->batchFor(shape->getDrawingStyle());
+      slot.first = batch.vertices.size();
+      slot.count = count;
+      if (count == 0) continue;
+
+      batch.vertices.insert(batch.vertices.end(), vertices, vertices + count);
+      batch.firsts.push_back((GLint) slot.first);
+      batch.counts.push_back((GLsizei) count);
+
+      if (shape->getDrawingStyle() == FILL_SHAPE) {
+        this->triangulator.triangulate(std::span<const Vector2D>(vertices, count), {}, this->shapeTriangles);
+        for (uint32_t index : this->shapeTriangles) {
+          batch.indices.push_back((uint32_t) slot.first + index);
+        }
+      }
+    }
+
+    for (Batch *batch : { &this->pointBatch, &this->lineBatch, &this->fillBatch }) {
+      batch->buffer.setVertices(batch->vertices.data(), batch->vertices.size());
+    }
+    this->fillBatch.buffer.setIndices(this->fillBatch.indices.data(), this->fillBatch.indices.size());
+    this->dirty = false;
+  }
+
+  /**
+   * @brief Draw every registered shape, one draw call per drawing style
+   *
+   * @param shaderProgram Program used for every style
+   */
+  void BatchRenderer::draw(unsigned int shaderProgram) {
+    if (this->dirty) this->rebuild();
+
+    glUseProgram(shaderProgram);
+
+    // points have no per-shape topology, the whole batch is a single range
+    if (!this->pointBatch.vertices.empty()) {
+      glPointSize(10);
+      this->pointBatch.buffer.draw(GL_POINTS, 0, this->pointBatch.vertices.size());
+    }
+
+    // each line shape is closed on its own, the offset table keeps loops from joining
+    if (!this->lineBatch.counts.empty()) {
+      this->lineBatch.buffer.bind();
+      glMultiDrawArrays(GL_LINE_LOOP, this->lineBatch.firsts.data(), this->lineBatch.counts.data(), (GLsizei) this->lineBatch.counts.size());
+    }
+
+    // every filled shape's triangles share one index buffer
+    if (!this->fillBatch.indices.empty()) {
+      glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+      this->fillBatch.buffer.drawIndexed(GL_TRIANGLES, 0, this->fillBatch.indices.size());
+    }
+  }
+}
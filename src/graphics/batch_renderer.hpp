@@ -0,0 +1,65 @@
+#ifndef BATCH_RENDERER_HPP
+#define BATCH_RENDERER_HPP
+
+#include <vector>
+#include <unordered_map>
+#include "graphics.hpp"
+#include "../2D/shapes.hpp"
+#include "../2D/polygon_triangulation.hpp"
+
+namespace Graphics {
+  /**
+   * @brief Gathers the vertices of every registered shape into one contiguous buffer per drawing style,
+   * so a whole scene costs one draw call per style instead of one buffer and one draw per shape
+   */
+  class BatchRenderer {
+    public:
+      BatchRenderer() {};
+      BatchRenderer(const BatchRenderer&) = delete;
+      BatchRenderer &operator=(const BatchRenderer&) = delete;
+
+      void addShape(Shapes::Shape2D *shape);
+      void removeShape(Shapes::Shape2D *shape);
+      void updateShape(Shapes::Shape2D *shape);
+      void clear();
+      void markDirty();
+      void draw(unsigned int shaderProgram);
+
+      size_t getShapeCount();
+    private:
+      /**
+       * @brief Vertices of every shape sharing a drawing style, with the offset table used by glMultiDrawArrays
+       * and, for filled shapes, the triangle indices of every outline
+       */
+      struct Batch {
+        std::vector<Vector2D> vertices;
+        std::vector<GLint> firsts;
+        std::vector<GLsizei> counts;
+        std::vector<uint32_t> indices;
+        VertexBuffer buffer;
+      };
+
+      /**
+       * @brief Where a shape's vertices live inside its style's batch
+       */
+      struct ShapeSlot {
+        size_t shapeIndex;
+        size_t first;
+        size_t count;
+      };
+
+      std::vector<Shapes::Shape2D*> shapes;
+      std::unordered_map<Shapes::Shape2D*, ShapeSlot> slots;
+      Batch pointBatch;
+      Batch lineBatch;
+      Batch fillBatch;
+      Geometry::PolygonTriangulator triangulator;
+      std::vector<uint32_t> shapeTriangles;
+      bool dirty = true;
+
+      Batch &batchFor(Shapes::ShapeDrawingStyle drawingStyle);
+      void rebuild();
+  };
+}
+
+#endif
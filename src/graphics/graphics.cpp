@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <chrono>
 #include "graphics.hpp"
 
 namespace Graphics {
@@ -22,7 +24,7 @@ namespace Graphics {
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &shaderProgramSuccess);
     if (!shaderProgramSuccess) {
       glGetProgramInfoLog(shaderProgram, 512, NULL, shaderProgramInfoLog);
-      std::cout << "ERROR::SHADER_PROGRAM::COMPILATION_FAILED\n" << shaderProgramInfoLog << std::endl;
+      LOG_ERROR("Graphics", "SHADER_PROGRAM::COMPILATION_FAILED\n%s", shaderProgramInfoLog);
     }
 
     this->shaderProgram = shaderProgram;
@@ -32,4 +34,295 @@ namespace Graphics {
   void Shaders::setShaderProgram(unsigned int shaderProgram) {
     this->shaderProgram = shaderProgram;
   }
+
+  ShaderRegistry::~ShaderRegistry() { this->clear(); }
+
+  /**
+   * @brief Get the linked program for a vertex/fragment shader pair, compiling and linking it
+   * the first time the pair is requested
+   *
+   * @param vertexPath Path to the vertex shader source
+   * @param fragmentPath Path to the fragment shader source
+   * @return unsigned int Cached shader program handle, 0 if either source could not be read. Failed pairs are
+   * not cached, so a later request retries the read
+   */
+  unsigned int ShaderRegistry::getProgram(const std::string &vertexPath, const std::string &fragmentPath) {
+    auto key = std::make_pair(vertexPath, fragmentPath);
+    auto cached = this->programs.find(key);
+    if (cached != this->programs.end()) {
+      return cached->second.shaderProgram;
+    }
+
+    const std::string vertexShaderCode = GraphicsUtilities::read_shader_file(vertexPath.c_str());
+    const std::string fragmentShaderCode = GraphicsUtilities::read_shader_file(fragmentPath.c_str());
+    if (vertexShaderCode.empty() || fragmentShaderCode.empty()) {
+      LOG_ERROR("Graphics", "SHADER_REGISTRY::SOURCE_NOT_FOUND %s, %s", vertexPath.c_str(), fragmentPath.c_str());
+      return 0;
+    }
+
+    auto compileStart = std::chrono::steady_clock::now();
+
+    // create vertex shader
+    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    GraphicsUtilities::createShader((GLchar *) vertexShaderCode.c_str(), vertexShader);
+
+    // create fragment shader
+    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    GraphicsUtilities::createShader((GLchar *) fragmentShaderCode.c_str(), fragmentShader);
+
+    auto linkStart = std::chrono::steady_clock::now();
+
+    // create shader program
+    Shaders shaders = Shaders(vertexShader, fragmentShader);
+
+    auto linkEnd = std::chrono::steady_clock::now();
+
+    // the linked program keeps what it needs, the shader objects can go
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    ProgramEntry entry;
+    entry.shaderProgram = shaders.getShaderProgram();
+    entry.timings.compileMs = std::chrono::duration<double, std::milli>(linkStart - compileStart).count();
+    entry.timings.linkMs = std::chrono::duration<double, std::milli>(linkEnd - linkStart).count();
+    this->programs.emplace(key, entry);
+
+    return entry.shaderProgram;
+  }
+
+  /**
+   * @brief Compile and link timings for a shader pair
+   *
+   * @return const ProgramTimings* Timings, or NULL if the pair has not been built yet
+   */
+  const ShaderRegistry::ProgramTimings *ShaderRegistry::getTimings(const std::string &vertexPath, const std::string &fragmentPath) {
+    auto cached = this->programs.find(std::make_pair(vertexPath, fragmentPath));
+    if (cached == this->programs.end()) return NULL;
+    return &cached->second.timings;
+  }
+
+  /**
+   * @brief Print compile and link time for every program built so far
+   */
+  void ShaderRegistry::reportTimings() {
+    for (const auto &[paths, entry] : this->programs) {
+      LOG_INFO("Graphics", "SHADER_REGISTRY::PROGRAM %u (%s, %s) compile %.3f ms link %.3f ms",
+        entry.shaderProgram, paths.first.c_str(), paths.second.c_str(),
+        entry.timings.compileMs, entry.timings.linkMs);
+    }
+  }
+
+  /**
+   * @brief Delete every cached program, requires the owning GL context to still be current
+   */
+  void ShaderRegistry::clear() {
+    for (const auto &[paths, entry] : this->programs) {
+      glDeleteProgram(entry.shaderProgram);
+    }
+    this->programs.clear();
+  }
+
+  // minimum number of vertices allocated the first time a buffer is filled
+  static const size_t MIN_VERTEX_CAPACITY = 256;
+
+  VertexBuffer::~VertexBuffer() {
+    if (this->VBO != 0) glDeleteBuffers(1, &this->VBO);
+    if (this->EBO != 0) glDeleteBuffers(1, &this->EBO);
+    if (this->VAO != 0) glDeleteVertexArrays(1, &this->VAO);
+  }
+
+  /**
+   * @brief Generate the VAO/VBO pair and describe the Vector2D layout, deferred until first use so
+   * buffers can be declared before a GL context exists
+   */
+  void VertexBuffer::create() {
+    glGenVertexArrays(1, &this->VAO);
+    glGenBuffers(1, &this->VBO);
+
+    glBindVertexArray(this->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+
+    // two tightly packed floats per vertex, matching Vector2D
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2D), (void*)0);
+    glEnableVertexAttribArray(0);
+  }
+
+  /**
+   * @brief Reallocate the buffer store to at least minCapacity vertices, doubling the current capacity
+   *
+   * @param minCapacity Number of vertices the new store must hold
+   * @param preserveContents Copy the current vertices into the new store
+   */
+  void VertexBuffer::grow(size_t minCapacity, bool preserveContents) {
+    size_t newCapacity = std::max({ minCapacity, this->capacity * 2, MIN_VERTEX_CAPACITY });
+
+    if (!preserveContents || this->vertexCount == 0) {
+      // re-specifying the store orphans the old one, the driver frees it once pending draws finish
+      glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+      glBufferData(GL_ARRAY_BUFFER, newCapacity * sizeof(Vector2D), NULL, GL_DYNAMIC_DRAW);
+      this->capacity = newCapacity;
+      return;
+    }
+
+    // copy the live range GPU side into a larger buffer, then swap it into the VAO
+    unsigned int newVBO;
+    glGenBuffers(1, &newVBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newVBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * sizeof(Vector2D), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, this->VBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, this->vertexCount * sizeof(Vector2D));
+    glDeleteBuffers(1, &this->VBO);
+
+    this->VBO = newVBO;
+    this->capacity = newCapacity;
+
+    glBindVertexArray(this->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2D), (void*)0);
+  }
+
+  /**
+   * @brief Make room for at least vertexCapacity vertices without touching the current contents
+   */
+  void VertexBuffer::reserve(size_t vertexCapacity) {
+    if (this->VAO == 0) this->create();
+    if (vertexCapacity > this->capacity) {
+      this->grow(vertexCapacity, true);
+    }
+  }
+
+  /**
+   * @brief Replace the buffer contents. The store is only reallocated when n exceeds the capacity,
+   * otherwise it is orphaned and refilled so the upload never waits on in-flight draws
+   *
+   * @param vertices Vertices to upload
+   * @param n Number of vertices
+   */
+  void VertexBuffer::setVertices(const Vector2D *vertices, size_t n) {
+    if (this->VAO == 0) this->create();
+    if (n > this->capacity) {
+      this->grow(n, false);
+    } else {
+      this->orphan();
+    }
+
+    if (n > 0) {
+      glBufferSubData(GL_ARRAY_BUFFER, 0, n * sizeof(Vector2D), vertices);
+    }
+    this->vertexCount = n;
+  }
+
+  /**
+   * @brief Replace the buffer contents with a structure-of-arrays point set. The buffer is mapped and the
+   * points are interleaved straight into GPU-visible memory, without an intermediate Vector2D copy
+   *
+   * @param points Points to upload, z is ignored
+   */
+  void VertexBuffer::setVertices(const Geometry::PointBuffer &points) {
+    if (this->VAO == 0) this->create();
+    size_t n = points.size();
+    if (n > this->capacity) {
+      this->grow(n, false);
+    } else {
+      glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    }
+
+    if (n > 0) {
+      // invalidating the range lets the driver hand back fresh memory instead of waiting on pending draws
+      void *mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, n * sizeof(Vector2D), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+      if (mapped != NULL) {
+        points.copyInterleaved(0, n, (Vector2D *) mapped);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+      }
+    }
+    this->vertexCount = n;
+  }
+
+  /**
+   * @brief Overwrite only the dirty range [first, first + n), growing the buffer if the range runs past the end
+   *
+   * @param first Index of the first vertex to overwrite
+   * @param vertices Replacement vertices
+   * @param n Number of vertices
+   */
+  void VertexBuffer::updateVertices(size_t first, const Vector2D *vertices, size_t n) {
+    if (this->VAO == 0) this->create();
+    if (first + n > this->capacity) {
+      this->grow(first + n, true);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    if (n > 0) {
+      glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vector2D), n * sizeof(Vector2D), vertices);
+    }
+    this->vertexCount = std::max(this->vertexCount, first + n);
+  }
+
+  /**
+   * @brief Detach the current store from the buffer object so the next upload gets fresh memory
+   * instead of synchronizing with draws still reading the old contents
+   */
+  void VertexBuffer::orphan() {
+    if (this->VAO == 0) this->create();
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    glBufferData(GL_ARRAY_BUFFER, this->capacity * sizeof(Vector2D), NULL, GL_DYNAMIC_DRAW);
+  }
+
+  void VertexBuffer::bind() {
+    if (this->VAO == 0) this->create();
+    glBindVertexArray(this->VAO);
+  }
+
+  /**
+   * @brief Draw a range of the buffered vertices with the currently bound shader program
+   *
+   * @param mode OpenGL primitive type, e.g. GL_POINTS
+   * @param first Index of the first vertex to draw
+   * @param n Number of vertices
+   */
+  void VertexBuffer::draw(GLenum mode, size_t first, size_t n) {
+    this->bind();
+    glDrawArrays(mode, (GLint) first, (GLsizei) n);
+  }
+
+  /**
+   * @brief Replace the element buffer, e.g. a triangulation's index list. The element buffer is VAO state,
+   * so it is created lazily and stays attached to this buffer's VAO
+   *
+   * @param indices Vertex indices to upload
+   * @param n Number of indices
+   */
+  void VertexBuffer::setIndices(const uint32_t *indices, size_t n) {
+    if (this->VAO == 0) this->create();
+    glBindVertexArray(this->VAO);
+    if (this->EBO == 0) glGenBuffers(1, &this->EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+
+    if (n > this->indexCapacity) {
+      this->indexCapacity = std::max({ n, this->indexCapacity * 2, MIN_VERTEX_CAPACITY });
+    }
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->indexCapacity * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+    if (n > 0) {
+      glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, n * sizeof(uint32_t), indices);
+    }
+    this->indexCount = n;
+  }
+
+  /**
+   * @brief Draw a range of the element buffer with the currently bound shader program
+   *
+   * @param mode OpenGL primitive type, e.g. GL_TRIANGLES
+   * @param first Index of the first element to draw
+   * @param n Number of elements
+   */
+  void VertexBuffer::drawIndexed(GLenum mode, size_t first, size_t n) {
+    this->bind();
+    glDrawElements(mode, (GLsizei) n, GL_UNSIGNED_INT, (void*) (first * sizeof(uint32_t)));
+  }
+
+  size_t VertexBuffer::getVertexCount() { return this->vertexCount; }
+  size_t VertexBuffer::getIndexCount() { return this->indexCount; }
+  size_t VertexBuffer::getCapacity() { return this->capacity; }
+  unsigned int VertexBuffer::getVertexArray() { return this->VAO; }
+  unsigned int VertexBuffer::getVertexBuffer() { return this->VBO; }
 }
@@ -5,10 +5,17 @@
 #include <fstream>
 #include <sstream>
 #include <limits>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
 #include <glad/glad.h>
 #include <SDL2/SDL.h>
 
+#include "shader_file.hpp"
 #include "../vectors.hpp"
+#include "../math/point_buffer.hpp"
+#include "../logging/logger.hpp"
 
 namespace Graphics {
   class Shaders {
@@ -20,37 +27,87 @@ namespace Graphics {
       unsigned int shaderProgram;
   };
 
+  /**
+   * @brief Compiles and links each vertex/fragment shader pair once, keyed by their source paths,
+   * and hands out the cached program handle on every later request
+   */
+  class ShaderRegistry {
+    public:
+      /**
+       * @brief Time spent building a single program, in milliseconds
+       */
+      struct ProgramTimings {
+        double compileMs;
+        double linkMs;
+      };
+
+      ShaderRegistry() {};
+      ~ShaderRegistry();
+      ShaderRegistry(const ShaderRegistry&) = delete;
+      ShaderRegistry &operator=(const ShaderRegistry&) = delete;
+
+      unsigned int getProgram(const std::string &vertexPath, const std::string &fragmentPath);
+      const ProgramTimings *getTimings(const std::string &vertexPath, const std::string &fragmentPath);
+      void reportTimings();
+      void clear();
+    private:
+      struct ProgramEntry {
+        unsigned int shaderProgram;
+        ProgramTimings timings;
+      };
+
+      std::map<std::pair<std::string, std::string>, ProgramEntry> programs;
+  };
+
+  /**
+   * @brief Retained VAO/VBO pair holding 2D vertices. Storage is allocated once and grown geometrically,
+   * later uploads only touch the ranges that changed
+   */
+  class VertexBuffer {
+    public:
+      VertexBuffer() {};
+      ~VertexBuffer();
+      VertexBuffer(const VertexBuffer&) = delete;
+      VertexBuffer &operator=(const VertexBuffer&) = delete;
+
+      void reserve(size_t vertexCapacity);
+      void setVertices(const Vector2D *vertices, size_t n);
+      void setVertices(const Geometry::PointBuffer &points);
+      void updateVertices(size_t first, const Vector2D *vertices, size_t n);
+      void orphan();
+      void bind();
+      void draw(GLenum mode, size_t first, size_t n);
+      void setIndices(const uint32_t *indices, size_t n);
+      void drawIndexed(GLenum mode, size_t first, size_t n);
+
+      size_t getVertexCount();
+      size_t getIndexCount();
+      size_t getCapacity();
+      unsigned int getVertexArray();
+      unsigned int getVertexBuffer();
+    private:
+      unsigned int VAO = 0;
+      unsigned int VBO = 0;
+      unsigned int EBO = 0;
+      size_t vertexCount = 0;
+      size_t capacity = 0;
+      size_t indexCount = 0;
+      size_t indexCapacity = 0;
+
+      void create();
+      void grow(size_t minCapacity, bool preserveContents);
+  };
+
   class GraphicsUtilities {
     public:
       /**
        * @brief Reads the contents of a shader file
        *
        * @param shader_file Path to file containing shader
-       * @return std::string Contents of shader file
+       * @return std::string Contents of shader file, empty on failure
        */
       static std::string read_shader_file(const char *shader_file) {
-        // no feedback is provided for stream errors / exceptions.
-        std::ifstream file(shader_file);
-        if (!file) return std::string ();
-
-        file.ignore(std::numeric_limits<std::streamsize>::max());
-        auto size = file.gcount();
-
-        if (size > 0x10000) // 64KiB sanity check for shaders:
-            return std::string ();
-
-        file.clear();
-        file.seekg(0, std::ios_base::beg);
-
-        std::stringstream sstr;
-        sstr << file.rdbuf();
-        sstr << "\0";
-        file.close();
-
-        // std::cout << sstr.str();
-
-        std::string shaderCode = sstr.str().c_str();
-        return shaderCode;
+        return readShaderFile(shader_file);
       }
 
       /**
@@ -70,44 +127,26 @@ namespace Graphics {
         if (!shaderSuccess)
         {
           glGetShaderInfoLog(shader, 512, NULL, vertexInfoLog);
-          std::cout << "ERROR::SHADER::COMPILATION_FAILED\n" << vertexInfoLog << std::endl;
+          LOG_ERROR("Graphics", "SHADER::COMPILATION_FAILED\n%s", vertexInfoLog);
         }
       }
 
       /**
        * @brief Draws an array of points to the provided canvas, to be called in the programs main loop
        *
-       * @param shaderProgram Takes into account both a vertex and fragment shader
+       * @param shaderProgram Takes into account both a vertex and a fragment shader
+       * @param buffer Retained buffer the vertices are uploaded into, reused across calls
        * @param vertices Vertices to draw
        * @param n Number of vertices
        */
-      static void drawPoints(int shaderProgram, Vector2D *vertices, int n) {
-        // Vertex Buffer Object
-        unsigned int VBO;
-        glGenBuffers(1, &VBO);
-
-        // Vertex Array Object
-        unsigned int VAO;
-        glGenVertexArrays(1, &VAO);
-
-        // bind VAO and VBO to the vertex buffer
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices) * sizeof(Vector2D), vertices, GL_STATIC_DRAW);
-
-        // define stride, offset, etc for vertex rendering
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+      static void drawPoints(int shaderProgram, VertexBuffer &buffer, Vector2D *vertices, int n) {
+        buffer.setVertices(vertices, n);
 
         // optional configuration for OpenGL context for wireframe mode
         glPointSize(10);
         glPolygonMode(GL_FRONT_AND_BACK, GL_POINT); // default is GL_FILL - shows rectangle
         glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
-
-        // n = 4?
-        glDrawArrays(GL_POINTS, 0, n);
+        buffer.draw(GL_POINTS, 0, n);
       }
   };
 }
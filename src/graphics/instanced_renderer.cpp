@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstddef>
+#include "instanced_renderer.hpp"
+
+using namespace Shapes;
+
+namespace Graphics {
+  InstancedPolygonRenderer::~InstancedPolygonRenderer() {
+    for (auto &[key, group] : this->groups) {
+      if (group.VBO != 0) glDeleteBuffers(1, &group.VBO);
+      if (group.VAO != 0) glDeleteVertexArrays(1, &group.VAO);
+    }
+  }
+
+  /**
+   * @brief Queue a regular polygon for drawing, only its parameters are kept
+   *
+   * @param polygon Polygon with its center, radius, side count and rotation set
+   */
+  void InstancedPolygonRenderer::addPolygon(Polygon *polygon) {
+    PolygonInstance instance = {
+      polygon->getCenterPt(),
+      polygon->getRadius(),
+      polygon->getRotation()
+    };
+    this->addInstance(polygon->getNumberOfSides(), polygon->getDrawingStyle(), instance);
+  }
+
+  /**
+   * @brief Queue a regular polygon for drawing without constructing a Polygon
+   *
+   * @param numberOfSides Side count, polygons with fewer than 1 side are ignored
+   * @param drawingStyle VERTEX_SHAPE draws the corners as points, LINE_SHAPE draws the outline, FILL_SHAPE fills it
+   * @param instance Center, radius and rotation of the polygon
+   */
+  void InstancedPolygonRenderer::addInstance(unsigned int numberOfSides, ShapeDrawingStyle drawingStyle, const PolygonInstance &instance) {
+    if (numberOfSides == 0) return;
+
+    InstanceGroup &group = this->groups[std::make_pair(numberOfSides, drawingStyle)];
+    group.instances.push_back(instance);
+    group.dirty = true;
+  }
+
+  /**
+   * @brief Drop every queued instance, the GPU buffers are kept for the next frame
+   */
+  void InstancedPolygonRenderer::clear() {
+    for (auto &[key, group] : this->groups) {
+      group.instances.clear();
+      group.dirty = true;
+    }
+  }
+
+  size_t InstancedPolygonRenderer::getInstanceCount() {
+    size_t count = 0;
+    for (auto &[key, group] : this->groups) count += group.instances.size();
+    return count;
+  }
+
+  /**
+   * @brief Stream a group's instances into its buffer, growing it geometrically and orphaning it otherwise
+   */
+  void InstancedPolygonRenderer::upload(InstanceGroup &group) {
+    if (group.VAO == 0) {
+      glGenVertexArrays(1, &group.VAO);
+      glGenBuffers(1, &group.VBO);
+
+      glBindVertexArray(group.VAO);
+      glBindBuffer(GL_ARRAY_BUFFER, group.VBO);
+
+      // one PolygonInstance is consumed per instance, not per vertex
+      glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(PolygonInstance), (void*) offsetof(PolygonInstance, centerPt));
+      glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(PolygonInstance), (void*) offsetof(PolygonInstance, radius));
+      glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(PolygonInstance), (void*) offsetof(PolygonInstance, rotation));
+      for (unsigned int attribute = 1; attribute <= 3; attribute++) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+      }
+    }
+
+    size_t n = group.instances.size();
+    glBindBuffer(GL_ARRAY_BUFFER, group.VBO);
+    if (n > group.capacity) {
+      group.capacity = std::max(n, group.capacity * 2);
+    }
+    glBufferData(GL_ARRAY_BUFFER, group.capacity * sizeof(PolygonInstance), NULL, GL_STREAM_DRAW);
+    if (n > 0) {
+      glBufferSubData(GL_ARRAY_BUFFER, 0, n * sizeof(PolygonInstance), group.instances.data());
+    }
+    group.dirty = false;
+  }
+
+  /**
+   * @brief Draw every queued polygon, one instanced draw per (side count, drawing style) group
+   *
+   * @param shaderProgram Program built from polygon_instanced.vert
+   */
+  void InstancedPolygonRenderer::draw(unsigned int shaderProgram) {
+    glUseProgram(shaderProgram);
+    GLint sidesLocation = glGetUniformLocation(shaderProgram, "uSides");
+
+    for (auto &[key, group] : this->groups) {
+      if (group.instances.empty()) continue;
+      if (group.dirty) this->upload(group);
+
+      auto [numberOfSides, drawingStyle] = key;
+      glUniform1ui(sidesLocation, numberOfSides);
+      glBindVertexArray(group.VAO);
+      if (drawingStyle == LINE_SHAPE) {
+        glDrawArraysInstanced(GL_LINE_LOOP, 0, numberOfSides, (GLsizei) group.instances.size());
+      } else if (drawingStyle == FILL_SHAPE) {
+        // regular polygons are convex, a fan over the corners covers them
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, numberOfSides, (GLsizei) group.instances.size());
+      } else {
+        glPointSize(10);
+        glDrawArraysInstanced(GL_POINTS, 0, numberOfSides, (GLsizei) group.instances.size());
+      }
+    }
+  }
+}
@@ -0,0 +1,56 @@
+#ifndef INSTANCED_RENDERER_HPP
+#define INSTANCED_RENDERER_HPP
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "graphics.hpp"
+#include "../2D/shapes.hpp"
+
+namespace Graphics {
+  /**
+   * @brief Everything the GPU needs to expand one regular polygon, 16 bytes regardless of the side count
+   */
+  struct PolygonInstance {
+    Vector2D centerPt;
+    float radius;
+    float rotation; // degrees
+  };
+
+  /**
+   * @brief Draws regular polygons from their (center, radius, rotation) parameters only. Instances are grouped
+   * by side count and drawing style, each group is one instanced draw whose vertices are generated in
+   * src/shaders/basic/polygon_instanced.vert from gl_VertexID
+   */
+  class InstancedPolygonRenderer {
+    public:
+      InstancedPolygonRenderer() {};
+      ~InstancedPolygonRenderer();
+      InstancedPolygonRenderer(const InstancedPolygonRenderer&) = delete;
+      InstancedPolygonRenderer &operator=(const InstancedPolygonRenderer&) = delete;
+
+      void addPolygon(Shapes::Polygon *polygon);
+      void addInstance(unsigned int numberOfSides, Shapes::ShapeDrawingStyle drawingStyle, const PolygonInstance &instance);
+      void clear();
+      void draw(unsigned int shaderProgram);
+
+      size_t getInstanceCount();
+    private:
+      /**
+       * @brief Instances sharing a side count and drawing style, with the buffer they are streamed into
+       */
+      struct InstanceGroup {
+        std::vector<PolygonInstance> instances;
+        unsigned int VAO = 0;
+        unsigned int VBO = 0;
+        size_t capacity = 0;
+        bool dirty = true;
+      };
+
+      std::map<std::pair<unsigned int, Shapes::ShapeDrawingStyle>, InstanceGroup> groups;
+
+      void upload(InstanceGroup &group);
+  };
+}
+
+#endif
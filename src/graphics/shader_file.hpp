@@ -0,0 +1,43 @@
+#ifndef SHADER_FILE_HPP
+#define SHADER_FILE_HPP
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace Graphics {
+  /**
+   * @brief Reads the contents of a shader file. Free of GL and SDL so headless tools and benchmarks can load
+   * shader sources without a context
+   *
+   * @param shader_file Path to file containing shader
+   * @return std::string Contents of shader file, empty if it is missing, unreadable, empty or over 64KiB
+   */
+  inline std::string readShaderFile(const char *shader_file) {
+    // no feedback is provided for stream errors / exceptions.
+    std::ifstream file(shader_file);
+    if (!file) return std::string ();
+
+    file.ignore(std::numeric_limits<std::streamsize>::max());
+    auto size = file.gcount();
+
+    if (size > 0x10000) // 64KiB sanity check for shaders:
+        return std::string ();
+
+    file.clear();
+    file.seekg(0, std::ios_base::beg);
+
+    std::stringstream sstr;
+    sstr << file.rdbuf();
+    sstr << "\0";
+    file.close();
+
+    // std::cout << sstr.str();
+
+    std::string shaderCode = sstr.str().c_str();
+    return shaderCode;
+  }
+}
+
+#endif
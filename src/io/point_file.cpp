@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#include "point_file.hpp"
+#include "../logging/logger.hpp"
+#include "../parallel/thread_pool.hpp"
+
+static_assert(sizeof(IO::PointFileHeader) == 64, "point file header must stay 64 bytes");
+static_assert(sizeof(IO::ChunkBounds) == 24, "chunk index entries must stay 24 bytes");
+static_assert(std::endian::native == std::endian::little, "point files are read and written in place, little endian");
+
+namespace IO {
+  // fewest points a task copies or scans, small enough to overlap page faults across workers
+  static const size_t POINTS_PER_TASK = 1 << 16;
+
+  static uint64_t alignUp(uint64_t offset) {
+    return (offset + Geometry::PointBuffer::ALIGNMENT - 1) & ~(uint64_t) (Geometry::PointBuffer::ALIGNMENT - 1);
+  }
+
+  static bool writeBytes(FILE *file, const void *data, size_t bytes, uint64_t &offset) {
+    offset += bytes;
+    return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+  }
+
+  static bool padTo(FILE *file, uint64_t target, uint64_t &offset) {
+    static const char zeros[Geometry::PointBuffer::ALIGNMENT] = {};
+    return writeBytes(file, zeros, (size_t) (target - offset), offset);
+  }
+
+  bool PointFile::write(const std::string &path, const Geometry::PointBuffer &points, uint64_t chunkSize) {
+    uint64_t count = points.size();
+    unsigned int dimensions = points.hasZ() ? 3 : 2;
+    const float *axes[3] = { points.x(), points.y(), points.z() };
+
+    PointFileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.dimensions = dimensions;
+    header.count = count;
+    header.chunkSize = count == 0 ? 0 : chunkSize;
+    uint64_t offset = alignUp(sizeof(PointFileHeader));
+    for (unsigned int axis = 0; axis < dimensions; axis++) {
+      header.axisOffsets[axis] = offset;
+      offset = alignUp(offset + count * sizeof(float));
+    }
+
+    std::vector<ChunkBounds> chunkIndex;
+    if (header.chunkSize > 0) {
+      header.chunkIndexOffset = offset;
+      chunkIndex.resize((size_t) ((count + chunkSize - 1) / chunkSize));
+      Parallel::parallelFor(0, chunkIndex.size(), std::max<size_t>(1, POINTS_PER_TASK / chunkSize), [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; c++) {
+          size_t begin = c * chunkSize, end = std::min<size_t>(count, begin + chunkSize);
+          ChunkBounds &bounds = chunkIndex[c];
+          for (unsigned int axis = 0; axis < 3; axis++) {
+            if (axis == dimensions) {
+              bounds.min[axis] = bounds.max[axis] = 0.0f;
+              break;
+            }
+            auto [low, high] = std::minmax_element(axes[axis] + begin, axes[axis] + end);
+            bounds.min[axis] = *low;
+            bounds.max[axis] = *high;
+          }
+        }
+      });
+    }
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == NULL) {
+      LOG_ERROR("IO", "POINT_FILE::CANNOT_CREATE %s", path.c_str());
+      return false;
+    }
+
+    offset = 0;
+    bool ok = writeBytes(file, &header, sizeof(header), offset);
+    for (unsigned int axis = 0; ok && axis < dimensions; axis++) {
+      ok = padTo(file, header.axisOffsets[axis], offset) && writeBytes(file, axes[axis], (size_t) count * sizeof(float), offset);
+    }
+    if (ok && !chunkIndex.empty()) {
+      ok = padTo(file, header.chunkIndexOffset, offset) && writeBytes(file, chunkIndex.data(), chunkIndex.size() * sizeof(ChunkBounds), offset);
+    }
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok) {
+      LOG_ERROR("IO", "POINT_FILE::WRITE_FAILED %s", path.c_str());
+      std::remove(path.c_str());
+    }
+    return ok;
+  }
+
+  MappedPointFile::MappedPointFile(MappedPointFile &&other) noexcept {
+    swap(*this, other);
+  }
+
+  MappedPointFile &MappedPointFile::operator=(MappedPointFile other) noexcept {
+    swap(*this, other);
+    return *this;
+  }
+
+  MappedPointFile::~MappedPointFile() {
+    this->close();
+  }
+
+  void swap(MappedPointFile &a, MappedPointFile &b) noexcept {
+    std::swap(a.mapping, b.mapping);
+    std::swap(a.mappedBytes, b.mappedBytes);
+    std::swap(a.xs, b.xs);
+    std::swap(a.ys, b.ys);
+    std::swap(a.zs, b.zs);
+    std::swap(a.count, b.count);
+    std::swap(a.chunkSize, b.chunkSize);
+    std::swap(a.chunkIndex, b.chunkIndex);
+  }
+
+  /**
+   * @brief Whether [offset, offset + bytes) lies inside a file of fileBytes, without overflowing
+   */
+  static bool fits(uint64_t offset, uint64_t bytes, uint64_t fileBytes) {
+    return offset <= fileBytes && bytes <= fileBytes - offset;
+  }
+
+  bool MappedPointFile::open(const std::string &path) {
+    this->close();
+
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+      LOG_ERROR("IO", "POINT_FILE::CANNOT_OPEN %s", path.c_str());
+      return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (uint64_t) status.st_size < sizeof(PointFileHeader)) {
+      LOG_ERROR("IO", "POINT_FILE::TRUNCATED %s", path.c_str());
+      ::close(descriptor);
+      return false;
+    }
+    uint64_t fileBytes = (uint64_t) status.st_size;
+
+    // the mapping outlives the descriptor, pages are read on first touch
+    void *mapping = mmap(NULL, (size_t) fileBytes, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+      LOG_ERROR("IO", "POINT_FILE::MMAP_FAILED %s", path.c_str());
+      return false;
+    }
+
+    PointFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const char *error = NULL;
+    if (std::memcmp(header.magic, PointFile::MAGIC, sizeof(header.magic)) != 0) {
+      error = "BAD_MAGIC";
+    } else if (header.version != PointFile::VERSION) {
+      error = "UNSUPPORTED_VERSION";
+    } else if (header.dimensions != 2 && header.dimensions != 3) {
+      error = "BAD_DIMENSIONS";
+    } else if (header.count > std::numeric_limits<uint64_t>::max() / sizeof(float)) {
+      error = "BAD_COUNT";
+    }
+    for (unsigned int axis = 0; error == NULL && axis < header.dimensions; axis++) {
+      if (header.axisOffsets[axis] % Geometry::PointBuffer::ALIGNMENT != 0 || !fits(header.axisOffsets[axis], header.count * sizeof(float), fileBytes)) {
+        error = "BAD_AXIS_OFFSET";
+      }
+    }
+    uint64_t chunkCount = header.chunkSize == 0 ? 0 : header.count / header.chunkSize + (header.count % header.chunkSize != 0);
+    if (error == NULL && chunkCount > 0) {
+      if (header.chunkIndexOffset % alignof(ChunkBounds) != 0 || !fits(header.chunkIndexOffset, chunkCount * sizeof(ChunkBounds), fileBytes)) {
+        error = "BAD_CHUNK_INDEX";
+      }
+    }
+    if (error != NULL) {
+      LOG_ERROR("IO", "POINT_FILE::%s %s", error, path.c_str());
+      munmap(mapping, (size_t) fileBytes);
+      return false;
+    }
+
+    const char *base = (const char *) mapping;
+    this->mapping = mapping;
+    this->mappedBytes = (size_t) fileBytes;
+    this->count = (size_t) header.count;
+    this->xs = (const float *) (base + header.axisOffsets[0]);
+    this->ys = (const float *) (base + header.axisOffsets[1]);
+    this->zs = header.dimensions == 3 ? (const float *) (base + header.axisOffsets[2]) : NULL;
+    this->chunkSize = (size_t) header.chunkSize;
+    this->chunkIndex = { (const ChunkBounds *) (base + header.chunkIndexOffset), (size_t) chunkCount };
+    return true;
+  }
+
+  void MappedPointFile::close() {
+    if (this->mapping != NULL) munmap(this->mapping, this->mappedBytes);
+    this->mapping = NULL;
+    this->mappedBytes = 0;
+    this->xs = this->ys = this->zs = NULL;
+    this->count = 0;
+    this->chunkSize = 0;
+    this->chunkIndex = {};
+  }
+
+  void MappedPointFile::prefetch(size_t first, size_t n) const {
+    if (this->mapping == NULL || first >= this->count) return;
+    n = std::min(n, this->count - first);
+    uintptr_t pageSize = (uintptr_t) sysconf(_SC_PAGESIZE);
+    for (const float *axis : { this->xs, this->ys, this->zs }) {
+      if (axis == NULL) continue;
+      uintptr_t begin = (uintptr_t) (axis + first) & ~(pageSize - 1);
+      uintptr_t end = (uintptr_t) (axis + first + n);
+      madvise((void *) begin, end - begin, MADV_WILLNEED);
+    }
+  }
+
+  void MappedPointFile::copyInterleaved(size_t first, size_t n, Vector2D *out) const {
+    Parallel::parallelFor(0, n, POINTS_PER_TASK, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) out[i] = { { this->xs[first + i], this->ys[first + i] } };
+    });
+  }
+
+  void MappedPointFile::copyInterleaved(size_t first, size_t n, Vector3D *out) const {
+    Parallel::parallelFor(0, n, POINTS_PER_TASK, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        out[i] = { { this->xs[first + i], this->ys[first + i], this->zs == NULL ? 0.0f : this->zs[first + i] } };
+      }
+    });
+  }
+
+  bool isPointFilePath(const std::string &path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".cgp") == 0;
+  }
+}
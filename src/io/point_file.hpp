@@ -0,0 +1,126 @@
+#ifndef POINT_FILE_HPP
+#define POINT_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include "../math/point_buffer.hpp"
+
+/**
+ * @brief Reading and writing point sets on disk
+ */
+namespace IO {
+  /**
+   * @brief Fixed 64 byte header at the start of a point file. All fields are little endian.
+   *
+   * Layout: header, then the x, y and (3D only) z coordinates as float arrays, each starting on a
+   * PointBuffer::ALIGNMENT boundary, then the optional chunk index. Offsets are in bytes from the start of
+   * the file, so readers never have to compute the layout themselves
+   */
+  struct PointFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t dimensions;
+    uint64_t count;
+    // points per chunk of the index, 0 when the file has no chunk index
+    uint64_t chunkSize;
+    uint64_t chunkIndexOffset;
+    uint64_t axisOffsets[3];
+  };
+
+  /**
+   * @brief Bounds of one chunkSize run of points, so spatial queries can skip chunks without paging their
+   * coordinates in. z is 0 in 2D files
+   */
+  struct ChunkBounds {
+    float min[3];
+    float max[3];
+  };
+
+  class PointFile {
+    public:
+      static constexpr char MAGIC[8] = { 'C', 'G', 'P', 'O', 'I', 'N', 'T', 'S' };
+      static const uint32_t VERSION = 1;
+      static const uint64_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+      /**
+       * @brief Write points in the point file format, replacing path
+       *
+       * @param chunkSize Points per chunk of the bounds index, 0 writes no index
+       * @return bool Whether the whole file was written, a partly written file is removed
+       */
+      static bool write(const std::string &path, const Geometry::PointBuffer &points, uint64_t chunkSize = DEFAULT_CHUNK_SIZE);
+  };
+
+  /**
+   * @brief Read-only memory mapping of a point file. Coordinates are used in place: opening only reads and
+   * checks the header, the pages holding points are loaded by the OS on first touch. Views stay valid until
+   * the file is closed
+   */
+  class MappedPointFile {
+    public:
+      MappedPointFile() {};
+      MappedPointFile(MappedPointFile &&other) noexcept;
+      MappedPointFile &operator=(MappedPointFile other) noexcept;
+      ~MappedPointFile();
+
+      MappedPointFile(const MappedPointFile &) = delete;
+
+      friend void swap(MappedPointFile &a, MappedPointFile &b) noexcept;
+
+      /**
+       * @brief Map path, closing the file currently open
+       *
+       * @return bool Whether the file exists and has a valid header whose arrays fit inside it
+       */
+      bool open(const std::string &path);
+      void close();
+      bool isOpen() const { return this->mapping != NULL; }
+
+      size_t size() const { return this->count; }
+      bool hasZ() const { return this->zs != NULL; }
+
+      std::span<const float> x() const { return { this->xs, this->count }; }
+      std::span<const float> y() const { return { this->ys, this->count }; }
+      std::span<const float> z() const { return { this->zs, this->zs == NULL ? 0 : this->count }; }
+
+      Geometry::PointIterator<Vector2D> begin2D() const { return Geometry::PointIterator<Vector2D>(this->xs, this->ys, this->zs, 0); }
+      Geometry::PointIterator<Vector2D> end2D() const { return Geometry::PointIterator<Vector2D>(this->xs, this->ys, this->zs, this->count); }
+      Geometry::PointIterator<Vector3D> begin3D() const { return Geometry::PointIterator<Vector3D>(this->xs, this->ys, this->zs, 0); }
+      Geometry::PointIterator<Vector3D> end3D() const { return Geometry::PointIterator<Vector3D>(this->xs, this->ys, this->zs, this->count); }
+
+      /**
+       * @brief Points per chunk of the index, 0 when the file has none
+       */
+      size_t getChunkSize() const { return this->chunkSize; }
+      std::span<const ChunkBounds> chunks() const { return this->chunkIndex; }
+
+      /**
+       * @brief Ask the OS to start reading points [first, first + n) in the background, ahead of a pass over them
+       */
+      void prefetch(size_t first, size_t n) const;
+
+      /**
+       * @brief Write points [first, first + n) interleaved, for algorithms that take Vector2D or Vector3D spans
+       */
+      void copyInterleaved(size_t first, size_t n, Vector2D *out) const;
+      void copyInterleaved(size_t first, size_t n, Vector3D *out) const;
+    private:
+      void *mapping = NULL;
+      size_t mappedBytes = 0;
+      const float *xs = NULL;
+      const float *ys = NULL;
+      const float *zs = NULL;
+      size_t count = 0;
+      size_t chunkSize = 0;
+      std::span<const ChunkBounds> chunkIndex;
+  };
+
+  /**
+   * @brief Whether path names a point file by its extension, ".cgp"
+   */
+  bool isPointFilePath(const std::string &path);
+}
+
+#endif
@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "text_point_reader.hpp"
+#include "../logging/logger.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace IO {
+  // fewest bytes of text worth a task of their own
+  static const size_t MIN_BYTES_PER_TASK = 1 << 20;
+  // pieces per thread, so a piece that parses slowly does not hold up the others
+  static const unsigned int PIECES_PER_THREAD = 4;
+
+  enum RecordKind {
+    NO_RECORD, VERTEX_RECORD, FACE_RECORD
+  };
+
+  /**
+   * @brief Where records start and how they map to vertices, worked out from the header before the parallel passes
+   */
+  struct Layout {
+    TextFormat format;
+    size_t dataStart = 0;
+    bool hasZ = false;
+    // CSV and XYZ column count, or properties per PLY vertex line
+    unsigned int columns = 0;
+    // PLY property index of x, y and z
+    unsigned int axisProperty[3] = { 0, 1, 2 };
+    // PLY records of the vertex and face elements, and of all elements together
+    size_t vertexFirstRecord = 0;
+    size_t vertexCount = 0;
+    size_t faceFirstRecord = 0;
+    size_t faceCount = 0;
+    size_t recordCount = 0;
+  };
+
+  /**
+   * @brief Run of whole lines parsed by one task
+   */
+  struct Piece {
+    const char *begin;
+    const char *end;
+    size_t records = 0;
+    size_t vertices = 0;
+    // records and vertices in every piece before this one
+    size_t firstRecord = 0;
+    size_t firstVertex = 0;
+    std::vector<uint32_t> triangles;
+    // start of the first line that failed to parse, and why
+    const char *errorLine = NULL;
+    const char *error = NULL;
+  };
+
+  static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  static bool isSeparator(char c) {
+    return isBlank(c) || c == ',' || c == ';';
+  }
+
+  static const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p)) p++;
+    return p;
+  }
+
+  static const char *skipSeparators(const char *p, const char *end) {
+    while (p < end && isSeparator(*p)) p++;
+    return p;
+  }
+
+  static const char *lineEnd(const char *p, const char *end) {
+    const char *newline = (const char *) std::memchr(p, '\n', (size_t) (end - p));
+    return newline == NULL ? end : newline;
+  }
+
+  /**
+   * @brief Parse the number at p and move p past it. from_chars takes no leading '+', so it is skipped here.
+   * The number must be followed by a separator or the end of the line
+   */
+  template <typename Number>
+  static bool parseNumber(const char *&p, const char *end, Number &value) {
+    const char *start = p < end && *p == '+' ? p + 1 : p;
+    std::from_chars_result result = std::from_chars(start, end, value);
+    if (result.ec != std::errc() || (result.ptr < end && !isSeparator(*result.ptr))) return false;
+    p = result.ptr;
+    return true;
+  }
+
+  /**
+   * @brief What the line starting at p holds, p is past the leading blanks and any statement keyword
+   */
+  static RecordKind classifyLine(const Layout &layout, const char *&p, const char *end, size_t record) {
+    p = skipBlanks(p, end);
+    if (p == end) return NO_RECORD;
+
+    switch (layout.format) {
+      case OBJ_FORMAT:
+        if (end - p >= 2 && (p[0] == 'v' || p[0] == 'f') && isBlank(p[1])) {
+          RecordKind kind = p[0] == 'v' ? VERTEX_RECORD : FACE_RECORD;
+          p += 2;
+          return kind;
+        }
+        return NO_RECORD;
+      case PLY_FORMAT:
+        if (record - layout.vertexFirstRecord < layout.vertexCount) return VERTEX_RECORD;
+        if (record - layout.faceFirstRecord < layout.faceCount) return FACE_RECORD;
+        // lines of other elements still count as records
+        return NO_RECORD;
+      default:
+        return *p == '#' ? NO_RECORD : VERTEX_RECORD;
+    }
+  }
+
+  static bool isRecordLine(const Layout &layout, const char *p, const char *end) {
+    p = skipBlanks(p, end);
+    if (p == end) return false;
+    if (layout.format == PLY_FORMAT) return true;
+    return classifyLine(layout, p, end, 0) != NO_RECORD;
+  }
+
+  /**
+   * @brief Count the numeric columns of the line at p, stopping at the first field that is not a number
+   */
+  static unsigned int countColumns(const char *p, const char *end) {
+    unsigned int columns = 0;
+    for (p = skipSeparators(p, end); p < end; p = skipSeparators(p, end)) {
+      float value;
+      if (!parseNumber(p, end, value)) break;
+      columns++;
+    }
+    return columns;
+  }
+
+  /**
+   * @brief CSV and XYZ: find the column count from the first data line, skipping a header line of column names
+   */
+  static const char *readColumnLayout(std::string_view text, Layout &layout) {
+    const char *begin = text.data(), *end = text.data() + text.size();
+    bool headerAllowed = true;
+    for (const char *line = begin; line < end;) {
+      const char *eol = lineEnd(line, end);
+      const char *p = line;
+      if (classifyLine(layout, p, eol, 0) == VERTEX_RECORD) {
+        unsigned int columns = countColumns(p, eol);
+        if (columns == 0 && headerAllowed) {
+          headerAllowed = false;
+          layout.dataStart = (size_t) (eol - begin) + (eol < end);
+        } else {
+          if (columns < 2) return "NOT_ENOUGH_COLUMNS";
+          layout.columns = columns;
+          layout.hasZ = columns >= 3;
+          return NULL;
+        }
+      }
+      line = eol + 1;
+    }
+    return NULL;
+  }
+
+  /**
+   * @brief PLY: read the header up to end_header, locating the vertex and face elements and the x, y, z properties
+   */
+  static const char *readPlyHeader(std::string_view text, Layout &layout) {
+    const char *begin = text.data(), *end = text.data() + text.size();
+    enum { OTHER_ELEMENT, VERTEX_ELEMENT, FACE_ELEMENT } element = OTHER_ELEMENT;
+    bool foundAxis[3] = { false, false, false };
+    bool firstLine = true;
+
+    for (const char *line = begin; line < end;) {
+      const char *eol = lineEnd(line, end);
+      std::vector<std::string_view> words;
+      for (const char *p = skipBlanks(line, eol); p < eol; p = skipBlanks(p, eol)) {
+        const char *wordEnd = p;
+        while (wordEnd < eol && !isBlank(*wordEnd)) wordEnd++;
+        words.emplace_back(p, (size_t) (wordEnd - p));
+        p = wordEnd;
+      }
+      line = eol + 1;
+
+      if (firstLine) {
+        if (words.size() != 1 || words[0] != "ply") return "NOT_PLY";
+        firstLine = false;
+      } else if (words.empty() || words[0] == "comment" || words[0] == "obj_info") {
+        continue;
+      } else if (words[0] == "format") {
+        if (words.size() < 2 || words[1] != "ascii") return "ONLY_ASCII_PLY";
+      } else if (words[0] == "element" && words.size() == 3) {
+        size_t count = 0;
+        std::from_chars(words[2].data(), words[2].data() + words[2].size(), count);
+        element = words[1] == "vertex" ? VERTEX_ELEMENT : words[1] == "face" ? FACE_ELEMENT : OTHER_ELEMENT;
+        if (element == VERTEX_ELEMENT) {
+          layout.vertexFirstRecord = layout.recordCount;
+          layout.vertexCount = count;
+        } else if (element == FACE_ELEMENT) {
+          layout.faceFirstRecord = layout.recordCount;
+          layout.faceCount = count;
+        }
+        layout.recordCount += count;
+      } else if (words[0] == "property" && words.size() >= 3) {
+        if (element != VERTEX_ELEMENT) continue;
+        if (words[1] == "list") return "LIST_VERTEX_PROPERTY";
+        static const std::string_view AXIS_NAMES[3] = { "x", "y", "z" };
+        for (unsigned int axis = 0; axis < 3; axis++) {
+          if (words[2] == AXIS_NAMES[axis]) {
+            layout.axisProperty[axis] = layout.columns;
+            foundAxis[axis] = true;
+          }
+        }
+        layout.columns++;
+      } else if (words[0] == "end_header") {
+        if (layout.vertexCount > 0 && (!foundAxis[0] || !foundAxis[1])) return "NO_XY_PROPERTIES";
+        layout.hasZ = foundAxis[2];
+        layout.dataStart = (size_t) (std::min(line, end) - begin);
+        return NULL;
+      }
+    }
+    return "NO_END_HEADER";
+  }
+
+  /**
+   * @brief Add the fan of the polygon with the given corners to triangles
+   */
+  static void addFan(std::vector<uint32_t> &triangles, const uint32_t *corners, size_t count) {
+    for (size_t i = 1; i + 1 < count; i++) {
+      triangles.push_back(corners[0]);
+      triangles.push_back(corners[i]);
+      triangles.push_back(corners[i + 1]);
+    }
+  }
+
+  static const char *parseVertex(const Layout &layout, const char *p, const char *end, Geometry::PointBuffer &points, size_t vertex) {
+    float coordinates[3] = { 0.0f, 0.0f, 0.0f };
+    if (layout.format == PLY_FORMAT) {
+      for (unsigned int property = 0; property < layout.columns; property++) {
+        p = skipBlanks(p, end);
+        if (p == end) return "MISSING_PROPERTY";
+        unsigned int axis = 0;
+        while (axis < 3 && layout.axisProperty[axis] != property) axis++;
+        if (axis < 3 && !parseNumber(p, end, coordinates[axis])) return "BAD_NUMBER";
+        while (p < end && !isBlank(*p)) p++;
+      }
+    } else {
+      // OBJ vertices are 3D, a missing z reads as 0
+      unsigned int needed = layout.format == OBJ_FORMAT ? 2 : (layout.hasZ ? 3 : 2);
+      unsigned int available = layout.format == OBJ_FORMAT ? 3 : needed;
+      for (unsigned int axis = 0; axis < available; axis++) {
+        p = skipSeparators(p, end);
+        if (p == end) {
+          if (axis < needed) return "MISSING_COORDINATE";
+          break;
+        }
+        if (!parseNumber(p, end, coordinates[axis])) return "BAD_NUMBER";
+      }
+    }
+
+    points.x()[vertex] = coordinates[0];
+    points.y()[vertex] = coordinates[1];
+    if (points.hasZ()) points.z()[vertex] = coordinates[2];
+    return NULL;
+  }
+
+  /**
+   * @brief Face corners, PLY "n i0 i1 ..." or OBJ "i0/t0/n0 i1 ..." with 1-based or negative, relative indices
+   *
+   * @param definedVertices OBJ vertices defined before this line, which negative indices count back from
+   */
+  static const char *parseFace(const Layout &layout, const char *p, const char *end, size_t definedVertices, size_t vertexCount, std::vector<uint32_t> &corners) {
+    corners.clear();
+    size_t expected = 0;
+    if (layout.format == PLY_FORMAT && !parseNumber(p, end, expected)) return "BAD_FACE";
+
+    for (p = skipBlanks(p, end); p < end; p = skipBlanks(p, end)) {
+      int64_t index;
+      std::from_chars_result result = std::from_chars(p, end, index);
+      if (result.ec != std::errc()) return "BAD_FACE";
+      p = result.ptr;
+      if (layout.format == OBJ_FORMAT) {
+        // texture and normal indices after '/' are not used
+        while (p < end && !isBlank(*p)) p++;
+        if (index == 0) return "BAD_FACE";
+        index = index > 0 ? index - 1 : (int64_t) definedVertices + index;
+      }
+      if (index < 0 || (uint64_t) index >= vertexCount) return "FACE_INDEX_OUT_OF_RANGE";
+      corners.push_back((uint32_t) index);
+    }
+
+    if (corners.size() < 3 || (layout.format == PLY_FORMAT && corners.size() != expected)) return "BAD_FACE";
+    return NULL;
+  }
+
+  /**
+   * @brief First pass: count records and vertices of a piece, which fixes where its vertices go
+   */
+  static void countPiece(const Layout &layout, Piece &piece) {
+    for (const char *line = piece.begin; line < piece.end;) {
+      const char *eol = lineEnd(line, piece.end);
+      const char *p = line;
+      if (isRecordLine(layout, line, eol)) {
+        piece.records++;
+        if (layout.format != PLY_FORMAT && classifyLine(layout, p, eol, 0) == VERTEX_RECORD) piece.vertices++;
+      }
+      line = eol + 1;
+    }
+  }
+
+  /**
+   * @brief Second pass: parse the records of a piece into their slots
+   */
+  static void parsePiece(const Layout &layout, Piece &piece, Geometry::PointBuffer &points, bool withFaces) {
+    size_t record = piece.firstRecord;
+    size_t vertex = piece.firstVertex;
+    std::vector<uint32_t> corners;
+
+    for (const char *line = piece.begin; line < piece.end && piece.error == NULL;) {
+      const char *eol = lineEnd(line, piece.end);
+      if (isRecordLine(layout, line, eol)) {
+        const char *p = line;
+        RecordKind kind = classifyLine(layout, p, eol, record);
+        const char *error = NULL;
+        if (kind == VERTEX_RECORD) {
+          size_t slot = layout.format == PLY_FORMAT ? record - layout.vertexFirstRecord : vertex;
+          error = parseVertex(layout, p, eol, points, slot);
+          vertex++;
+        } else if (kind == FACE_RECORD && withFaces) {
+          error = parseFace(layout, p, eol, vertex, points.size(), corners);
+          if (error == NULL) addFan(piece.triangles, corners.data(), corners.size());
+        }
+        if (error != NULL) {
+          piece.error = error;
+          piece.errorLine = line;
+        }
+        record++;
+      }
+      line = eol + 1;
+    }
+  }
+
+  bool TextPointReader::parse(std::string_view text, TextFormat format, Geometry::PointBuffer &points, std::vector<uint32_t> *triangles) {
+    Layout layout;
+    layout.format = format;
+    const char *error = format == PLY_FORMAT ? readPlyHeader(text, layout) : format == OBJ_FORMAT ? NULL : readColumnLayout(text, layout);
+    if (format == OBJ_FORMAT) layout.hasZ = true;
+    if (error != NULL) {
+      LOG_ERROR("IO", "TEXT_READER::%s in header", error);
+      return false;
+    }
+
+    // cut the records into pieces that end on a newline
+    const char *begin = text.data() + layout.dataStart, *end = text.data() + text.size();
+    size_t bytes = (size_t) (end - begin);
+    unsigned int threads = Parallel::chunkCount(bytes, 0, MIN_BYTES_PER_TASK);
+    unsigned int pieceCount = threads == 1 ? 1 : Parallel::chunkCount(bytes, threads * PIECES_PER_THREAD, MIN_BYTES_PER_TASK);
+    std::vector<Piece> pieces(pieceCount);
+    const char *cursor = begin;
+    for (unsigned int i = 0; i < pieceCount; i++) {
+      const char *split = i + 1 == pieceCount ? end : std::max(cursor, begin + bytes * (i + 1) / pieceCount);
+      if (split < end) split = std::min(end, lineEnd(split, end) + 1);
+      pieces[i].begin = cursor;
+      pieces[i].end = split;
+      cursor = split;
+    }
+
+    Parallel::parallelFor(0, pieces.size(), 1, [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; i++) countPiece(layout, pieces[i]);
+    });
+    size_t records = 0, vertices = 0;
+    for (Piece &piece : pieces) {
+      piece.firstRecord = records;
+      piece.firstVertex = vertices;
+      records += piece.records;
+      vertices += piece.vertices;
+    }
+    if (format == PLY_FORMAT) {
+      if (records < layout.recordCount) {
+        LOG_ERROR("IO", "TEXT_READER::TRUNCATED %zu of %zu PLY records", records, layout.recordCount);
+        return false;
+      }
+      vertices = layout.vertexCount;
+    }
+
+    points = Geometry::PointBuffer(layout.hasZ);
+    points.resize(vertices);
+    Parallel::parallelFor(0, pieces.size(), 1, [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; i++) parsePiece(layout, pieces[i], points, triangles != NULL);
+    });
+
+    for (const Piece &piece : pieces) {
+      if (piece.error == NULL) continue;
+      size_t line = 1 + (size_t) std::count(text.data(), piece.errorLine, '\n');
+      LOG_ERROR("IO", "TEXT_READER::%s on line %zu", piece.error, line);
+      return false;
+    }
+
+    if (triangles != NULL) {
+      triangles->clear();
+      size_t total = 0;
+      for (const Piece &piece : pieces) total += piece.triangles.size();
+      triangles->reserve(total);
+      for (const Piece &piece : pieces) triangles->insert(triangles->end(), piece.triangles.begin(), piece.triangles.end());
+    }
+    return true;
+  }
+
+  bool TextPointReader::read(const std::string &path, Geometry::PointBuffer &points, std::vector<uint32_t> *triangles, TextFormat format) {
+    if (format == AUTO_FORMAT) format = formatOf(path);
+
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+      LOG_ERROR("IO", "TEXT_READER::CANNOT_OPEN %s", path.c_str());
+      if (descriptor >= 0) ::close(descriptor);
+      return false;
+    }
+    size_t bytes = (size_t) status.st_size;
+    if (bytes == 0) {
+      ::close(descriptor);
+      return parse(std::string_view(), format, points, triangles);
+    }
+
+    void *mapping = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+      LOG_ERROR("IO", "TEXT_READER::MMAP_FAILED %s", path.c_str());
+      return false;
+    }
+    // each piece is read front to back
+    madvise(mapping, bytes, MADV_SEQUENTIAL);
+    bool ok = parse(std::string_view((const char *) mapping, bytes), format, points, triangles);
+    munmap(mapping, bytes);
+    if (!ok) LOG_ERROR("IO", "TEXT_READER::PARSE_FAILED %s", path.c_str());
+    return ok;
+  }
+
+  TextFormat TextPointReader::formatOf(const std::string &path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos) return XYZ_FORMAT;
+    std::string extension = path.substr(dot + 1);
+    for (char &c : extension) c = (char) std::tolower((unsigned char) c);
+    if (extension == "csv") return CSV_FORMAT;
+    if (extension == "ply") return PLY_FORMAT;
+    if (extension == "obj") return OBJ_FORMAT;
+    return XYZ_FORMAT;
+  }
+}
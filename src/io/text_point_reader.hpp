@@ -0,0 +1,54 @@
+#ifndef TEXT_POINT_READER_HPP
+#define TEXT_POINT_READER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../math/point_buffer.hpp"
+
+namespace IO {
+  enum TextFormat {
+    // picked from the file extension, XYZ when it is not one of the others
+    AUTO_FORMAT,
+    // x, y and optional z columns split by commas, semicolons or whitespace, one point per line. The first
+    // line may be a header of column names
+    CSV_FORMAT,
+    // same columns split by whitespace, one point per line
+    XYZ_FORMAT,
+    // ASCII PLY: vertex x, y and z properties wherever they are declared, faces as vertex index lists
+    PLY_FORMAT,
+    // Wavefront OBJ "v" and "f" lines, other statements are skipped
+    OBJ_FORMAT
+  };
+
+  /**
+   * @brief Parallel parser for text point and mesh files. The text is cut into pieces at line boundaries and
+   * every piece is parsed on the global thread pool with std::from_chars: a first pass counts each piece's
+   * records, so the second pass writes coordinates straight into their final slots of the PointBuffer
+   */
+  class TextPointReader {
+    public:
+      /**
+       * @brief Map path and parse it
+       *
+       * @param points Replaced by the vertices, 3D when the file has z coordinates
+       * @param triangles When not NULL, replaced by the faces of PLY and OBJ files as vertex index triples,
+       * polygons are split into fans
+       * @return bool Whether the file was read and every record parsed, errors are logged with their line
+       */
+      static bool read(const std::string &path, Geometry::PointBuffer &points, std::vector<uint32_t> *triangles = NULL, TextFormat format = AUTO_FORMAT);
+
+      /**
+       * @brief Parse text already in memory, with the same output as read(). format must not be AUTO_FORMAT
+       */
+      static bool parse(std::string_view text, TextFormat format, Geometry::PointBuffer &points, std::vector<uint32_t> *triangles = NULL);
+
+      /**
+       * @brief Format named by the extension of path, case insensitive
+       */
+      static TextFormat formatOf(const std::string &path);
+  };
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include "logger.hpp"
+
+namespace Logging {
+  static const char *levelName(LogLevel level) {
+    switch (level) {
+      case TRACE_LEVEL: return "TRACE";
+      case DEBUG_LEVEL: return "DEBUG";
+      case INFO_LEVEL: return "INFO";
+      case WARN_LEVEL: return "WARN";
+      case ERROR_LEVEL: return "ERROR";
+    }
+    return "";
+  }
+
+  Logger::Logger() : enqueuePos(0), dequeuePos(0), dropped(0), running(true), synchronous(false) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+      this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    this->drainThread = std::thread(&Logger::drainLoop, this);
+    std::atexit(&Logger::shutdown);
+  }
+
+  /**
+   * @brief The logger is never destroyed, so destructors of other statics and threads still running at exit
+   * can keep logging after it would otherwise be gone
+   */
+  Logger &Logger::instance() {
+    static Logger *logger = new Logger();
+    return *logger;
+  }
+
+  /**
+   * @brief At exit: stop the background thread, print whatever is queued and switch later messages to
+   * synchronous printing
+   */
+  void Logger::shutdown() {
+    Logger &logger = instance();
+    logger.synchronous.store(true, std::memory_order_seq_cst);
+    logger.running.store(false, std::memory_order_release);
+    logger.drainThread.join();
+    // messages whose slot was claimed before the switch are published shortly
+    size_t target = logger.enqueuePos.load(std::memory_order_acquire);
+    while (logger.dequeuePos.load(std::memory_order_relaxed) < target) {
+      if (!logger.drainOne()) std::this_thread::yield();
+    }
+    std::fflush(stdout);
+  }
+
+  /**
+   * @brief Bounded multi-producer queue after Vyukov: each slot's sequence number tells producers
+   * whether it is free for the current lap and tells the consumer whether it has been published
+   */
+  void Logger::write(LogLevel level, const char *category, const char *format, ...) {
+    Logger &logger = instance();
+
+    if (logger.synchronous.load(std::memory_order_seq_cst)) {
+      char message[MESSAGE_SIZE];
+      va_list args;
+      va_start(args, format);
+      std::vsnprintf(message, MESSAGE_SIZE, format, args);
+      va_end(args);
+      std::fprintf(stdout, "[%s][%s] %s\n", levelName(level), category, message);
+      std::fflush(stdout);
+      return;
+    }
+
+    Slot *slot;
+    size_t pos = logger.enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+      slot = &logger.slots[pos & (CAPACITY - 1)];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t) sequence - (intptr_t) pos;
+      if (difference == 0) {
+        if (logger.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (difference < 0) {
+        // consumer is a full lap behind
+        logger.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        pos = logger.enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->level = level;
+    slot->category = category;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->message, MESSAGE_SIZE, format, args);
+    va_end(args);
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Print the oldest published message, if any
+   *
+   * @return bool Whether a message was printed
+   */
+  bool Logger::drainOne() {
+    size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+    Slot &slot = this->slots[pos & (CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+
+    std::fprintf(stdout, "[%s][%s] %s\n", levelName(slot.level), slot.category, slot.message);
+
+    slot.sequence.store(pos + CAPACITY, std::memory_order_release);
+    this->dequeuePos.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  void Logger::drainLoop() {
+    while (this->running.load(std::memory_order_acquire)) {
+      bool printed = false;
+      while (this->drainOne()) printed = true;
+      if (printed) {
+        std::fflush(stdout);
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  void Logger::flush() {
+    Logger &logger = instance();
+    if (logger.synchronous.load(std::memory_order_acquire)) return;
+    size_t target = logger.enqueuePos.load(std::memory_order_acquire);
+    while (logger.dequeuePos.load(std::memory_order_acquire) < target) {
+      std::this_thread::yield();
+    }
+    std::fflush(stdout);
+  }
+
+  uint64_t Logger::getDroppedCount() {
+    return instance().dropped.load(std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,118 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+// severity levels, COMPGEOM_LOG_LEVEL picks the lowest one compiled in
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF   5
+
+#ifndef COMPGEOM_LOG_LEVEL
+  # define COMPGEOM_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// log sites below the compile-time level expand to nothing, their arguments are never evaluated
+#if COMPGEOM_LOG_LEVEL <= LOG_LEVEL_TRACE
+  # define LOG_TRACE(category, ...) ::Logging::Logger::write(::Logging::TRACE_LEVEL, category, __VA_ARGS__)
+#else
+  # define LOG_TRACE(category, ...) ((void) 0)
+#endif
+
+#if COMPGEOM_LOG_LEVEL <= LOG_LEVEL_DEBUG
+  # define LOG_DEBUG(category, ...) ::Logging::Logger::write(::Logging::DEBUG_LEVEL, category, __VA_ARGS__)
+#else
+  # define LOG_DEBUG(category, ...) ((void) 0)
+#endif
+
+#if COMPGEOM_LOG_LEVEL <= LOG_LEVEL_INFO
+  # define LOG_INFO(category, ...) ::Logging::Logger::write(::Logging::INFO_LEVEL, category, __VA_ARGS__)
+#else
+  # define LOG_INFO(category, ...) ((void) 0)
+#endif
+
+#if COMPGEOM_LOG_LEVEL <= LOG_LEVEL_WARN
+  # define LOG_WARN(category, ...) ::Logging::Logger::write(::Logging::WARN_LEVEL, category, __VA_ARGS__)
+#else
+  # define LOG_WARN(category, ...) ((void) 0)
+#endif
+
+#if COMPGEOM_LOG_LEVEL <= LOG_LEVEL_ERROR
+  # define LOG_ERROR(category, ...) ::Logging::Logger::write(::Logging::ERROR_LEVEL, category, __VA_ARGS__)
+#else
+  # define LOG_ERROR(category, ...) ((void) 0)
+#endif
+
+/**
+ * @brief Leveled logging for the Shapes and Graphics namespaces. Callers format into a lock-free ring buffer,
+ * a background thread drains it to stdout so log sites never block on I/O
+ */
+namespace Logging {
+  // suffixed so platform macros such as DEBUG and ERROR cannot rewrite them
+  enum LogLevel {
+    TRACE_LEVEL = LOG_LEVEL_TRACE,
+    DEBUG_LEVEL = LOG_LEVEL_DEBUG,
+    INFO_LEVEL = LOG_LEVEL_INFO,
+    WARN_LEVEL = LOG_LEVEL_WARN,
+    ERROR_LEVEL = LOG_LEVEL_ERROR
+  };
+
+  class Logger {
+    public:
+      // ring buffer slots, must be a power of two
+      static const size_t CAPACITY = 2048;
+      // longest message kept, longer ones are truncated
+      static const size_t MESSAGE_SIZE = 488;
+
+      /**
+       * @brief Format a message into the ring buffer, dropping it if the buffer is full
+       *
+       * @param level Severity of the message
+       * @param category Subsystem name, must outlive the logger (a string literal)
+       * @param format printf style format string
+       */
+      static void write(LogLevel level, const char *category, const char *format, ...)
+        __attribute__((format(printf, 3, 4)));
+
+      /**
+       * @brief Block until every message written so far has been printed
+       */
+      static void flush();
+
+      /**
+       * @brief Number of messages dropped because the ring buffer was full
+       */
+      static uint64_t getDroppedCount();
+    private:
+      struct Slot {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        const char *category;
+        char message[MESSAGE_SIZE];
+      };
+
+      Slot slots[CAPACITY];
+      alignas(64) std::atomic<size_t> enqueuePos;
+      alignas(64) std::atomic<size_t> dequeuePos;
+      std::atomic<uint64_t> dropped;
+      std::atomic<bool> running;
+      // set at exit once the drain thread is gone, later messages are printed by their caller
+      std::atomic<bool> synchronous;
+      std::thread drainThread;
+
+      Logger();
+      static Logger &instance();
+      static void shutdown();
+
+      bool drainOne();
+      void drainLoop();
+  };
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+#if defined(__x86_64__)
+  # define COMPGEOM_X86 1
+#endif
+
+namespace Geometry {
+  /**
+   * @brief Instruction sets a kernel can be dispatched to, ordered from slowest to fastest
+   */
+  enum SimdLevel {
+    SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2
+  };
+
+  class CpuFeatures {
+    public:
+      /**
+       * @brief Widest vector instruction set the running CPU supports, queried once via CPUID
+       *
+       * @return SimdLevel SIMD_SCALAR on non-x86 targets
+       */
+      static SimdLevel detectSimdLevel() {
+        static const SimdLevel level = queryCpuid();
+        return level;
+      }
+
+      /**
+       * @brief Whether BMI2 (pdep/pext) is available
+       */
+      static bool hasBMI2() {
+#ifdef COMPGEOM_X86
+        static const bool bmi2 = __builtin_cpu_supports("bmi2");
+        return bmi2;
+#else
+        return false;
+#endif
+      }
+
+      static const char *simdLevelName(SimdLevel level) {
+        switch (level) {
+          case SIMD_SCALAR: return "scalar";
+          case SIMD_SSE2: return "sse2";
+          case SIMD_AVX2: return "avx2";
+        }
+        return "";
+      }
+    private:
+      static SimdLevel queryCpuid() {
+#ifdef COMPGEOM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SIMD_AVX2;
+        if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+        return SIMD_SCALAR;
+      }
+  };
+}
+
+#endif
@@ -6,6 +6,9 @@
   # define M_PI           3.14159265358979323846
 #endif
 
+#include <cmath>
+#include "../vectors.hpp"
+
 /**
  * @brief Lightweight math alternative library (for fun)
  */
@@ -22,6 +25,54 @@ namespace Geometry {
         return (M_PI / 180.0f) * angle;
       }
   };
+
+  class RegularPolygons {
+    public:
+      // the unit rotor is pulled back onto the unit circle every this many steps
+      static const unsigned int RENORMALIZE_INTERVAL = 64;
+
+      /**
+       * @brief Generate the vertices of a regular polygon without per-vertex trig. The rotation step is computed
+       * once and a unit rotor is advanced by complex multiplication, in double precision so the phase error after
+       * 10^7 steps stays far below float resolution. The rotor length is re-normalized periodically to bound drift.
+       *
+       * @param centerPt Center of the circle bounding the polygon
+       * @param radius Radius of the circle bounding the polygon
+       * @param n Number of vertices
+       * @param startAngle Angle of the first vertex in degrees, counterclockwise from the x-axis
+       * @param vertices Caller-provided storage for n vertices
+       */
+      static void generateVertices(Vector2D centerPt, float radius, unsigned int n, float startAngle, Vector2D *vertices) {
+        if (n == 0) return;
+
+        const double step = 2.0 * M_PI / n;
+        const double stepCos = std::cos(step);
+        const double stepSin = std::sin(step);
+        const double start = (M_PI / 180.0) * startAngle;
+
+        double rotorCos = std::cos(start);
+        double rotorSin = std::sin(start);
+        const double centerX = centerPt.vector[0];
+        const double centerY = centerPt.vector[1];
+
+        for (unsigned int i = 0; i < n; i++) {
+          vertices[i].vector[0] = (float) (centerX + radius * rotorCos);
+          vertices[i].vector[1] = (float) (centerY + radius * rotorSin);
+
+          // rotor *= e^(i * step)
+          double nextCos = rotorCos * stepCos - rotorSin * stepSin;
+          rotorSin = rotorCos * stepSin + rotorSin * stepCos;
+          rotorCos = nextCos;
+
+          if (i % RENORMALIZE_INTERVAL == RENORMALIZE_INTERVAL - 1) {
+            // one Newton step of 1 / sqrt(|rotor|^2), exact enough since |rotor| is already ~1
+            double scale = 1.5 - 0.5 * (rotorCos * rotorCos + rotorSin * rotorSin);
+            rotorCos *= scale;
+            rotorSin *= scale;
+          }
+        }
+      }
+  };
 }
 
 #endif
\ No newline at end of file
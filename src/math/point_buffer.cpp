@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "cpu_features.hpp"
+#include "point_buffer.hpp"
+
+#ifdef COMPGEOM_X86
+  # include <immintrin.h>
+#endif
+
+namespace Geometry {
+  static float *allocateAligned(size_t n) {
+    if (n == 0) return NULL;
+    // round up so full-width loads of the last block never leave the allocation
+    size_t bytes = (n * sizeof(float) + PointBuffer::ALIGNMENT - 1) & ~(PointBuffer::ALIGNMENT - 1);
+    return (float *) ::operator new(bytes, std::align_val_t(PointBuffer::ALIGNMENT));
+  }
+
+  static void freeAligned(float *p) {
+    if (p != NULL) ::operator delete(p, std::align_val_t(PointBuffer::ALIGNMENT));
+  }
+
+  PointBuffer::PointBuffer(const Vector2D *points, size_t n) : withZ(false) {
+    this->assign(points, n);
+  }
+
+  PointBuffer::PointBuffer(const Vector3D *points, size_t n) : withZ(true) {
+    this->assign(points, n);
+  }
+
+  PointBuffer::PointBuffer(const PointBuffer &other) : withZ(other.withZ) {
+    this->reallocate(other.count);
+    this->count = other.count;
+    if (this->count == 0) return;
+    std::memcpy(this->xs, other.xs, this->count * sizeof(float));
+    std::memcpy(this->ys, other.ys, this->count * sizeof(float));
+    if (this->withZ) std::memcpy(this->zs, other.zs, this->count * sizeof(float));
+  }
+
+  PointBuffer::PointBuffer(PointBuffer &&other) noexcept {
+    swap(*this, other);
+  }
+
+  PointBuffer &PointBuffer::operator=(PointBuffer other) noexcept {
+    swap(*this, other);
+    return *this;
+  }
+
+  PointBuffer::~PointBuffer() {
+    freeAligned(this->xs);
+    freeAligned(this->ys);
+    freeAligned(this->zs);
+  }
+
+  void swap(PointBuffer &a, PointBuffer &b) noexcept {
+    std::swap(a.xs, b.xs);
+    std::swap(a.ys, b.ys);
+    std::swap(a.zs, b.zs);
+    std::swap(a.count, b.count);
+    std::swap(a.allocated, b.allocated);
+    std::swap(a.withZ, b.withZ);
+  }
+
+  void PointBuffer::reallocate(size_t newCapacity) {
+    float *newXs = allocateAligned(newCapacity);
+    float *newYs = allocateAligned(newCapacity);
+    float *newZs = this->withZ ? allocateAligned(newCapacity) : NULL;
+
+    size_t kept = std::min(this->count, newCapacity);
+    if (kept > 0) {
+      std::memcpy(newXs, this->xs, kept * sizeof(float));
+      std::memcpy(newYs, this->ys, kept * sizeof(float));
+      if (this->withZ) std::memcpy(newZs, this->zs, kept * sizeof(float));
+    }
+
+    freeAligned(this->xs);
+    freeAligned(this->ys);
+    freeAligned(this->zs);
+    this->xs = newXs;
+    this->ys = newYs;
+    this->zs = newZs;
+    this->allocated = newCapacity;
+    this->count = kept;
+  }
+
+  void PointBuffer::reserve(size_t n) {
+    if (n > this->allocated) this->reallocate(n);
+  }
+
+  /**
+   * @brief Grow or shrink the point count, new points are zero initialized
+   */
+  void PointBuffer::resize(size_t n) {
+    if (n > this->allocated) this->reallocate(std::max(n, this->allocated * 2));
+    if (n > this->count) {
+      std::fill(this->xs + this->count, this->xs + n, 0.0f);
+      std::fill(this->ys + this->count, this->ys + n, 0.0f);
+      if (this->withZ) std::fill(this->zs + this->count, this->zs + n, 0.0f);
+    }
+    this->count = n;
+  }
+
+  void PointBuffer::push_back(float x, float y, float z) {
+    if (this->count == this->allocated) {
+      this->reallocate(std::max<size_t>(16, this->allocated * 2));
+    }
+    this->xs[this->count] = x;
+    this->ys[this->count] = y;
+    if (this->withZ) this->zs[this->count] = z;
+    this->count++;
+  }
+
+  void PointBuffer::set(size_t i, const Vector2D &point) {
+    this->xs[i] = point.vector[0];
+    this->ys[i] = point.vector[1];
+  }
+
+  void PointBuffer::set(size_t i, const Vector3D &point) {
+    this->xs[i] = point.vector[0];
+    this->ys[i] = point.vector[1];
+    if (this->withZ) this->zs[i] = point.vector[2];
+  }
+
+  void PointBuffer::copyInterleaved(size_t first, size_t n, Vector2D *out) const {
+    const float *x = this->xs + first;
+    const float *y = this->ys + first;
+    float *o = (float *) out;
+    size_t i = 0;
+#ifdef COMPGEOM_X86
+    for (; i + 4 <= n; i += 4) {
+      __m128 vx = _mm_loadu_ps(x + i);
+      __m128 vy = _mm_loadu_ps(y + i);
+      _mm_storeu_ps(o + 2 * i, _mm_unpacklo_ps(vx, vy));
+      _mm_storeu_ps(o + 2 * i + 4, _mm_unpackhi_ps(vx, vy));
+    }
+#endif
+    for (; i < n; i++) {
+      out[i].vector[0] = x[i];
+      out[i].vector[1] = y[i];
+    }
+  }
+
+  void PointBuffer::copyInterleaved(size_t first, size_t n, Vector3D *out) const {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = this->point3D(first + i);
+    }
+  }
+
+  void PointBuffer::assign(const Vector2D *points, size_t n) {
+    this->count = 0;
+    this->reserve(n);
+    const float *p = (const float *) points;
+    size_t i = 0;
+#ifdef COMPGEOM_X86
+    for (; i + 4 <= n; i += 4) {
+      __m128 lo = _mm_loadu_ps(p + 2 * i);
+      __m128 hi = _mm_loadu_ps(p + 2 * i + 4);
+      _mm_storeu_ps(this->xs + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(this->ys + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+    for (; i < n; i++) {
+      this->xs[i] = points[i].vector[0];
+      this->ys[i] = points[i].vector[1];
+    }
+    if (this->withZ) std::fill(this->zs, this->zs + n, 0.0f);
+    this->count = n;
+  }
+
+  void PointBuffer::assign(const Vector3D *points, size_t n) {
+    this->count = 0;
+    this->reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      this->xs[i] = points[i].vector[0];
+      this->ys[i] = points[i].vector[1];
+      if (this->withZ) this->zs[i] = points[i].vector[2];
+    }
+    this->count = n;
+  }
+}
@@ -0,0 +1,132 @@
+#ifndef POINT_BUFFER_HPP
+#define POINT_BUFFER_HPP
+
+#include <cstddef>
+#include <iterator>
+#include "../vectors.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Random access iterator over a PointBuffer yielding Vector2D or Vector3D by value,
+   * so algorithms written against Vector2D ranges can consume SoA storage directly
+   */
+  template <typename Vector>
+  class PointIterator {
+    public:
+      using iterator_concept = std::random_access_iterator_tag;
+      using iterator_category = std::input_iterator_tag;
+      using value_type = Vector;
+      using difference_type = std::ptrdiff_t;
+      using reference = Vector;
+
+      PointIterator() {};
+      PointIterator(const float *x, const float *y, const float *z, size_t index) : x(x), y(y), z(z), index(index) {};
+
+      Vector operator*() const { return (*this)[0]; }
+      Vector operator[](difference_type offset) const {
+        size_t i = this->index + offset;
+        if constexpr (sizeof(Vector) == sizeof(Vector3D)) {
+          return { { this->x[i], this->y[i], this->z == NULL ? 0.0f : this->z[i] } };
+        } else {
+          return { { this->x[i], this->y[i] } };
+        }
+      }
+
+      PointIterator &operator++() { this->index++; return *this; }
+      PointIterator operator++(int) { PointIterator it = *this; this->index++; return it; }
+      PointIterator &operator--() { this->index--; return *this; }
+      PointIterator operator--(int) { PointIterator it = *this; this->index--; return it; }
+      PointIterator &operator+=(difference_type offset) { this->index += offset; return *this; }
+      PointIterator &operator-=(difference_type offset) { this->index -= offset; return *this; }
+      PointIterator operator+(difference_type offset) const { PointIterator it = *this; return it += offset; }
+      PointIterator operator-(difference_type offset) const { PointIterator it = *this; return it -= offset; }
+      friend PointIterator operator+(difference_type offset, const PointIterator &it) { return it + offset; }
+      difference_type operator-(const PointIterator &other) const { return (difference_type) this->index - (difference_type) other.index; }
+
+      bool operator==(const PointIterator &other) const { return this->index == other.index; }
+      auto operator<=>(const PointIterator &other) const { return this->index <=> other.index; }
+
+      /**
+       * @brief Position of the iterator inside its buffer
+       */
+      size_t getIndex() const { return this->index; }
+    private:
+      const float *x = NULL;
+      const float *y = NULL;
+      const float *z = NULL;
+      size_t index = 0;
+  };
+
+  /**
+   * @brief Structure-of-arrays container for large 2D/3D point sets. x, y and the optional z coordinates
+   * live in separate 64-byte aligned arrays so kernels can stream them with full-width vector loads
+   */
+  class PointBuffer {
+    public:
+      static const size_t ALIGNMENT = 64;
+
+      explicit PointBuffer(bool hasZ = false) : withZ(hasZ) {};
+      PointBuffer(const Vector2D *points, size_t n);
+      PointBuffer(const Vector3D *points, size_t n);
+      PointBuffer(const PointBuffer &other);
+      PointBuffer(PointBuffer &&other) noexcept;
+      PointBuffer &operator=(PointBuffer other) noexcept;
+      ~PointBuffer();
+
+      friend void swap(PointBuffer &a, PointBuffer &b) noexcept;
+
+      size_t size() const { return this->count; }
+      size_t capacity() const { return this->allocated; }
+      bool empty() const { return this->count == 0; }
+      bool hasZ() const { return this->withZ; }
+
+      void reserve(size_t n);
+      void resize(size_t n);
+      void clear() { this->count = 0; }
+
+      void push_back(float x, float y, float z = 0.0f);
+      void push_back(const Vector2D &point) { this->push_back(point.vector[0], point.vector[1]); }
+      void push_back(const Vector3D &point) { this->push_back(point.vector[0], point.vector[1], point.vector[2]); }
+
+      float *x() { return this->xs; }
+      float *y() { return this->ys; }
+      float *z() { return this->zs; }
+      const float *x() const { return this->xs; }
+      const float *y() const { return this->ys; }
+      const float *z() const { return this->zs; }
+
+      Vector2D point2D(size_t i) const { return { { this->xs[i], this->ys[i] } }; }
+      Vector3D point3D(size_t i) const { return { { this->xs[i], this->ys[i], this->withZ ? this->zs[i] : 0.0f } }; }
+      void set(size_t i, const Vector2D &point);
+      void set(size_t i, const Vector3D &point);
+
+      PointIterator<Vector2D> begin2D() const { return PointIterator<Vector2D>(this->xs, this->ys, this->zs, 0); }
+      PointIterator<Vector2D> end2D() const { return PointIterator<Vector2D>(this->xs, this->ys, this->zs, this->count); }
+      PointIterator<Vector3D> begin3D() const { return PointIterator<Vector3D>(this->xs, this->ys, this->zs, 0); }
+      PointIterator<Vector3D> end3D() const { return PointIterator<Vector3D>(this->xs, this->ys, this->zs, this->count); }
+
+      /**
+       * @brief Write points [first, first + n) in the interleaved layout GL uploads expect. The destination
+       * can be a mapped GL buffer, so no intermediate copy is made
+       */
+      void copyInterleaved(size_t first, size_t n, Vector2D *out) const;
+      void copyInterleaved(size_t first, size_t n, Vector3D *out) const;
+
+      /**
+       * @brief Replace the contents with an interleaved array
+       */
+      void assign(const Vector2D *points, size_t n);
+      void assign(const Vector3D *points, size_t n);
+    private:
+      float *xs = NULL;
+      float *ys = NULL;
+      float *zs = NULL;
+      size_t count = 0;
+      size_t allocated = 0;
+      bool withZ = false;
+
+      void reallocate(size_t newCapacity);
+  };
+}
+
+#endif
@@ -0,0 +1,840 @@
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include "cpu_features.hpp"
+#include "predicates.hpp"
+
+#ifdef COMPGEOM_X86
+  # include <immintrin.h>
+#endif
+
+// The expansion arithmetic below depends on every operation being rounded on its own,
+// this file must be compiled with -ffp-contract=off so no multiply-add gets fused.
+
+namespace Geometry {
+  // -- error bounds, Shewchuk's exactinit() with epsilon = 2^-53 -------------
+
+  static const double EPSILON = 1.1102230246251565e-16;
+  static const double SPLITTER = 134217729.0; // 2^27 + 1
+
+  static const double RESULT_ERRBOUND = (3.0 + 8.0 * EPSILON) * EPSILON;
+  static const double CCW_ERRBOUND_A = (3.0 + 16.0 * EPSILON) * EPSILON;
+  static const double CCW_ERRBOUND_B = (2.0 + 12.0 * EPSILON) * EPSILON;
+  static const double CCW_ERRBOUND_C = (9.0 + 64.0 * EPSILON) * EPSILON * EPSILON;
+  static const double O3D_ERRBOUND_A = (7.0 + 56.0 * EPSILON) * EPSILON;
+  static const double ICC_ERRBOUND_A = (10.0 + 96.0 * EPSILON) * EPSILON;
+  static const double ISP_ERRBOUND_A = (16.0 + 224.0 * EPSILON) * EPSILON;
+
+  // -- per-thread counters ------------------------------------------------------
+
+  /**
+   * @brief Counters owned by one thread. Only the owner writes, so plain load/store on relaxed atomics
+   * is enough and no increment needs a locked instruction
+   */
+  struct ThreadPredicateCounters {
+    std::atomic<uint64_t> calls[4];
+    std::atomic<uint64_t> adaptive[4];
+    std::atomic<uint64_t> exact[4];
+  };
+
+  /**
+   * @brief Blocks of the live threads, plus the totals of threads that have exited. retired is only written
+   * under the mutex; exiting takes the counts of predicates evaluated by thread_local destructors that run after
+   * their thread's block is gone, shared, so concurrent stragglers may lose counts
+   */
+  struct CounterRegistry {
+    std::mutex mutex;
+    std::vector<ThreadPredicateCounters*> live;
+    ThreadPredicateCounters retired;
+    ThreadPredicateCounters exiting;
+  };
+
+  /**
+   * @brief Never destroyed, threads still exiting after static destruction can retire their counters
+   */
+  static CounterRegistry &counterRegistry() {
+    static CounterRegistry *registry = new CounterRegistry();
+    return *registry;
+  }
+
+  // trivially initialized, so the hot path is a plain TLS load with no guard
+  static thread_local ThreadPredicateCounters *threadCounters = NULL;
+
+  static void addCounters(PredicateStats &stats, const ThreadPredicateCounters &counters) {
+    for (int i = 0; i < 4; i++) {
+      stats.calls[i] += counters.calls[i].load(std::memory_order_relaxed);
+      stats.adaptive[i] += counters.adaptive[i].load(std::memory_order_relaxed);
+      stats.exact[i] += counters.exact[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  static void clearCounters(ThreadPredicateCounters &counters) {
+    for (int i = 0; i < 4; i++) {
+      counters.calls[i].store(0, std::memory_order_relaxed);
+      counters.adaptive[i].store(0, std::memory_order_relaxed);
+      counters.exact[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Fold a thread's block into the retired totals and free it when the thread exits
+   */
+  struct CountersOwner {
+    ThreadPredicateCounters *counters = NULL;
+
+    ~CountersOwner() {
+      CounterRegistry &registry = counterRegistry();
+      threadCounters = &registry.exiting;
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      for (int i = 0; i < 4; i++) {
+        registry.retired.calls[i].fetch_add(this->counters->calls[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        registry.retired.adaptive[i].fetch_add(this->counters->adaptive[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        registry.retired.exact[i].fetch_add(this->counters->exact[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+      std::erase(registry.live, this->counters);
+      delete this->counters;
+    }
+  };
+
+  static ThreadPredicateCounters *registerCounters() {
+    ThreadPredicateCounters *counters = new ThreadPredicateCounters();
+    clearCounters(*counters);
+    thread_local CountersOwner owner;
+    owner.counters = counters;
+
+    CounterRegistry &registry = counterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.live.push_back(counters);
+    return counters;
+  }
+
+  static inline ThreadPredicateCounters &localCounters() {
+    if (threadCounters == NULL) threadCounters = registerCounters();
+    return *threadCounters;
+  }
+
+  static inline void bump(std::atomic<uint64_t> &counter, uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  PredicateStats Predicates::getStats() {
+    PredicateStats stats = {};
+    CounterRegistry &registry = counterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ThreadPredicateCounters *counters : registry.live) addCounters(stats, *counters);
+    addCounters(stats, registry.retired);
+    addCounters(stats, registry.exiting);
+    return stats;
+  }
+
+  void Predicates::resetStats() {
+    CounterRegistry &registry = counterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ThreadPredicateCounters *counters : registry.live) clearCounters(*counters);
+    clearCounters(registry.retired);
+    clearCounters(registry.exiting);
+  }
+
+  // -- error-free transformations -------------------------------------------------
+
+  static inline void fastTwoSum(double a, double b, double &x, double &y) {
+    x = a + b;
+    double bvirt = x - a;
+    y = b - bvirt;
+  }
+
+  static inline void twoSum(double a, double b, double &x, double &y) {
+    x = a + b;
+    double bvirt = x - a;
+    double avirt = x - bvirt;
+    double bround = b - bvirt;
+    double around = a - avirt;
+    y = around + bround;
+  }
+
+  static inline double twoDiffTail(double a, double b, double x) {
+    double bvirt = a - x;
+    double avirt = x + bvirt;
+    double bround = bvirt - b;
+    double around = a - avirt;
+    return around + bround;
+  }
+
+  static inline void twoDiff(double a, double b, double &x, double &y) {
+    x = a - b;
+    y = twoDiffTail(a, b, x);
+  }
+
+  static inline void split(double a, double &hi, double &lo) {
+    double c = SPLITTER * a;
+    double abig = c - a;
+    hi = c - abig;
+    lo = a - hi;
+  }
+
+  static inline void twoProduct(double a, double b, double &x, double &y) {
+    x = a * b;
+    double ahi, alo, bhi, blo;
+    split(a, ahi, alo);
+    split(b, bhi, blo);
+    double err1 = x - (ahi * bhi);
+    double err2 = err1 - (alo * bhi);
+    double err3 = err2 - (ahi * blo);
+    y = (alo * blo) - err3;
+  }
+
+  // (a1 + a0) - (b1 + b0) as a 4 component expansion x
+  static inline void twoTwoDiff(double a1, double a0, double b1, double b0, double *x) {
+    double i, j, zero;
+    twoDiff(a0, b0, i, x[0]);
+    twoSum(a1, i, j, zero);
+    twoDiff(zero, b1, i, x[1]);
+    twoSum(j, i, x[3], x[2]);
+  }
+
+  // -- expansion arithmetic -------------------------------------------------------
+
+  static double estimate(int elen, const double *e) {
+    double q = e[0];
+    for (int i = 1; i < elen; i++) q += e[i];
+    return q;
+  }
+
+  /**
+   * @brief h = e + f with zero components removed, e and f must be strongly nonoverlapping
+   *
+   * @return int Number of components written to h (at most elen + flen)
+   */
+  static int fastExpansionSumZeroelim(int elen, const double *e, int flen, const double *f, double *h) {
+    double q, qnew, hh;
+    int eindex = 0, findex = 0, hindex = 0;
+    double enow = e[0];
+    double fnow = f[0];
+
+    if ((fnow > enow) == (fnow > -enow)) {
+      q = enow;
+      eindex++;
+      if (eindex < elen) enow = e[eindex];
+    } else {
+      q = fnow;
+      findex++;
+      if (findex < flen) fnow = f[findex];
+    }
+
+    if (eindex < elen && findex < flen) {
+      if ((fnow > enow) == (fnow > -enow)) {
+        fastTwoSum(enow, q, qnew, hh);
+        eindex++;
+        if (eindex < elen) enow = e[eindex];
+      } else {
+        fastTwoSum(fnow, q, qnew, hh);
+        findex++;
+        if (findex < flen) fnow = f[findex];
+      }
+      q = qnew;
+      if (hh != 0.0) h[hindex++] = hh;
+
+      while (eindex < elen && findex < flen) {
+        if ((fnow > enow) == (fnow > -enow)) {
+          twoSum(q, enow, qnew, hh);
+          eindex++;
+          if (eindex < elen) enow = e[eindex];
+        } else {
+          twoSum(q, fnow, qnew, hh);
+          findex++;
+          if (findex < flen) fnow = f[findex];
+        }
+        q = qnew;
+        if (hh != 0.0) h[hindex++] = hh;
+      }
+    }
+
+    while (eindex < elen) {
+      twoSum(q, enow, qnew, hh);
+      eindex++;
+      if (eindex < elen) enow = e[eindex];
+      q = qnew;
+      if (hh != 0.0) h[hindex++] = hh;
+    }
+    while (findex < flen) {
+      twoSum(q, fnow, qnew, hh);
+      findex++;
+      if (findex < flen) fnow = f[findex];
+      q = qnew;
+      if (hh != 0.0) h[hindex++] = hh;
+    }
+
+    if (q != 0.0 || hindex == 0) h[hindex++] = q;
+    return hindex;
+  }
+
+  /**
+   * @brief h = b * e with zero components removed
+   *
+   * @return int Number of components written to h (at most 2 * elen)
+   */
+  static int scaleExpansionZeroelim(int elen, const double *e, double b, double *h) {
+    double q, sum, hh, product1, product0;
+    double bhi, blo;
+    int hindex = 0;
+
+    split(b, bhi, blo);
+    auto twoProductPresplit = [&](double a, double &x, double &y) {
+      x = a * b;
+      double ahi, alo;
+      split(a, ahi, alo);
+      double err1 = x - (ahi * bhi);
+      double err2 = err1 - (alo * bhi);
+      double err3 = err2 - (ahi * blo);
+      y = (alo * blo) - err3;
+    };
+
+    twoProductPresplit(e[0], q, hh);
+    if (hh != 0.0) h[hindex++] = hh;
+    for (int eindex = 1; eindex < elen; eindex++) {
+      twoProductPresplit(e[eindex], product1, product0);
+      twoSum(q, product0, sum, hh);
+      if (hh != 0.0) h[hindex++] = hh;
+      fastTwoSum(product1, sum, q, hh);
+      if (hh != 0.0) h[hindex++] = hh;
+    }
+    if (q != 0.0 || hindex == 0) h[hindex++] = q;
+    return hindex;
+  }
+
+  /**
+   * @brief Exact value held as a nonoverlapping expansion, only used on the rare exact path
+   */
+  class Expansion {
+    public:
+      std::vector<double> terms;
+
+      Expansion() : terms(1, 0.0) {};
+
+      static Expansion difference(double a, double b) {
+        Expansion result;
+        double x, y;
+        twoDiff(a, b, x, y);
+        result.terms.assign({ y, x });
+        return result;
+      }
+
+      Expansion operator+(const Expansion &other) const {
+        Expansion result;
+        result.terms.resize(this->terms.size() + other.terms.size());
+        int length = fastExpansionSumZeroelim((int) this->terms.size(), this->terms.data(),
+          (int) other.terms.size(), other.terms.data(), result.terms.data());
+        result.terms.resize(length);
+        return result;
+      }
+
+      Expansion operator-() const {
+        Expansion result = *this;
+        for (double &term : result.terms) term = -term;
+        return result;
+      }
+
+      Expansion operator-(const Expansion &other) const {
+        return *this + (-other);
+      }
+
+      Expansion operator*(const Expansion &other) const {
+        const Expansion &longer = this->terms.size() >= other.terms.size() ? *this : other;
+        const Expansion &shorter = this->terms.size() >= other.terms.size() ? other : *this;
+
+        Expansion result;
+        std::vector<double> scaled(2 * longer.terms.size());
+        for (double factor : shorter.terms) {
+          Expansion partial;
+          int length = scaleExpansionZeroelim((int) longer.terms.size(), longer.terms.data(), factor, scaled.data());
+          partial.terms.assign(scaled.begin(), scaled.begin() + length);
+          result = result + partial;
+        }
+        return result;
+      }
+
+      /**
+       * @brief The largest component carries the sign of the whole expansion
+       */
+      double mostSignificant() const { return this->terms.back(); }
+  };
+
+  // -- orient2d ---------------------------------------------------------------------
+
+  static double orient2dAdapt(double ax, double ay, double bx, double by, double cx, double cy, double detsum) {
+    double acx = ax - cx;
+    double bcx = bx - cx;
+    double acy = ay - cy;
+    double bcy = by - cy;
+
+    double detleft, detlefttail, detright, detrighttail;
+    twoProduct(acx, bcy, detleft, detlefttail);
+    twoProduct(acy, bcx, detright, detrighttail);
+
+    double B[4];
+    twoTwoDiff(detleft, detlefttail, detright, detrighttail, B);
+
+    double det = estimate(4, B);
+    double errbound = CCW_ERRBOUND_B * detsum;
+    if (det >= errbound || -det >= errbound) return det;
+
+    double acxtail = twoDiffTail(ax, cx, acx);
+    double bcxtail = twoDiffTail(bx, cx, bcx);
+    double acytail = twoDiffTail(ay, cy, acy);
+    double bcytail = twoDiffTail(by, cy, bcy);
+
+    if (acxtail == 0.0 && acytail == 0.0 && bcxtail == 0.0 && bcytail == 0.0) return det;
+
+    errbound = CCW_ERRBOUND_C * detsum + RESULT_ERRBOUND * std::fabs(det);
+    det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+    if (det >= errbound || -det >= errbound) return det;
+
+    bump(localCounters().exact[ORIENT2D]);
+
+    double s1, s0, t1, t0, u[4];
+    double C1[8], C2[12], D[16];
+
+    twoProduct(acxtail, bcy, s1, s0);
+    twoProduct(acytail, bcx, t1, t0);
+    twoTwoDiff(s1, s0, t1, t0, u);
+    int C1length = fastExpansionSumZeroelim(4, B, 4, u, C1);
+
+    twoProduct(acx, bcytail, s1, s0);
+    twoProduct(acy, bcxtail, t1, t0);
+    twoTwoDiff(s1, s0, t1, t0, u);
+    int C2length = fastExpansionSumZeroelim(C1length, C1, 4, u, C2);
+
+    twoProduct(acxtail, bcytail, s1, s0);
+    twoProduct(acytail, bcxtail, t1, t0);
+    twoTwoDiff(s1, s0, t1, t0, u);
+    int Dlength = fastExpansionSumZeroelim(C2length, C2, 4, u, D);
+
+    return D[Dlength - 1];
+  }
+
+  double Predicates::orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    ThreadPredicateCounters &counters = localCounters();
+    bump(counters.calls[ORIENT2D]);
+
+    double detleft = (ax - cx) * (by - cy);
+    double detright = (ay - cy) * (bx - cx);
+    double det = detleft - detright;
+    double detsum;
+
+    if (detleft > 0.0) {
+      if (detright <= 0.0) return det;
+      detsum = detleft + detright;
+    } else if (detleft < 0.0) {
+      if (detright >= 0.0) return det;
+      detsum = -detleft - detright;
+    } else {
+      return det;
+    }
+
+    double errbound = CCW_ERRBOUND_A * detsum;
+    if (det >= errbound || -det >= errbound) return det;
+
+    bump(counters.adaptive[ORIENT2D]);
+    return orient2dAdapt(ax, ay, bx, by, cx, cy, detsum);
+  }
+
+  // -- orient3d -----------------------------------------------------------------------
+
+  static double orient3dExact(const double *a, const double *b, const double *c, const double *d) {
+    Expansion adx = Expansion::difference(a[0], d[0]);
+    Expansion ady = Expansion::difference(a[1], d[1]);
+    Expansion adz = Expansion::difference(a[2], d[2]);
+    Expansion bdx = Expansion::difference(b[0], d[0]);
+    Expansion bdy = Expansion::difference(b[1], d[1]);
+    Expansion bdz = Expansion::difference(b[2], d[2]);
+    Expansion cdx = Expansion::difference(c[0], d[0]);
+    Expansion cdy = Expansion::difference(c[1], d[1]);
+    Expansion cdz = Expansion::difference(c[2], d[2]);
+
+    Expansion det = adz * (bdx * cdy - cdx * bdy)
+      + bdz * (cdx * ady - adx * cdy)
+      + cdz * (adx * bdy - bdx * ady);
+    return det.mostSignificant();
+  }
+
+  double Predicates::orient3d(const double *a, const double *b, const double *c, const double *d) {
+    ThreadPredicateCounters &counters = localCounters();
+    bump(counters.calls[ORIENT3D]);
+
+    double adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+    double ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+    double adz = a[2] - d[2], bdz = b[2] - d[2], cdz = c[2] - d[2];
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+      + (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+      + (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+    double errbound = O3D_ERRBOUND_A * permanent;
+    if (det > errbound || -det > errbound) return det;
+
+    bump(counters.adaptive[ORIENT3D]);
+    bump(counters.exact[ORIENT3D]);
+    return orient3dExact(a, b, c, d);
+  }
+
+  double Predicates::orient3d(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D &d) {
+    double pa[3] = { a.vector[0], a.vector[1], a.vector[2] };
+    double pb[3] = { b.vector[0], b.vector[1], b.vector[2] };
+    double pc[3] = { c.vector[0], c.vector[1], c.vector[2] };
+    double pd[3] = { d.vector[0], d.vector[1], d.vector[2] };
+    return orient3d(pa, pb, pc, pd);
+  }
+
+  // -- incircle -----------------------------------------------------------------------
+
+  static double incircleExact(const double *a, const double *b, const double *c, const double *d) {
+    Expansion adx = Expansion::difference(a[0], d[0]);
+    Expansion ady = Expansion::difference(a[1], d[1]);
+    Expansion bdx = Expansion::difference(b[0], d[0]);
+    Expansion bdy = Expansion::difference(b[1], d[1]);
+    Expansion cdx = Expansion::difference(c[0], d[0]);
+    Expansion cdy = Expansion::difference(c[1], d[1]);
+
+    Expansion alift = adx * adx + ady * ady;
+    Expansion blift = bdx * bdx + bdy * bdy;
+    Expansion clift = cdx * cdx + cdy * cdy;
+
+    Expansion det = alift * (bdx * cdy - cdx * bdy)
+      + blift * (cdx * ady - adx * cdy)
+      + clift * (adx * bdy - bdx * ady);
+    return det.mostSignificant();
+  }
+
+  double Predicates::incircle(const double *a, const double *b, const double *c, const double *d) {
+    ThreadPredicateCounters &counters = localCounters();
+    bump(counters.calls[INCIRCLE]);
+
+    double adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+    double ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double alift = adx * adx + ady * ady;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double blift = bdx * bdx + bdy * bdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift
+      + (std::fabs(cdxady) + std::fabs(adxcdy)) * blift
+      + (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+    double errbound = ICC_ERRBOUND_A * permanent;
+    if (det > errbound || -det > errbound) return det;
+
+    bump(counters.adaptive[INCIRCLE]);
+    bump(counters.exact[INCIRCLE]);
+    return incircleExact(a, b, c, d);
+  }
+
+  double Predicates::incircle(const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D &d) {
+    double pa[2] = { a.vector[0], a.vector[1] };
+    double pb[2] = { b.vector[0], b.vector[1] };
+    double pc[2] = { c.vector[0], c.vector[1] };
+    double pd[2] = { d.vector[0], d.vector[1] };
+    return incircle(pa, pb, pc, pd);
+  }
+
+  // -- insphere -----------------------------------------------------------------------
+
+  static double insphereExact(const double *a, const double *b, const double *c, const double *d, const double *e) {
+    Expansion aex = Expansion::difference(a[0], e[0]);
+    Expansion aey = Expansion::difference(a[1], e[1]);
+    Expansion aez = Expansion::difference(a[2], e[2]);
+    Expansion bex = Expansion::difference(b[0], e[0]);
+    Expansion bey = Expansion::difference(b[1], e[1]);
+    Expansion bez = Expansion::difference(b[2], e[2]);
+    Expansion cex = Expansion::difference(c[0], e[0]);
+    Expansion cey = Expansion::difference(c[1], e[1]);
+    Expansion cez = Expansion::difference(c[2], e[2]);
+    Expansion dex = Expansion::difference(d[0], e[0]);
+    Expansion dey = Expansion::difference(d[1], e[1]);
+    Expansion dez = Expansion::difference(d[2], e[2]);
+
+    Expansion ab = aex * bey - bex * aey;
+    Expansion bc = bex * cey - cex * bey;
+    Expansion cd = cex * dey - dex * cey;
+    Expansion da = dex * aey - aex * dey;
+    Expansion ac = aex * cey - cex * aey;
+    Expansion bd = bex * dey - dex * bey;
+
+    Expansion abc = aez * bc - bez * ac + cez * ab;
+    Expansion bcd = bez * cd - cez * bd + dez * bc;
+    Expansion cda = cez * da + dez * ac + aez * cd;
+    Expansion dab = dez * ab + aez * bd + bez * da;
+
+    Expansion alift = aex * aex + aey * aey + aez * aez;
+    Expansion blift = bex * bex + bey * bey + bez * bez;
+    Expansion clift = cex * cex + cey * cey + cez * cez;
+    Expansion dlift = dex * dex + dey * dey + dez * dez;
+
+    Expansion det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+    return det.mostSignificant();
+  }
+
+  double Predicates::insphere(const double *a, const double *b, const double *c, const double *d, const double *e) {
+    ThreadPredicateCounters &counters = localCounters();
+    bump(counters.calls[INSPHERE]);
+
+    double aex = a[0] - e[0], bex = b[0] - e[0], cex = c[0] - e[0], dex = d[0] - e[0];
+    double aey = a[1] - e[1], bey = b[1] - e[1], cey = c[1] - e[1], dey = d[1] - e[1];
+    double aez = a[2] - e[2], bez = b[2] - e[2], cez = c[2] - e[2], dez = d[2] - e[2];
+
+    double aexbey = aex * bey, bexaey = bex * aey;
+    double bexcey = bex * cey, cexbey = cex * bey;
+    double cexdey = cex * dey, dexcey = dex * cey;
+    double dexaey = dex * aey, aexdey = aex * dey;
+    double aexcey = aex * cey, cexaey = cex * aey;
+    double bexdey = bex * dey, dexbey = dex * bey;
+
+    double ab = aexbey - bexaey;
+    double bc = bexcey - cexbey;
+    double cd = cexdey - dexcey;
+    double da = dexaey - aexdey;
+    double ac = aexcey - cexaey;
+    double bd = bexdey - dexbey;
+
+    double abc = aez * bc - bez * ac + cez * ab;
+    double bcd = bez * cd - cez * bd + dez * bc;
+    double cda = cez * da + dez * ac + aez * cd;
+    double dab = dez * ab + aez * bd + bez * da;
+
+    double alift = aex * aex + aey * aey + aez * aez;
+    double blift = bex * bex + bey * bey + bez * bez;
+    double clift = cex * cex + cey * cey + cez * cez;
+    double dlift = dex * dex + dey * dey + dez * dez;
+
+    double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+    double aezplus = std::fabs(aez), bezplus = std::fabs(bez), cezplus = std::fabs(cez), dezplus = std::fabs(dez);
+    double aexbeyplus = std::fabs(aexbey), bexaeyplus = std::fabs(bexaey);
+    double bexceyplus = std::fabs(bexcey), cexbeyplus = std::fabs(cexbey);
+    double cexdeyplus = std::fabs(cexdey), dexceyplus = std::fabs(dexcey);
+    double dexaeyplus = std::fabs(dexaey), aexdeyplus = std::fabs(aexdey);
+    double aexceyplus = std::fabs(aexcey), cexaeyplus = std::fabs(cexaey);
+    double bexdeyplus = std::fabs(bexdey), dexbeyplus = std::fabs(dexbey);
+
+    double permanent = ((cexdeyplus + dexceyplus) * bezplus
+        + (dexbeyplus + bexdeyplus) * cezplus
+        + (bexceyplus + cexbeyplus) * dezplus) * alift
+      + ((dexaeyplus + aexdeyplus) * cezplus
+        + (aexceyplus + cexaeyplus) * dezplus
+        + (cexdeyplus + dexceyplus) * aezplus) * blift
+      + ((aexbeyplus + bexaeyplus) * dezplus
+        + (bexdeyplus + dexbeyplus) * aezplus
+        + (dexaeyplus + aexdeyplus) * bezplus) * clift
+      + ((bexceyplus + cexbeyplus) * aezplus
+        + (cexaeyplus + aexceyplus) * bezplus
+        + (aexbeyplus + bexaeyplus) * cezplus) * dlift;
+    double errbound = ISP_ERRBOUND_A * permanent;
+    if (det > errbound || -det > errbound) return det;
+
+    bump(counters.adaptive[INSPHERE]);
+    bump(counters.exact[INSPHERE]);
+    return insphereExact(a, b, c, d, e);
+  }
+
+  double Predicates::insphere(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D &d, const Vector3D &e) {
+    double pa[3] = { a.vector[0], a.vector[1], a.vector[2] };
+    double pb[3] = { b.vector[0], b.vector[1], b.vector[2] };
+    double pc[3] = { c.vector[0], c.vector[1], c.vector[2] };
+    double pd[3] = { d.vector[0], d.vector[1], d.vector[2] };
+    double pe[3] = { e.vector[0], e.vector[1], e.vector[2] };
+    return insphere(pa, pb, pc, pd, pe);
+  }
+
+  // -- batch variants -------------------------------------------------------------------
+
+  static inline int8_t signOf(double value) {
+    return (int8_t) ((value > 0.0) - (value < 0.0));
+  }
+
+#ifdef COMPGEOM_X86
+  #define AVX2_TARGET __attribute__((target("avx2")))
+
+  /**
+   * @brief Load 4 interleaved Vector2D and widen their x and y coordinates to doubles
+   */
+  AVX2_TARGET static inline void loadPoints2D(const Vector2D *p, __m256d &x, __m256d &y) {
+    __m128 lo = _mm_loadu_ps((const float *) p);
+    __m128 hi = _mm_loadu_ps((const float *) p + 4);
+    x = _mm256_cvtps_pd(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    y = _mm256_cvtps_pd(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+
+  AVX2_TARGET static inline __m256d absolute(__m256d v) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+  }
+
+  /**
+   * @brief Write the sign of every lane whose |det| clears its error bound, return a 4 bit mask of the undecided lanes
+   */
+  AVX2_TARGET static inline int storeCertainSigns(__m256d det, __m256d errbound, int8_t *signs, size_t &decided) {
+    __m256d certain = _mm256_cmp_pd(absolute(det), errbound, _CMP_GT_OQ);
+    int certainMask = _mm256_movemask_pd(certain);
+    int positiveMask = _mm256_movemask_pd(_mm256_cmp_pd(det, _mm256_setzero_pd(), _CMP_GT_OQ));
+    decided += __builtin_popcount(certainMask);
+    for (int lane = 0; lane < 4; lane++) {
+      if (certainMask & (1 << lane)) signs[lane] = (positiveMask & (1 << lane)) ? 1 : -1;
+    }
+    return ~certainMask & 0xF;
+  }
+
+  AVX2_TARGET static size_t orient2dBatchAvx2(const Vector2D &a, const Vector2D &b, const Vector2D *c, size_t n, int8_t *signs, size_t &decided) {
+    __m256d ax = _mm256_set1_pd(a.vector[0]), ay = _mm256_set1_pd(a.vector[1]);
+    __m256d bx = _mm256_set1_pd(b.vector[0]), by = _mm256_set1_pd(b.vector[1]);
+    __m256d bound = _mm256_set1_pd(CCW_ERRBOUND_A);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m256d cx, cy;
+      loadPoints2D(c + i, cx, cy);
+      __m256d detleft = _mm256_mul_pd(_mm256_sub_pd(ax, cx), _mm256_sub_pd(by, cy));
+      __m256d detright = _mm256_mul_pd(_mm256_sub_pd(ay, cy), _mm256_sub_pd(bx, cx));
+      __m256d det = _mm256_sub_pd(detleft, detright);
+      __m256d errbound = _mm256_mul_pd(bound, _mm256_add_pd(absolute(detleft), absolute(detright)));
+
+      int undecided = storeCertainSigns(det, errbound, signs + i, decided);
+      while (undecided) {
+        int lane = __builtin_ctz(undecided);
+        undecided &= undecided - 1;
+        signs[i + lane] = signOf(Predicates::orient2d(a, b, c[i + lane]));
+      }
+    }
+    return i;
+  }
+
+  AVX2_TARGET static size_t incircleBatchAvx2(const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D *d, size_t n, int8_t *signs, size_t &decided) {
+    __m256d ax = _mm256_set1_pd(a.vector[0]), ay = _mm256_set1_pd(a.vector[1]);
+    __m256d bx = _mm256_set1_pd(b.vector[0]), by = _mm256_set1_pd(b.vector[1]);
+    __m256d cx = _mm256_set1_pd(c.vector[0]), cy = _mm256_set1_pd(c.vector[1]);
+    __m256d bound = _mm256_set1_pd(ICC_ERRBOUND_A);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m256d dx, dy;
+      loadPoints2D(d + i, dx, dy);
+      __m256d adx = _mm256_sub_pd(ax, dx), ady = _mm256_sub_pd(ay, dy);
+      __m256d bdx = _mm256_sub_pd(bx, dx), bdy = _mm256_sub_pd(by, dy);
+      __m256d cdx = _mm256_sub_pd(cx, dx), cdy = _mm256_sub_pd(cy, dy);
+
+      __m256d bdxcdy = _mm256_mul_pd(bdx, cdy), cdxbdy = _mm256_mul_pd(cdx, bdy);
+      __m256d cdxady = _mm256_mul_pd(cdx, ady), adxcdy = _mm256_mul_pd(adx, cdy);
+      __m256d adxbdy = _mm256_mul_pd(adx, bdy), bdxady = _mm256_mul_pd(bdx, ady);
+      __m256d alift = _mm256_add_pd(_mm256_mul_pd(adx, adx), _mm256_mul_pd(ady, ady));
+      __m256d blift = _mm256_add_pd(_mm256_mul_pd(bdx, bdx), _mm256_mul_pd(bdy, bdy));
+      __m256d clift = _mm256_add_pd(_mm256_mul_pd(cdx, cdx), _mm256_mul_pd(cdy, cdy));
+
+      __m256d det = _mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(alift, _mm256_sub_pd(bdxcdy, cdxbdy)),
+        _mm256_mul_pd(blift, _mm256_sub_pd(cdxady, adxcdy))),
+        _mm256_mul_pd(clift, _mm256_sub_pd(adxbdy, bdxady)));
+      __m256d permanent = _mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(_mm256_add_pd(absolute(bdxcdy), absolute(cdxbdy)), alift),
+        _mm256_mul_pd(_mm256_add_pd(absolute(cdxady), absolute(adxcdy)), blift)),
+        _mm256_mul_pd(_mm256_add_pd(absolute(adxbdy), absolute(bdxady)), clift));
+
+      int undecided = storeCertainSigns(det, _mm256_mul_pd(bound, permanent), signs + i, decided);
+      while (undecided) {
+        int lane = __builtin_ctz(undecided);
+        undecided &= undecided - 1;
+        signs[i + lane] = signOf(Predicates::incircle(a, b, c, d[i + lane]));
+      }
+    }
+    return i;
+  }
+
+  AVX2_TARGET static size_t orient3dBatchAvx2(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D *d, size_t n, int8_t *signs, size_t &decided) {
+    size_t i = 0;
+    __m256d bound = _mm256_set1_pd(O3D_ERRBOUND_A);
+    for (; i + 4 <= n; i += 4) {
+      __m256d dx = _mm256_set_pd(d[i + 3].vector[0], d[i + 2].vector[0], d[i + 1].vector[0], d[i].vector[0]);
+      __m256d dy = _mm256_set_pd(d[i + 3].vector[1], d[i + 2].vector[1], d[i + 1].vector[1], d[i].vector[1]);
+      __m256d dz = _mm256_set_pd(d[i + 3].vector[2], d[i + 2].vector[2], d[i + 1].vector[2], d[i].vector[2]);
+
+      __m256d adx = _mm256_sub_pd(_mm256_set1_pd(a.vector[0]), dx);
+      __m256d ady = _mm256_sub_pd(_mm256_set1_pd(a.vector[1]), dy);
+      __m256d adz = _mm256_sub_pd(_mm256_set1_pd(a.vector[2]), dz);
+      __m256d bdx = _mm256_sub_pd(_mm256_set1_pd(b.vector[0]), dx);
+      __m256d bdy = _mm256_sub_pd(_mm256_set1_pd(b.vector[1]), dy);
+      __m256d bdz = _mm256_sub_pd(_mm256_set1_pd(b.vector[2]), dz);
+      __m256d cdx = _mm256_sub_pd(_mm256_set1_pd(c.vector[0]), dx);
+      __m256d cdy = _mm256_sub_pd(_mm256_set1_pd(c.vector[1]), dy);
+      __m256d cdz = _mm256_sub_pd(_mm256_set1_pd(c.vector[2]), dz);
+
+      __m256d bdxcdy = _mm256_mul_pd(bdx, cdy), cdxbdy = _mm256_mul_pd(cdx, bdy);
+      __m256d cdxady = _mm256_mul_pd(cdx, ady), adxcdy = _mm256_mul_pd(adx, cdy);
+      __m256d adxbdy = _mm256_mul_pd(adx, bdy), bdxady = _mm256_mul_pd(bdx, ady);
+
+      __m256d det = _mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(adz, _mm256_sub_pd(bdxcdy, cdxbdy)),
+        _mm256_mul_pd(bdz, _mm256_sub_pd(cdxady, adxcdy))),
+        _mm256_mul_pd(cdz, _mm256_sub_pd(adxbdy, bdxady)));
+      __m256d permanent = _mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(_mm256_add_pd(absolute(bdxcdy), absolute(cdxbdy)), absolute(adz)),
+        _mm256_mul_pd(_mm256_add_pd(absolute(cdxady), absolute(adxcdy)), absolute(bdz))),
+        _mm256_mul_pd(_mm256_add_pd(absolute(adxbdy), absolute(bdxady)), absolute(cdz)));
+
+      int undecided = storeCertainSigns(det, _mm256_mul_pd(bound, permanent), signs + i, decided);
+      while (undecided) {
+        int lane = __builtin_ctz(undecided);
+        undecided &= undecided - 1;
+        signs[i + lane] = signOf(Predicates::orient3d(a, b, c, d[i + lane]));
+      }
+    }
+    return i;
+  }
+#endif
+
+  void Predicates::orient2dBatch(const Vector2D &a, const Vector2D &b, const Vector2D *c, size_t n, int8_t *signs) {
+    size_t i = 0;
+#ifdef COMPGEOM_X86
+    if (CpuFeatures::detectSimdLevel() >= SIMD_AVX2) {
+      // lanes the filter could not decide are counted by the scalar call they fall back to
+      size_t decided = 0;
+      i = orient2dBatchAvx2(a, b, c, n, signs, decided);
+      bump(localCounters().calls[ORIENT2D], decided);
+    }
+#endif
+    for (; i < n; i++) signs[i] = signOf(orient2d(a, b, c[i]));
+  }
+
+  void Predicates::orient3dBatch(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D *d, size_t n, int8_t *signs) {
+    size_t i = 0;
+#ifdef COMPGEOM_X86
+    if (CpuFeatures::detectSimdLevel() >= SIMD_AVX2) {
+      // lanes the filter could not decide are counted by the scalar call they fall back to
+      size_t decided = 0;
+      i = orient3dBatchAvx2(a, b, c, d, n, signs, decided);
+      bump(localCounters().calls[ORIENT3D], decided);
+    }
+#endif
+    for (; i < n; i++) signs[i] = signOf(orient3d(a, b, c, d[i]));
+  }
+
+  void Predicates::incircleBatch(const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D *d, size_t n, int8_t *signs) {
+    size_t i = 0;
+#ifdef COMPGEOM_X86
+    if (CpuFeatures::detectSimdLevel() >= SIMD_AVX2) {
+      // lanes the filter could not decide are counted by the scalar call they fall back to
+      size_t decided = 0;
+      i = incircleBatchAvx2(a, b, c, d, n, signs, decided);
+      bump(localCounters().calls[INCIRCLE], decided);
+    }
+#endif
+    for (; i < n; i++) signs[i] = signOf(incircle(a, b, c, d[i]));
+  }
+
+  void Predicates::insphereBatch(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D &d, const Vector3D *e, size_t n, int8_t *signs) {
+    for (size_t i = 0; i < n; i++) signs[i] = signOf(insphere(a, b, c, d, e[i]));
+  }
+}
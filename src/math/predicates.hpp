@@ -0,0 +1,79 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "../vectors.hpp"
+
+namespace Geometry {
+  /**
+   * @brief How often each predicate ran and how often its floating-point filter could not decide the sign
+   */
+  struct PredicateStats {
+    // orient2d, orient3d, incircle, insphere
+    uint64_t calls[4];
+    // calls where the stage A filter failed and the adaptive/exact path ran
+    uint64_t adaptive[4];
+    // calls that needed the full exact expansion
+    uint64_t exact[4];
+  };
+
+  enum PredicateKind {
+    ORIENT2D, ORIENT3D, INCIRCLE, INSPHERE
+  };
+
+  /**
+   * @brief Robust geometric predicates after Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+   * Geometric Predicates". Each predicate evaluates its determinant in doubles first and returns as soon as a
+   * forward error bound proves the sign, otherwise it falls back to exact expansion arithmetic. The returned value
+   * always has the correct sign, its magnitude is only an approximation of the determinant.
+   */
+  class Predicates {
+    public:
+      /**
+       * @brief Positive if a, b, c occur in counterclockwise order, negative if clockwise, zero if collinear
+       */
+      static double orient2d(double ax, double ay, double bx, double by, double cx, double cy);
+      static double orient2d(const Vector2D &a, const Vector2D &b, const Vector2D &c) {
+        return orient2d(a.vector[0], a.vector[1], b.vector[0], b.vector[1], c.vector[0], c.vector[1]);
+      }
+
+      /**
+       * @brief Positive if d lies below the plane through a, b, c (a, b, c counterclockwise seen from above),
+       * negative if above, zero if coplanar
+       */
+      static double orient3d(const double *a, const double *b, const double *c, const double *d);
+      static double orient3d(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D &d);
+
+      /**
+       * @brief Positive if d lies inside the circle through a, b, c (counterclockwise), negative if outside,
+       * zero if cocircular
+       */
+      static double incircle(const double *a, const double *b, const double *c, const double *d);
+      static double incircle(const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D &d);
+
+      /**
+       * @brief Positive if e lies inside the sphere through a, b, c, d (with orient3d(a, b, c, d) > 0),
+       * negative if outside, zero if cospherical
+       */
+      static double insphere(const double *a, const double *b, const double *c, const double *d, const double *e);
+      static double insphere(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D &d, const Vector3D &e);
+
+      /**
+       * @brief Batch variants: sign (-1, 0, 1) of the predicate for every query point against fixed a, b(, c, d).
+       * On AVX2 CPUs the filter runs four queries per instruction, queries it cannot decide take the scalar path
+       */
+      static void orient2dBatch(const Vector2D &a, const Vector2D &b, const Vector2D *c, size_t n, int8_t *signs);
+      static void orient3dBatch(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D *d, size_t n, int8_t *signs);
+      static void incircleBatch(const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D *d, size_t n, int8_t *signs);
+      static void insphereBatch(const Vector3D &a, const Vector3D &b, const Vector3D &c, const Vector3D &d, const Vector3D *e, size_t n, int8_t *signs);
+
+      /**
+       * @brief Counters summed over every thread that has evaluated a predicate
+       */
+      static PredicateStats getStats();
+      static void resetStats();
+  };
+}
+
+#endif
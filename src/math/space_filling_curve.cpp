@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include "cpu_features.hpp"
+#include "space_filling_curve.hpp"
+#include "../parallel/thread_pool.hpp"
+
+#ifdef COMPGEOM_X86
+  # include <immintrin.h>
+#endif
+
+namespace Geometry {
+  // -- bit interleaving -----------------------------------------------------------------
+
+  /**
+   * @brief Spread the low bits of a value so one bit of every 2 (or 3) holds data, with shifts and masks
+   */
+  struct PortableBits {
+    static inline uint64_t spread2(uint32_t value) {
+      uint64_t x = value;
+      x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+      x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+      x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+      x = (x | (x << 2)) & 0x3333333333333333ull;
+      x = (x | (x << 1)) & 0x5555555555555555ull;
+      return x;
+    }
+
+    static inline uint64_t spread3(uint32_t value) {
+      uint64_t x = value & 0x1FFFFF;
+      x = (x | (x << 32)) & 0x001F00000000FFFFull;
+      x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+      x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+      x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+      x = (x | (x << 2)) & 0x1249249249249249ull;
+      return x;
+    }
+  };
+
+#ifdef COMPGEOM_X86
+  #define BMI2_TARGET __attribute__((target("bmi2")))
+  // flatten pulls the portable encoders into the BMI2 loops, where the pdep helpers may be inlined
+  #define BMI2_FLATTEN_TARGET __attribute__((target("bmi2"), flatten))
+
+  struct PdepBits {
+    BMI2_TARGET static inline uint64_t spread2(uint32_t value) {
+      return _pdep_u64(value, 0x5555555555555555ull);
+    }
+
+    BMI2_TARGET static inline uint64_t spread3(uint32_t value) {
+      return _pdep_u64(value, 0x1249249249249249ull);
+    }
+  };
+#endif
+
+  // -- key encoders ---------------------------------------------------------------------
+
+  template <typename Bits, typename Key, unsigned int BITS>
+  static inline Key morton2D(uint32_t x, uint32_t y) {
+    const uint32_t mask = (uint32_t) ((1ull << BITS) - 1);
+    return (Key) (Bits::spread2(x & mask) | (Bits::spread2(y & mask) << 1));
+  }
+
+  template <typename Bits, typename Key, unsigned int BITS>
+  static inline Key morton3D(uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t mask = (1u << BITS) - 1;
+    return (Key) (Bits::spread3(x & mask) | (Bits::spread3(y & mask) << 1) | (Bits::spread3(z & mask) << 2));
+  }
+
+  /**
+   * @brief Hilbert index without a loop over levels: the curve's orientation state is propagated from the top bit
+   * down with a parallel prefix scan in log2(BITS) rounds, then the index bits are interleaved
+   * (http://threadlocalmutex.com/?p=126)
+   */
+  template <typename Bits, typename Key, unsigned int BITS>
+  static inline Key hilbert2D(uint32_t x, uint32_t y) {
+    const uint32_t mask = (uint32_t) ((1ull << BITS) - 1);
+    x &= mask;
+    y &= mask;
+
+    uint32_t a = x ^ y;
+    uint32_t b = mask ^ a;
+    uint32_t c = mask ^ (x | y);
+    uint32_t d = x & (y ^ mask);
+    uint32_t A = a | (b >> 1);
+    uint32_t B = (a >> 1) ^ a;
+    uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    for (unsigned int shift = 2; shift < BITS; shift <<= 1) {
+      a = A;
+      b = B;
+      c = C;
+      d = D;
+      if (2 * shift < BITS) {
+        A = (a & (a >> shift)) ^ (b & (b >> shift));
+        B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+      }
+      C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+      D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+    uint32_t i0 = x ^ y;
+    uint32_t i1 = b | (mask ^ (i0 | a));
+    return (Key) ((Bits::spread2(i1) << 1) | Bits::spread2(i0));
+  }
+
+  /**
+   * @brief Hilbert index in 3D: Skilling's transform of the coordinates into the "transposed" index, whose bits
+   * are then interleaved with x as the most significant of every triple
+   */
+  template <typename Bits, typename Key, unsigned int BITS>
+  static inline Key hilbert3D(uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t mask = (1u << BITS) - 1;
+    uint32_t axes[3] = { x & mask, y & mask, z & mask };
+
+    // branch free: the bit tests below are data dependent and would mispredict half the time
+    for (uint32_t q = 1u << (BITS - 1); q > 1; q >>= 1) {
+      uint32_t p = q - 1;
+      for (unsigned int i = 0; i < 3; i++) {
+        // set bit: invert the low bits of x, clear bit: exchange the low bits of x and this axis
+        uint32_t set = 0u - ((axes[i] & q) != 0);
+        uint32_t t = (axes[0] ^ axes[i]) & p & ~set;
+        axes[0] ^= (p & set) ^ t;
+        axes[i] ^= t;
+      }
+    }
+    axes[1] ^= axes[0];
+    axes[2] ^= axes[1];
+    uint32_t t = 0;
+    for (uint32_t q = 1u << (BITS - 1); q > 1; q >>= 1) t ^= (q - 1) & (0u - ((axes[2] & q) != 0));
+    for (unsigned int i = 0; i < 3; i++) axes[i] ^= t;
+
+    return (Key) (Bits::spread3(axes[2]) | (Bits::spread3(axes[1]) << 1) | (Bits::spread3(axes[0]) << 2));
+  }
+
+  uint32_t SpaceFillingCurve::mortonKey32(uint32_t x, uint32_t y) { return morton2D<PortableBits, uint32_t, BITS_2D_32>(x, y); }
+  uint64_t SpaceFillingCurve::mortonKey64(uint32_t x, uint32_t y) { return morton2D<PortableBits, uint64_t, BITS_2D_64>(x, y); }
+  uint32_t SpaceFillingCurve::mortonKey32(uint32_t x, uint32_t y, uint32_t z) { return morton3D<PortableBits, uint32_t, BITS_3D_32>(x, y, z); }
+  uint64_t SpaceFillingCurve::mortonKey64(uint32_t x, uint32_t y, uint32_t z) { return morton3D<PortableBits, uint64_t, BITS_3D_64>(x, y, z); }
+  uint32_t SpaceFillingCurve::hilbertKey32(uint32_t x, uint32_t y) { return hilbert2D<PortableBits, uint32_t, BITS_2D_32>(x, y); }
+  uint64_t SpaceFillingCurve::hilbertKey64(uint32_t x, uint32_t y) { return hilbert2D<PortableBits, uint64_t, BITS_2D_64>(x, y); }
+  uint32_t SpaceFillingCurve::hilbertKey32(uint32_t x, uint32_t y, uint32_t z) { return hilbert3D<PortableBits, uint32_t, BITS_3D_32>(x, y, z); }
+  uint64_t SpaceFillingCurve::hilbertKey64(uint32_t x, uint32_t y, uint32_t z) { return hilbert3D<PortableBits, uint64_t, BITS_3D_64>(x, y, z); }
+
+  // -- bulk keys ------------------------------------------------------------------------
+
+  // points bounded or encoded per pool task
+  static const size_t POINTS_PER_KEY_TASK = 1 << 16;
+
+  /**
+   * @brief Quantize count points to BITS per axis relative to minimum and encode them
+   */
+  template <typename Bits, typename Key, unsigned int BITS, typename Vector>
+  static inline void encodePoints(const Vector *points, size_t count, const double *minimum, double scale, CurveType curve, Key *keys) {
+    const unsigned int DIMENSIONS = sizeof(Vector) / sizeof(float);
+    for (size_t i = 0; i < count; i++) {
+      uint32_t cell[DIMENSIONS];
+      for (unsigned int d = 0; d < DIMENSIONS; d++) cell[d] = (uint32_t) ((points[i].vector[d] - minimum[d]) * scale);
+      if constexpr (DIMENSIONS == 2) {
+        keys[i] = curve == HILBERT_CURVE ? hilbert2D<Bits, Key, BITS>(cell[0], cell[1]) : morton2D<Bits, Key, BITS>(cell[0], cell[1]);
+      } else {
+        keys[i] = curve == HILBERT_CURVE ? hilbert3D<Bits, Key, BITS>(cell[0], cell[1], cell[2]) : morton3D<Bits, Key, BITS>(cell[0], cell[1], cell[2]);
+      }
+    }
+  }
+
+#ifdef COMPGEOM_X86
+  template <typename Key, unsigned int BITS, typename Vector>
+  BMI2_FLATTEN_TARGET static void encodePointsBmi2(const Vector *points, size_t count, const double *minimum, double scale, CurveType curve, Key *keys) {
+    encodePoints<PdepBits, Key, BITS>(points, count, minimum, scale, curve, keys);
+  }
+#endif
+
+  /**
+   * @brief Bounding box as a parallel reduction, then blocks of points encoded as pool tasks. Min and max are
+   * exact under any merge order, so the keys do not depend on the concurrency
+   */
+  template <typename Key, unsigned int BITS, typename Vector>
+  static void computeKeysFor(std::span<const Vector> points, CurveType curve, std::vector<Key> &keys) {
+    const unsigned int DIMENSIONS = sizeof(Vector) / sizeof(float);
+    keys.resize(points.size());
+    if (points.empty()) return;
+
+    struct Box {
+      float low[DIMENSIONS], high[DIMENSIONS];
+    };
+    Box empty;
+    for (unsigned int d = 0; d < DIMENSIONS; d++) {
+      empty.low[d] = std::numeric_limits<float>::infinity();
+      empty.high[d] = -std::numeric_limits<float>::infinity();
+    }
+    Box box = Parallel::parallelReduce(0, points.size(), POINTS_PER_KEY_TASK, empty, [&](size_t first, size_t last) {
+      Box part = empty;
+      for (size_t i = first; i < last; i++) {
+        for (unsigned int d = 0; d < DIMENSIONS; d++) {
+          part.low[d] = std::min(part.low[d], points[i].vector[d]);
+          part.high[d] = std::max(part.high[d], points[i].vector[d]);
+        }
+      }
+      return part;
+    }, [](Box left, const Box &right) {
+      for (unsigned int d = 0; d < DIMENSIONS; d++) {
+        left.low[d] = std::min(left.low[d], right.low[d]);
+        left.high[d] = std::max(left.high[d], right.high[d]);
+      }
+      return left;
+    });
+
+    double minimum[DIMENSIONS], extent = 0.0;
+    for (unsigned int d = 0; d < DIMENSIONS; d++) {
+      minimum[d] = box.low[d];
+      extent = std::max(extent, (double) box.high[d] - box.low[d]);
+    }
+    double scale = (double) ((1ull << BITS) - 1) / std::max(extent, 1e-30);
+
+    Parallel::parallelFor(0, points.size(), POINTS_PER_KEY_TASK, [&](size_t first, size_t last) {
+#ifdef COMPGEOM_X86
+      if (CpuFeatures::hasBMI2()) return encodePointsBmi2<Key, BITS>(points.data() + first, last - first, minimum, scale, curve, keys.data() + first);
+#endif
+      encodePoints<PortableBits, Key, BITS>(points.data() + first, last - first, minimum, scale, curve, keys.data() + first);
+    });
+  }
+
+  void SpaceFillingCurve::computeKeys(std::span<const Vector2D> points, CurveType curve, std::vector<uint32_t> &keys) {
+    computeKeysFor<uint32_t, BITS_2D_32>(points, curve, keys);
+  }
+
+  void SpaceFillingCurve::computeKeys(std::span<const Vector2D> points, CurveType curve, std::vector<uint64_t> &keys) {
+    computeKeysFor<uint64_t, BITS_2D_64>(points, curve, keys);
+  }
+
+  void SpaceFillingCurve::computeKeys(std::span<const Vector3D> points, CurveType curve, std::vector<uint32_t> &keys) {
+    computeKeysFor<uint32_t, BITS_3D_32>(points, curve, keys);
+  }
+
+  void SpaceFillingCurve::computeKeys(std::span<const Vector3D> points, CurveType curve, std::vector<uint64_t> &keys) {
+    computeKeysFor<uint64_t, BITS_3D_64>(points, curve, keys);
+  }
+
+  // -- radix sort -----------------------------------------------------------------------
+
+  // below this many keys per chunk a pass runs as fewer tasks
+  static const size_t MIN_KEYS_PER_TASK = 65536;
+
+  /**
+   * @brief Every pass counts the digit per chunk, turns the counts into write cursors and scatters (key, index)
+   * pairs between two buffers chunk by chunk, so equal digits keep their order. Keys and indices travel together
+   * so a scatter writes one stream per digit instead of two
+   */
+  template <typename Key>
+  static void radixSortKeys(std::span<const Key> input, std::vector<uint32_t> &order, unsigned int threadCount) {
+    struct KeyIndex {
+      Key key;
+      uint32_t index;
+    };
+
+    size_t n = input.size();
+    unsigned int chunks = Parallel::chunkCount(n, threadCount, MIN_KEYS_PER_TASK);
+
+    std::vector<KeyIndex> pairs(n), buffer(n);
+    for (size_t i = 0; i < n; i++) pairs[i] = { input[i], (uint32_t) i };
+    std::vector<uint32_t> histograms((size_t) chunks * 256);
+
+    for (unsigned int shift = 0; shift < 8 * sizeof(Key); shift += 8) {
+      std::fill(histograms.begin(), histograms.end(), 0);
+      Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+        uint32_t *histogram = histograms.data() + (size_t) chunk * 256;
+        for (size_t i = first; i < last; i++) histogram[(pairs[i].key >> shift) & 0xFF]++;
+      });
+
+      // exclusive prefix sum ordered by digit, then chunk; a digit every key shares leaves the order unchanged
+      uint32_t running = 0;
+      bool trivial = false;
+      for (unsigned int digit = 0; digit < 256; digit++) {
+        uint32_t digitStart = running;
+        for (unsigned int chunk = 0; chunk < chunks; chunk++) {
+          uint32_t &cursor = histograms[(size_t) chunk * 256 + digit];
+          uint32_t count = cursor;
+          cursor = running;
+          running += count;
+        }
+        trivial = trivial || running - digitStart == n;
+      }
+      if (trivial) continue;
+
+      Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+        uint32_t *cursors = histograms.data() + (size_t) chunk * 256;
+        for (size_t i = first; i < last; i++) buffer[cursors[(pairs[i].key >> shift) & 0xFF]++] = pairs[i];
+      });
+      pairs.swap(buffer);
+    }
+
+    order.resize(n);
+    for (size_t i = 0; i < n; i++) order[i] = pairs[i].index;
+  }
+
+  void SpaceFillingCurve::radixSort(std::span<const uint32_t> keys, std::vector<uint32_t> &order, unsigned int threadCount) {
+    radixSortKeys(keys, order, threadCount);
+  }
+
+  void SpaceFillingCurve::radixSort(std::span<const uint64_t> keys, std::vector<uint32_t> &order, unsigned int threadCount) {
+    radixSortKeys(keys, order, threadCount);
+  }
+
+  std::vector<uint32_t> SpaceFillingCurve::sortPoints(std::span<Vector2D> points, CurveType curve, unsigned int threadCount) {
+    std::vector<uint32_t> keys, order;
+    computeKeys(points, curve, keys);
+    radixSort(keys, order, threadCount);
+    applyPermutation(points, order);
+    return order;
+  }
+
+  std::vector<uint32_t> SpaceFillingCurve::sortPoints(std::span<Vector3D> points, CurveType curve, unsigned int threadCount) {
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;
+    computeKeys(points, curve, keys);
+    radixSort(keys, order, threadCount);
+    applyPermutation(points, order);
+    return order;
+  }
+}
@@ -0,0 +1,91 @@
+#ifndef SPACE_FILLING_CURVE_HPP
+#define SPACE_FILLING_CURVE_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../vectors.hpp"
+
+namespace Geometry {
+  enum CurveType {
+    MORTON_CURVE, HILBERT_CURVE
+  };
+
+  /**
+   * @brief Morton (Z-order) and Hilbert keys of integer cell coordinates and of point arrays, with a parallel
+   * LSD radix sort to put points in curve order. Morton keys interleave x on the lowest bit, then y (then z).
+   * Bulk key computation uses BMI2 pdep for the bit interleaving when the CPU has it.
+   */
+  class SpaceFillingCurve {
+    public:
+      // bits per axis held by each key width
+      static const unsigned int BITS_2D_32 = 16;
+      static const unsigned int BITS_2D_64 = 32;
+      static const unsigned int BITS_3D_32 = 10;
+      static const unsigned int BITS_3D_64 = 21;
+
+      static uint32_t mortonKey32(uint32_t x, uint32_t y);
+      static uint64_t mortonKey64(uint32_t x, uint32_t y);
+      static uint32_t mortonKey32(uint32_t x, uint32_t y, uint32_t z);
+      static uint64_t mortonKey64(uint32_t x, uint32_t y, uint32_t z);
+
+      static uint32_t hilbertKey32(uint32_t x, uint32_t y);
+      static uint64_t hilbertKey64(uint32_t x, uint32_t y);
+      static uint32_t hilbertKey32(uint32_t x, uint32_t y, uint32_t z);
+      static uint64_t hilbertKey64(uint32_t x, uint32_t y, uint32_t z);
+
+      /**
+       * @brief Key of every point, after quantizing the points' bounding box (same scale on every axis) to the
+       * bits per axis the key width holds
+       */
+      static void computeKeys(std::span<const Vector2D> points, CurveType curve, std::vector<uint32_t> &keys);
+      static void computeKeys(std::span<const Vector2D> points, CurveType curve, std::vector<uint64_t> &keys);
+      static void computeKeys(std::span<const Vector3D> points, CurveType curve, std::vector<uint32_t> &keys);
+      static void computeKeys(std::span<const Vector3D> points, CurveType curve, std::vector<uint64_t> &keys);
+
+      /**
+       * @brief Stable LSD radix sort, 8 bits per pass with passes over a digit all keys share skipped
+       *
+       * @param keys Keys to sort by, left untouched
+       * @param order Indices into keys in ascending key order
+       * @param threadCount Tasks to split the work into, 0 uses the global pool's concurrency
+       */
+      static void radixSort(std::span<const uint32_t> keys, std::vector<uint32_t> &order, unsigned int threadCount = 0);
+      static void radixSort(std::span<const uint64_t> keys, std::vector<uint32_t> &order, unsigned int threadCount = 0);
+
+      /**
+       * @brief Reorder values in place so values[i] becomes the old values[order[i]], following the permutation's
+       * cycles. order is used for bookkeeping while this runs and is restored afterwards
+       */
+      template <typename T>
+      static void applyPermutation(std::span<T> values, std::vector<uint32_t> &order) {
+        const uint32_t VISITED = 1u << 31;
+        for (size_t start = 0; start < values.size(); start++) {
+          if (order[start] & VISITED) continue;
+          T first = values[start];
+          size_t current = start;
+          while (true) {
+            size_t next = order[current];
+            order[current] |= VISITED;
+            if (next == start) {
+              values[current] = first;
+              break;
+            }
+            values[current] = values[next];
+            current = next;
+          }
+        }
+        for (uint32_t &index : order) index &= ~VISITED;
+      }
+
+      /**
+       * @brief Sort points in place along a curve (32-bit keys in 2D, 64-bit in 3D)
+       *
+       * @return Original index of every sorted point, to reorder data kept alongside them
+       */
+      static std::vector<uint32_t> sortPoints(std::span<Vector2D> points, CurveType curve = HILBERT_CURVE, unsigned int threadCount = 0);
+      static std::vector<uint32_t> sortPoints(std::span<Vector3D> points, CurveType curve = HILBERT_CURVE, unsigned int threadCount = 0);
+  };
+}
+
+#endif
@@ -0,0 +1,551 @@
+#include <atomic>
+#include "vector_math.hpp"
+
+#ifdef COMPGEOM_X86
+  # include <immintrin.h>
+#endif
+
+namespace Geometry {
+  /**
+   * @brief One implementation of every batch kernel. 2D and 3D add/sub/scale/lerp are element-wise,
+   * so they run over the arrays as flat floats
+   */
+  struct VectorKernels {
+    void (*addFloats)(const float *a, const float *b, float *out, size_t count);
+    void (*subFloats)(const float *a, const float *b, float *out, size_t count);
+    void (*scaleFloats)(const float *a, float s, float *out, size_t count);
+    void (*lerpFloats)(const float *a, const float *b, float t, float *out, size_t count);
+    void (*dot2)(const Vector2D *a, const Vector2D *b, float *out, size_t n);
+    void (*cross2)(const Vector2D *a, const Vector2D *b, float *out, size_t n);
+    void (*length2)(const Vector2D *a, float *out, size_t n);
+    void (*normalize2)(const Vector2D *a, Vector2D *out, size_t n);
+    void (*dot3)(const Vector3D *a, const Vector3D *b, float *out, size_t n);
+    void (*cross3)(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n);
+    void (*length3)(const Vector3D *a, float *out, size_t n);
+    void (*normalize3)(const Vector3D *a, Vector3D *out, size_t n);
+  };
+
+  // -- scalar ----------------------------------------------------------------
+
+  namespace Scalar {
+    static void addFloats(const float *a, const float *b, float *out, size_t count) {
+      for (size_t i = 0; i < count; i++) out[i] = a[i] + b[i];
+    }
+
+    static void subFloats(const float *a, const float *b, float *out, size_t count) {
+      for (size_t i = 0; i < count; i++) out[i] = a[i] - b[i];
+    }
+
+    static void scaleFloats(const float *a, float s, float *out, size_t count) {
+      for (size_t i = 0; i < count; i++) out[i] = a[i] * s;
+    }
+
+    static void lerpFloats(const float *a, const float *b, float t, float *out, size_t count) {
+      for (size_t i = 0; i < count; i++) out[i] = a[i] + t * (b[i] - a[i]);
+    }
+
+    static void dot2(const Vector2D *a, const Vector2D *b, float *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::dot(a[i], b[i]);
+    }
+
+    static void cross2(const Vector2D *a, const Vector2D *b, float *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::cross(a[i], b[i]);
+    }
+
+    static void length2(const Vector2D *a, float *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::length(a[i]);
+    }
+
+    static void normalize2(const Vector2D *a, Vector2D *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::normalize(a[i]);
+    }
+
+    static void dot3(const Vector3D *a, const Vector3D *b, float *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::dot(a[i], b[i]);
+    }
+
+    static void cross3(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::cross(a[i], b[i]);
+    }
+
+    static void length3(const Vector3D *a, float *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::length(a[i]);
+    }
+
+    static void normalize3(const Vector3D *a, Vector3D *out, size_t n) {
+      for (size_t i = 0; i < n; i++) out[i] = VectorMath::normalize(a[i]);
+    }
+  }
+
+  static const VectorKernels scalarKernels = {
+    Scalar::addFloats, Scalar::subFloats, Scalar::scaleFloats, Scalar::lerpFloats,
+    Scalar::dot2, Scalar::cross2, Scalar::length2, Scalar::normalize2,
+    Scalar::dot3, Scalar::cross3, Scalar::length3, Scalar::normalize3
+  };
+
+#ifdef COMPGEOM_X86
+  // -- SSE2, 4 floats / 4 points per iteration --------------------------------
+
+  namespace Sse2 {
+    static void addFloats(const float *a, const float *b, float *out, size_t count) {
+      size_t i = 0;
+      for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+      }
+      Scalar::addFloats(a + i, b + i, out + i, count - i);
+    }
+
+    static void subFloats(const float *a, const float *b, float *out, size_t count) {
+      size_t i = 0;
+      for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+      }
+      Scalar::subFloats(a + i, b + i, out + i, count - i);
+    }
+
+    static void scaleFloats(const float *a, float s, float *out, size_t count) {
+      __m128 scale = _mm_set1_ps(s);
+      size_t i = 0;
+      for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), scale));
+      }
+      Scalar::scaleFloats(a + i, s, out + i, count - i);
+    }
+
+    static void lerpFloats(const float *a, const float *b, float t, float *out, size_t count) {
+      __m128 factor = _mm_set1_ps(t);
+      size_t i = 0;
+      for (; i + 4 <= count; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(factor, _mm_sub_ps(vb, va))));
+      }
+      Scalar::lerpFloats(a + i, b + i, t, out + i, count - i);
+    }
+
+    /**
+     * @brief Sum the x and y halves of two interleaved registers (2 points each) into 4 per-point values
+     */
+    static inline __m128 pairSum(__m128 lo, __m128 hi) {
+      return _mm_add_ps(
+        _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))
+      );
+    }
+
+    static void dot2(const Vector2D *a, const Vector2D *b, float *out, size_t n) {
+      const float *fa = (const float *) a;
+      const float *fb = (const float *) b;
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(fa + 2 * i), _mm_loadu_ps(fb + 2 * i));
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(fa + 2 * i + 4), _mm_loadu_ps(fb + 2 * i + 4));
+        _mm_storeu_ps(out + i, pairSum(lo, hi));
+      }
+      Scalar::dot2(a + i, b + i, out + i, n - i);
+    }
+
+    static void cross2(const Vector2D *a, const Vector2D *b, float *out, size_t n) {
+      const float *fa = (const float *) a;
+      const float *fb = (const float *) b;
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        // (ax * by, ay * bx) per point
+        __m128 bLo = _mm_loadu_ps(fb + 2 * i);
+        __m128 bHi = _mm_loadu_ps(fb + 2 * i + 4);
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(fa + 2 * i), _mm_shuffle_ps(bLo, bLo, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(fa + 2 * i + 4), _mm_shuffle_ps(bHi, bHi, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm_storeu_ps(out + i, _mm_sub_ps(
+          _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)),
+          _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))
+        ));
+      }
+      Scalar::cross2(a + i, b + i, out + i, n - i);
+    }
+
+    static void length2(const Vector2D *a, float *out, size_t n) {
+      const float *fa = (const float *) a;
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 lo = _mm_loadu_ps(fa + 2 * i);
+        __m128 hi = _mm_loadu_ps(fa + 2 * i + 4);
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(pairSum(_mm_mul_ps(lo, lo), _mm_mul_ps(hi, hi))));
+      }
+      Scalar::length2(a + i, out + i, n - i);
+    }
+
+    /**
+     * @brief 1 / length, or 1 where the length is zero so zero vectors pass through like the scalar path
+     */
+    static inline __m128 inverseLength(__m128 lengthSquared) {
+      __m128 len = _mm_sqrt_ps(lengthSquared);
+      __m128 nonZero = _mm_cmpgt_ps(len, _mm_setzero_ps());
+      __m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), len);
+      return _mm_or_ps(_mm_and_ps(nonZero, inverse), _mm_andnot_ps(nonZero, _mm_set1_ps(1.0f)));
+    }
+
+    static void normalize2(const Vector2D *a, Vector2D *out, size_t n) {
+      const float *fa = (const float *) a;
+      float *fo = (float *) out;
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 lo = _mm_loadu_ps(fa + 2 * i);
+        __m128 hi = _mm_loadu_ps(fa + 2 * i + 4);
+        __m128 inverse = inverseLength(pairSum(_mm_mul_ps(lo, lo), _mm_mul_ps(hi, hi)));
+        _mm_storeu_ps(fo + 2 * i, _mm_mul_ps(lo, _mm_unpacklo_ps(inverse, inverse)));
+        _mm_storeu_ps(fo + 2 * i + 4, _mm_mul_ps(hi, _mm_unpackhi_ps(inverse, inverse)));
+      }
+      Scalar::normalize2(a + i, out + i, n - i);
+    }
+
+    /**
+     * @brief Transpose 4 interleaved xyz points (3 registers) into x, y and z registers
+     */
+    static inline void loadXYZ(const float *p, __m128 &x, __m128 &y, __m128 &z) {
+      __m128 m0 = _mm_loadu_ps(p);     // x0 y0 z0 x1
+      __m128 m1 = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+      __m128 m2 = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+      __m128 t = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+      __m128 u = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+      x = _mm_shuffle_ps(m0, t, _MM_SHUFFLE(2, 0, 3, 0));
+      y = _mm_shuffle_ps(u, t, _MM_SHUFFLE(3, 1, 2, 0));
+      z = _mm_shuffle_ps(u, m2, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+
+    /**
+     * @brief Inverse of loadXYZ, interleave x, y and z registers back into 4 xyz points
+     */
+    static inline void storeXYZ(float *p, __m128 x, __m128 y, __m128 z) {
+      __m128 xyLo = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+      __m128 xyHi = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+      __m128 z0x1 = _mm_shuffle_ps(z, xyLo, _MM_SHUFFLE(2, 2, 0, 0));
+      __m128 y1z1 = _mm_shuffle_ps(xyLo, z, _MM_SHUFFLE(1, 1, 3, 3));
+      __m128 z2x3 = _mm_shuffle_ps(z, xyHi, _MM_SHUFFLE(2, 2, 2, 2));
+      __m128 y3z3 = _mm_shuffle_ps(xyHi, z, _MM_SHUFFLE(3, 3, 3, 3));
+      _mm_storeu_ps(p, _mm_shuffle_ps(xyLo, z0x1, _MM_SHUFFLE(2, 0, 1, 0)));
+      _mm_storeu_ps(p + 4, _mm_shuffle_ps(y1z1, xyHi, _MM_SHUFFLE(1, 0, 2, 0)));
+      _mm_storeu_ps(p + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+
+    static inline __m128 dot3(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+      return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+    }
+
+    static void dot3(const Vector3D *a, const Vector3D *b, float *out, size_t n) {
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 ax, ay, az, bx, by, bz;
+        loadXYZ((const float *) (a + i), ax, ay, az);
+        loadXYZ((const float *) (b + i), bx, by, bz);
+        _mm_storeu_ps(out + i, dot3(ax, ay, az, bx, by, bz));
+      }
+      Scalar::dot3(a + i, b + i, out + i, n - i);
+    }
+
+    static void cross3(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n) {
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 ax, ay, az, bx, by, bz;
+        loadXYZ((const float *) (a + i), ax, ay, az);
+        loadXYZ((const float *) (b + i), bx, by, bz);
+        storeXYZ((float *) (out + i),
+          _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)),
+          _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)),
+          _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+      }
+      Scalar::cross3(a + i, b + i, out + i, n - i);
+    }
+
+    static void length3(const Vector3D *a, float *out, size_t n) {
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 x, y, z;
+        loadXYZ((const float *) (a + i), x, y, z);
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(dot3(x, y, z, x, y, z)));
+      }
+      Scalar::length3(a + i, out + i, n - i);
+    }
+
+    static void normalize3(const Vector3D *a, Vector3D *out, size_t n) {
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 x, y, z;
+        loadXYZ((const float *) (a + i), x, y, z);
+        __m128 inverse = inverseLength(dot3(x, y, z, x, y, z));
+        storeXYZ((float *) (out + i), _mm_mul_ps(x, inverse), _mm_mul_ps(y, inverse), _mm_mul_ps(z, inverse));
+      }
+      Scalar::normalize3(a + i, out + i, n - i);
+    }
+  }
+
+  static const VectorKernels sse2Kernels = {
+    Sse2::addFloats, Sse2::subFloats, Sse2::scaleFloats, Sse2::lerpFloats,
+    Sse2::dot2, Sse2::cross2, Sse2::length2, Sse2::normalize2,
+    Sse2::dot3, Sse2::cross3, Sse2::length3, Sse2::normalize3
+  };
+
+  // -- AVX2, 8 floats / 8 points per iteration --------------------------------
+
+  #define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+  namespace Avx2 {
+    AVX2_TARGET static void addFloats(const float *a, const float *b, float *out, size_t count) {
+      size_t i = 0;
+      for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+      }
+      Scalar::addFloats(a + i, b + i, out + i, count - i);
+    }
+
+    AVX2_TARGET static void subFloats(const float *a, const float *b, float *out, size_t count) {
+      size_t i = 0;
+      for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+      }
+      Scalar::subFloats(a + i, b + i, out + i, count - i);
+    }
+
+    AVX2_TARGET static void scaleFloats(const float *a, float s, float *out, size_t count) {
+      __m256 scale = _mm256_set1_ps(s);
+      size_t i = 0;
+      for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), scale));
+      }
+      Scalar::scaleFloats(a + i, s, out + i, count - i);
+    }
+
+    AVX2_TARGET static void lerpFloats(const float *a, const float *b, float t, float *out, size_t count) {
+      __m256 factor = _mm256_set1_ps(t);
+      size_t i = 0;
+      for (; i + 8 <= count; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(factor, _mm256_sub_ps(vb, va), va));
+      }
+      Scalar::lerpFloats(a + i, b + i, t, out + i, count - i);
+    }
+
+    /**
+     * @brief hadd of two interleaved registers yields points in [0 1 4 5 | 2 3 6 7] order, restore 0..7
+     */
+    AVX2_TARGET static inline __m256 inPointOrder(__m256 v) {
+      return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), 0xD8));
+    }
+
+    AVX2_TARGET static void dot2(const Vector2D *a, const Vector2D *b, float *out, size_t n) {
+      const float *fa = (const float *) a;
+      const float *fb = (const float *) b;
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 lo = _mm256_mul_ps(_mm256_loadu_ps(fa + 2 * i), _mm256_loadu_ps(fb + 2 * i));
+        __m256 hi = _mm256_mul_ps(_mm256_loadu_ps(fa + 2 * i + 8), _mm256_loadu_ps(fb + 2 * i + 8));
+        _mm256_storeu_ps(out + i, inPointOrder(_mm256_hadd_ps(lo, hi)));
+      }
+      Scalar::dot2(a + i, b + i, out + i, n - i);
+    }
+
+    AVX2_TARGET static void cross2(const Vector2D *a, const Vector2D *b, float *out, size_t n) {
+      const float *fa = (const float *) a;
+      const float *fb = (const float *) b;
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 lo = _mm256_mul_ps(_mm256_loadu_ps(fa + 2 * i), _mm256_permute_ps(_mm256_loadu_ps(fb + 2 * i), 0xB1));
+        __m256 hi = _mm256_mul_ps(_mm256_loadu_ps(fa + 2 * i + 8), _mm256_permute_ps(_mm256_loadu_ps(fb + 2 * i + 8), 0xB1));
+        _mm256_storeu_ps(out + i, inPointOrder(_mm256_hsub_ps(lo, hi)));
+      }
+      Scalar::cross2(a + i, b + i, out + i, n - i);
+    }
+
+    AVX2_TARGET static void length2(const Vector2D *a, float *out, size_t n) {
+      const float *fa = (const float *) a;
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 lo = _mm256_loadu_ps(fa + 2 * i);
+        __m256 hi = _mm256_loadu_ps(fa + 2 * i + 8);
+        __m256 lengthSquared = _mm256_hadd_ps(_mm256_mul_ps(lo, lo), _mm256_mul_ps(hi, hi));
+        _mm256_storeu_ps(out + i, inPointOrder(_mm256_sqrt_ps(lengthSquared)));
+      }
+      Scalar::length2(a + i, out + i, n - i);
+    }
+
+    AVX2_TARGET static inline __m256 inverseLength(__m256 lengthSquared) {
+      __m256 len = _mm256_sqrt_ps(lengthSquared);
+      __m256 nonZero = _mm256_cmp_ps(len, _mm256_setzero_ps(), _CMP_GT_OQ);
+      return _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_div_ps(_mm256_set1_ps(1.0f), len), nonZero);
+    }
+
+    AVX2_TARGET static void normalize2(const Vector2D *a, Vector2D *out, size_t n) {
+      const float *fa = (const float *) a;
+      float *fo = (float *) out;
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 lo = _mm256_loadu_ps(fa + 2 * i);
+        __m256 hi = _mm256_loadu_ps(fa + 2 * i + 8);
+        // hadd order [0 1 4 5 | 2 3 6 7] unpacks straight back into the interleaved layout
+        __m256 inverse = inverseLength(_mm256_hadd_ps(_mm256_mul_ps(lo, lo), _mm256_mul_ps(hi, hi)));
+        _mm256_storeu_ps(fo + 2 * i, _mm256_mul_ps(lo, _mm256_unpacklo_ps(inverse, inverse)));
+        _mm256_storeu_ps(fo + 2 * i + 8, _mm256_mul_ps(hi, _mm256_unpackhi_ps(inverse, inverse)));
+      }
+      Scalar::normalize2(a + i, out + i, n - i);
+    }
+
+    /**
+     * @brief Transpose 8 interleaved xyz points into x, y and z registers, two SSE transposes per load
+     */
+    AVX2_TARGET static inline void loadXYZ(const float *p, __m256 &x, __m256 &y, __m256 &z) {
+      __m128 x0, y0, z0, x1, y1, z1;
+      Sse2::loadXYZ(p, x0, y0, z0);
+      Sse2::loadXYZ(p + 12, x1, y1, z1);
+      x = _mm256_set_m128(x1, x0);
+      y = _mm256_set_m128(y1, y0);
+      z = _mm256_set_m128(z1, z0);
+    }
+
+    AVX2_TARGET static inline void storeXYZ(float *p, __m256 x, __m256 y, __m256 z) {
+      Sse2::storeXYZ(p, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z));
+      Sse2::storeXYZ(p + 12, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1));
+    }
+
+    AVX2_TARGET static inline __m256 dot3(__m256 ax, __m256 ay, __m256 az, __m256 bx, __m256 by, __m256 bz) {
+      return _mm256_fmadd_ps(az, bz, _mm256_fmadd_ps(ay, by, _mm256_mul_ps(ax, bx)));
+    }
+
+    AVX2_TARGET static void dot3(const Vector3D *a, const Vector3D *b, float *out, size_t n) {
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 ax, ay, az, bx, by, bz;
+        loadXYZ((const float *) (a + i), ax, ay, az);
+        loadXYZ((const float *) (b + i), bx, by, bz);
+        _mm256_storeu_ps(out + i, dot3(ax, ay, az, bx, by, bz));
+      }
+      Scalar::dot3(a + i, b + i, out + i, n - i);
+    }
+
+    AVX2_TARGET static void cross3(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n) {
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 ax, ay, az, bx, by, bz;
+        loadXYZ((const float *) (a + i), ax, ay, az);
+        loadXYZ((const float *) (b + i), bx, by, bz);
+        storeXYZ((float *) (out + i),
+          _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by)),
+          _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz)),
+          _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx)));
+      }
+      Scalar::cross3(a + i, b + i, out + i, n - i);
+    }
+
+    AVX2_TARGET static void length3(const Vector3D *a, float *out, size_t n) {
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 x, y, z;
+        loadXYZ((const float *) (a + i), x, y, z);
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(dot3(x, y, z, x, y, z)));
+      }
+      Scalar::length3(a + i, out + i, n - i);
+    }
+
+    AVX2_TARGET static void normalize3(const Vector3D *a, Vector3D *out, size_t n) {
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 x, y, z;
+        loadXYZ((const float *) (a + i), x, y, z);
+        __m256 inverse = inverseLength(dot3(x, y, z, x, y, z));
+        storeXYZ((float *) (out + i), _mm256_mul_ps(x, inverse), _mm256_mul_ps(y, inverse), _mm256_mul_ps(z, inverse));
+      }
+      Scalar::normalize3(a + i, out + i, n - i);
+    }
+  }
+
+  static const VectorKernels avx2Kernels = {
+    Avx2::addFloats, Avx2::subFloats, Avx2::scaleFloats, Avx2::lerpFloats,
+    Avx2::dot2, Avx2::cross2, Avx2::length2, Avx2::normalize2,
+    Avx2::dot3, Avx2::cross3, Avx2::length3, Avx2::normalize3
+  };
+#endif
+
+  // -- dispatch ---------------------------------------------------------------
+
+  static const VectorKernels *kernelsFor(SimdLevel level) {
+#ifdef COMPGEOM_X86
+    switch (level) {
+      case SIMD_AVX2: return &avx2Kernels;
+      case SIMD_SSE2: return &sse2Kernels;
+      case SIMD_SCALAR: return &scalarKernels;
+    }
+#endif
+    (void) level;
+    return &scalarKernels;
+  }
+
+  static SimdLevel levelOf(const VectorKernels *kernels) {
+#ifdef COMPGEOM_X86
+    if (kernels == &avx2Kernels) return SIMD_AVX2;
+    if (kernels == &sse2Kernels) return SIMD_SSE2;
+#endif
+    (void) kernels;
+    return SIMD_SCALAR;
+  }
+
+  // NULL until the first batch call resolves it. Constant initialised, so batch calls made from static
+  // initialisers in other files are safe, and atomic since setSimdLevel may run while pool workers dispatch
+  static std::atomic<const VectorKernels *> activeTable(NULL);
+
+  static const VectorKernels *activeKernels() {
+    const VectorKernels *kernels = activeTable.load(std::memory_order_acquire);
+    if (kernels != NULL) return kernels;
+    const VectorKernels *detected = kernelsFor(CpuFeatures::detectSimdLevel());
+    // a table forced by setSimdLevel in the meantime wins, and is left in kernels
+    if (activeTable.compare_exchange_strong(kernels, detected, std::memory_order_acq_rel)) kernels = detected;
+    return kernels;
+  }
+
+  SimdLevel VectorBatch::getSimdLevel() { return levelOf(activeKernels()); }
+
+  void VectorBatch::setSimdLevel(SimdLevel level) {
+    SimdLevel detected = CpuFeatures::detectSimdLevel();
+    activeTable.store(kernelsFor(level > detected ? detected : level), std::memory_order_release);
+  }
+
+  void VectorBatch::add(const Vector2D *a, const Vector2D *b, Vector2D *out, size_t n) {
+    activeKernels()->addFloats((const float *) a, (const float *) b, (float *) out, 2 * n);
+  }
+
+  void VectorBatch::sub(const Vector2D *a, const Vector2D *b, Vector2D *out, size_t n) {
+    activeKernels()->subFloats((const float *) a, (const float *) b, (float *) out, 2 * n);
+  }
+
+  void VectorBatch::scale(const Vector2D *a, float s, Vector2D *out, size_t n) {
+    activeKernels()->scaleFloats((const float *) a, s, (float *) out, 2 * n);
+  }
+
+  void VectorBatch::dot(const Vector2D *a, const Vector2D *b, float *out, size_t n) { activeKernels()->dot2(a, b, out, n); }
+  void VectorBatch::cross(const Vector2D *a, const Vector2D *b, float *out, size_t n) { activeKernels()->cross2(a, b, out, n); }
+  void VectorBatch::length(const Vector2D *a, float *out, size_t n) { activeKernels()->length2(a, out, n); }
+  void VectorBatch::normalize(const Vector2D *a, Vector2D *out, size_t n) { activeKernels()->normalize2(a, out, n); }
+
+  void VectorBatch::lerp(const Vector2D *a, const Vector2D *b, float t, Vector2D *out, size_t n) {
+    activeKernels()->lerpFloats((const float *) a, (const float *) b, t, (float *) out, 2 * n);
+  }
+
+  void VectorBatch::add(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n) {
+    activeKernels()->addFloats((const float *) a, (const float *) b, (float *) out, 3 * n);
+  }
+
+  void VectorBatch::sub(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n) {
+    activeKernels()->subFloats((const float *) a, (const float *) b, (float *) out, 3 * n);
+  }
+
+  void VectorBatch::scale(const Vector3D *a, float s, Vector3D *out, size_t n) {
+    activeKernels()->scaleFloats((const float *) a, s, (float *) out, 3 * n);
+  }
+
+  void VectorBatch::dot(const Vector3D *a, const Vector3D *b, float *out, size_t n) { activeKernels()->dot3(a, b, out, n); }
+  void VectorBatch::cross(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n) { activeKernels()->cross3(a, b, out, n); }
+  void VectorBatch::length(const Vector3D *a, float *out, size_t n) { activeKernels()->length3(a, out, n); }
+  void VectorBatch::normalize(const Vector3D *a, Vector3D *out, size_t n) { activeKernels()->normalize3(a, out, n); }
+
+  void VectorBatch::lerp(const Vector3D *a, const Vector3D *b, float t, Vector3D *out, size_t n) {
+    activeKernels()->lerpFloats((const float *) a, (const float *) b, t, (float *) out, 3 * n);
+  }
+}
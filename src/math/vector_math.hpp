@@ -0,0 +1,133 @@
+#ifndef VECTOR_MATH_HPP
+#define VECTOR_MATH_HPP
+
+#include <cmath>
+#include <cstddef>
+#include "cpu_features.hpp"
+#include "../vectors.hpp"
+
+namespace Geometry {
+  /**
+   * @brief Single vector operations on Vector2D/Vector3D
+   */
+  class VectorMath {
+    public:
+      static Vector2D add(const Vector2D &a, const Vector2D &b) {
+        return { { a.vector[0] + b.vector[0], a.vector[1] + b.vector[1] } };
+      }
+
+      static Vector2D sub(const Vector2D &a, const Vector2D &b) {
+        return { { a.vector[0] - b.vector[0], a.vector[1] - b.vector[1] } };
+      }
+
+      static Vector2D scale(const Vector2D &a, float s) {
+        return { { a.vector[0] * s, a.vector[1] * s } };
+      }
+
+      static float dot(const Vector2D &a, const Vector2D &b) {
+        return a.vector[0] * b.vector[0] + a.vector[1] * b.vector[1];
+      }
+
+      /**
+       * @brief z component of the 3D cross product, positive when b is counterclockwise from a
+       */
+      static float cross(const Vector2D &a, const Vector2D &b) {
+        return a.vector[0] * b.vector[1] - a.vector[1] * b.vector[0];
+      }
+
+      static float length(const Vector2D &a) {
+        return std::sqrt(dot(a, a));
+      }
+
+      /**
+       * @brief Unit vector in the direction of a, the zero vector stays zero
+       */
+      static Vector2D normalize(const Vector2D &a) {
+        float len = length(a);
+        return len > 0.0f ? scale(a, 1.0f / len) : a;
+      }
+
+      static Vector2D lerp(const Vector2D &a, const Vector2D &b, float t) {
+        return { { a.vector[0] + t * (b.vector[0] - a.vector[0]), a.vector[1] + t * (b.vector[1] - a.vector[1]) } };
+      }
+
+      static Vector3D add(const Vector3D &a, const Vector3D &b) {
+        return { { a.vector[0] + b.vector[0], a.vector[1] + b.vector[1], a.vector[2] + b.vector[2] } };
+      }
+
+      static Vector3D sub(const Vector3D &a, const Vector3D &b) {
+        return { { a.vector[0] - b.vector[0], a.vector[1] - b.vector[1], a.vector[2] - b.vector[2] } };
+      }
+
+      static Vector3D scale(const Vector3D &a, float s) {
+        return { { a.vector[0] * s, a.vector[1] * s, a.vector[2] * s } };
+      }
+
+      static float dot(const Vector3D &a, const Vector3D &b) {
+        return a.vector[0] * b.vector[0] + a.vector[1] * b.vector[1] + a.vector[2] * b.vector[2];
+      }
+
+      static Vector3D cross(const Vector3D &a, const Vector3D &b) {
+        return { {
+          a.vector[1] * b.vector[2] - a.vector[2] * b.vector[1],
+          a.vector[2] * b.vector[0] - a.vector[0] * b.vector[2],
+          a.vector[0] * b.vector[1] - a.vector[1] * b.vector[0]
+        } };
+      }
+
+      static float length(const Vector3D &a) {
+        return std::sqrt(dot(a, a));
+      }
+
+      static Vector3D normalize(const Vector3D &a) {
+        float len = length(a);
+        return len > 0.0f ? scale(a, 1.0f / len) : a;
+      }
+
+      static Vector3D lerp(const Vector3D &a, const Vector3D &b, float t) {
+        return { {
+          a.vector[0] + t * (b.vector[0] - a.vector[0]),
+          a.vector[1] + t * (b.vector[1] - a.vector[1]),
+          a.vector[2] + t * (b.vector[2] - a.vector[2])
+        } };
+      }
+  };
+
+  /**
+   * @brief Kernels over contiguous vector arrays. Each call is dispatched to the widest implementation
+   * the CPU supports (AVX2, SSE2 or scalar), picked once via CPUID. Output arrays may alias inputs.
+   */
+  class VectorBatch {
+    public:
+      static void add(const Vector2D *a, const Vector2D *b, Vector2D *out, size_t n);
+      static void sub(const Vector2D *a, const Vector2D *b, Vector2D *out, size_t n);
+      static void scale(const Vector2D *a, float s, Vector2D *out, size_t n);
+      static void dot(const Vector2D *a, const Vector2D *b, float *out, size_t n);
+      static void cross(const Vector2D *a, const Vector2D *b, float *out, size_t n);
+      static void length(const Vector2D *a, float *out, size_t n);
+      static void normalize(const Vector2D *a, Vector2D *out, size_t n);
+      static void lerp(const Vector2D *a, const Vector2D *b, float t, Vector2D *out, size_t n);
+
+      static void add(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n);
+      static void sub(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n);
+      static void scale(const Vector3D *a, float s, Vector3D *out, size_t n);
+      static void dot(const Vector3D *a, const Vector3D *b, float *out, size_t n);
+      static void cross(const Vector3D *a, const Vector3D *b, Vector3D *out, size_t n);
+      static void length(const Vector3D *a, float *out, size_t n);
+      static void normalize(const Vector3D *a, Vector3D *out, size_t n);
+      static void lerp(const Vector3D *a, const Vector3D *b, float t, Vector3D *out, size_t n);
+
+      /**
+       * @brief Implementation currently dispatched to
+       */
+      static SimdLevel getSimdLevel();
+
+      /**
+       * @brief Force an implementation, e.g. to benchmark them side by side. Levels the CPU
+       * does not support are clamped to the detected one
+       */
+      static void setSimdLevel(SimdLevel level);
+  };
+}
+
+#endif
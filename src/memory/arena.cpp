@@ -0,0 +1,37 @@
+#include <algorithm>
+#include <cstdint>
+#include "arena.hpp"
+
+namespace Memory {
+  BumpArena::~BumpArena() {
+    this->reset();
+  }
+
+  void *BumpArena::allocate(size_t size, size_t align) {
+    uintptr_t address = ((uintptr_t) this->cursor + (align - 1)) & ~(uintptr_t) (align - 1);
+    if (this->cursor == NULL || address + size > (uintptr_t) this->end) {
+      // oversized requests get a block of their own
+      size_t blockBytes = std::max(this->blockSize, size + align);
+      char *block = (char *) ::operator new(blockBytes);
+      this->blocks.push_back(block);
+      this->bytesReserved += blockBytes;
+      this->cursor = block;
+      this->end = block + blockBytes;
+      address = ((uintptr_t) this->cursor + (align - 1)) & ~(uintptr_t) (align - 1);
+    }
+    this->cursor = (char *) (address + size);
+    return (void *) address;
+  }
+
+  void BumpArena::reset() {
+    for (char *block : this->blocks) ::operator delete(block);
+    this->blocks.clear();
+    this->cursor = NULL;
+    this->end = NULL;
+    this->bytesReserved = 0;
+  }
+
+  size_t BumpArena::getBytesReserved() {
+    return this->bytesReserved;
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Memory {
+  /**
+   * @brief Bump allocator: objects are carved out of large blocks by advancing a pointer and are never freed
+   * one by one, the whole arena is released at once by reset() or the destructor. Only trivially destructible
+   * objects should live here since no destructors are run.
+   */
+  class BumpArena {
+    public:
+      static const size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+      BumpArena(size_t blockSize = DEFAULT_BLOCK_SIZE) : blockSize(blockSize) {};
+      ~BumpArena();
+      BumpArena(const BumpArena&) = delete;
+      BumpArena &operator=(const BumpArena&) = delete;
+
+      /**
+       * @brief Raw storage for size bytes aligned to align (a power of two)
+       */
+      void *allocate(size_t size, size_t align);
+
+      template <typename T, typename... Args>
+      T *create(Args&&... args) {
+        return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+      }
+
+      /**
+       * @brief Release every block, invalidating all objects handed out so far
+       */
+      void reset();
+
+      size_t getBytesReserved();
+    private:
+      size_t blockSize;
+      std::vector<char *> blocks;
+      char *cursor = NULL;
+      char *end = NULL;
+      size_t bytesReserved = 0;
+  };
+
+  /**
+   * @brief Typed free list on top of a BumpArena, for node types that are created and dropped many times:
+   * released nodes are reused before the arena grows, which bounds memory by the peak live count
+   */
+  template <typename T>
+  class NodePool {
+    public:
+      NodePool(BumpArena &arena) : arena(arena) {};
+
+      template <typename... Args>
+      T *create(Args&&... args) {
+        if (this->freeList.empty()) return this->arena.create<T>(std::forward<Args>(args)...);
+        T *node = this->freeList.back();
+        this->freeList.pop_back();
+        return new (node) T(std::forward<Args>(args)...);
+      }
+
+      void release(T *node) { this->freeList.push_back(node); }
+    private:
+      BumpArena &arena;
+      std::vector<T *> freeList;
+  };
+}
+
+#endif
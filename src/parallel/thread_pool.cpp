@@ -0,0 +1,180 @@
+#include <cstdlib>
+#include "thread_pool.hpp"
+#include "work_stealing_deque.hpp"
+
+namespace Parallel {
+  struct ThreadPool::Worker {
+    ThreadPool *pool;
+    WorkStealingDeque deque;
+    // where the next steal attempt starts, rotated so thieves spread over the victims
+    size_t nextVictim;
+  };
+
+  thread_local ThreadPool::Worker *ThreadPool::currentWorker = NULL;
+
+  static std::mutex globalLock;
+  static std::unique_ptr<ThreadPool> globalOwner;
+  static std::atomic<ThreadPool *> globalPool(NULL);
+
+  ThreadPool::ThreadPool(unsigned int concurrency) : queued(0), sleeping(0), stopping(false) {
+    if (concurrency == 0) concurrency = std::max(1u, std::thread::hardware_concurrency());
+    this->concurrency = concurrency;
+    if (concurrency == 1) return;
+
+    for (unsigned int i = 0; i + 1 < concurrency; i++) {
+      this->workers.emplace_back(new Worker());
+      this->workers.back()->pool = this;
+      this->workers.back()->nextVictim = i + 1;
+    }
+    for (std::unique_ptr<Worker> &worker : this->workers) {
+      this->threads.emplace_back(&ThreadPool::workerLoop, this, worker.get());
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> guard(this->sleepLock);
+      this->stopping.store(true);
+    }
+    this->wake.notify_all();
+    for (std::thread &thread : this->threads) thread.join();
+  }
+
+  unsigned int ThreadPool::getConcurrency() const {
+    return this->concurrency;
+  }
+
+  bool ThreadPool::isSerial() const {
+    return this->concurrency == 1;
+  }
+
+  ThreadPool &ThreadPool::global() {
+    ThreadPool *pool = globalPool.load(std::memory_order_acquire);
+    if (pool != NULL) return *pool;
+
+    std::lock_guard<std::mutex> guard(globalLock);
+    if (globalOwner == NULL) {
+      const char *setting = std::getenv("COMPGEOM_THREADS");
+      unsigned int concurrency = setting != NULL ? (unsigned int) std::strtoul(setting, NULL, 10) : 0;
+      globalOwner.reset(new ThreadPool(concurrency));
+      globalPool.store(globalOwner.get(), std::memory_order_release);
+    }
+    return *globalOwner;
+  }
+
+  void ThreadPool::setGlobalConcurrency(unsigned int concurrency) {
+    std::lock_guard<std::mutex> guard(globalLock);
+    globalPool.store(NULL, std::memory_order_release);
+    globalOwner.reset(new ThreadPool(concurrency));
+    globalPool.store(globalOwner.get(), std::memory_order_release);
+  }
+
+  void ThreadPool::submit(Task *task, TaskGroup *group) {
+    task->group = group;
+    Worker *self = currentWorker;
+    if (self != NULL && self->pool == this) {
+      self->deque.push(task);
+    } else {
+      std::lock_guard<std::mutex> guard(this->injectedLock);
+      this->injected.push_back(task);
+    }
+
+    // pairs with the sleeping increment in workerLoop, one of the two sides always sees the other
+    this->queued.fetch_add(1);
+    if (this->sleeping.load() > 0) {
+      std::lock_guard<std::mutex> guard(this->sleepLock);
+      this->wake.notify_one();
+    }
+  }
+
+  /**
+   * @brief Own deque first (newest task, still warm in cache), then the shared queue, then the oldest task of
+   * another worker, which tends to be the largest piece of work it has left
+   */
+  Task *ThreadPool::findTask(Worker *self) {
+    Task *task = self != NULL ? self->deque.pop() : NULL;
+
+    if (task == NULL) {
+      std::lock_guard<std::mutex> guard(this->injectedLock);
+      if (!this->injected.empty()) {
+        task = this->injected.front();
+        this->injected.pop_front();
+      }
+    }
+
+    size_t workerCount = this->workers.size();
+    size_t start = self != NULL ? self->nextVictim++ : 0;
+    for (size_t i = 0; task == NULL && i < workerCount; i++) {
+      Worker *victim = this->workers[(start + i) % workerCount].get();
+      if (victim != self) task = victim->deque.steal();
+    }
+
+    if (task != NULL) this->queued.fetch_sub(1);
+    return task;
+  }
+
+  void ThreadPool::execute(Task *task) {
+    TaskGroup *group = task->group;
+    try {
+      task->execute();
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(group->errorLock);
+      if (group->error == NULL) group->error = std::current_exception();
+    }
+    delete task;
+    // last touch of the group, its owner may return from wait() right after
+    group->pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  bool ThreadPool::runPending() {
+    Worker *self = currentWorker != NULL && currentWorker->pool == this ? currentWorker : NULL;
+    Task *task = this->findTask(self);
+    if (task == NULL) return false;
+    this->execute(task);
+    return true;
+  }
+
+  void ThreadPool::workerLoop(Worker *self) {
+    currentWorker = self;
+    for (;;) {
+      Task *task = this->findTask(self);
+      if (task != NULL) {
+        this->execute(task);
+        continue;
+      }
+      // a task is counted but another thread is mid-way through taking it
+      if (this->queued.load() > 0) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> guard(this->sleepLock);
+      this->sleeping.fetch_add(1);
+      this->wake.wait(guard, [this]() { return this->queued.load() > 0 || this->stopping.load(); });
+      this->sleeping.fetch_sub(1);
+      if (this->stopping.load() && this->queued.load() == 0) break;
+    }
+    currentWorker = NULL;
+  }
+
+  TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool), pending(0) {}
+
+  TaskGroup::~TaskGroup() {
+    this->join();
+  }
+
+  void TaskGroup::join() {
+    while (this->pending.load(std::memory_order_acquire) > 0) {
+      if (!this->pool.runPending()) std::this_thread::yield();
+    }
+  }
+
+  void TaskGroup::wait() {
+    this->join();
+    if (this->error != NULL) {
+      std::exception_ptr error = this->error;
+      this->error = NULL;
+      std::rethrow_exception(error);
+    }
+  }
+}
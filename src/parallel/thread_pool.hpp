@@ -0,0 +1,244 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Work-stealing scheduler shared by the geometry algorithms, so nested parallel work composes
+ * instead of every routine spawning its own threads
+ */
+namespace Parallel {
+  class TaskGroup;
+
+  /**
+   * @brief Unit of work queued on a pool. The pool owns and deletes it once it has run
+   */
+  class Task {
+    public:
+      virtual ~Task() {}
+      virtual void execute() = 0;
+    private:
+      friend class ThreadPool;
+      TaskGroup *group = NULL;
+  };
+
+  class ThreadPool {
+    public:
+      /**
+       * @brief Start concurrency - 1 workers, the thread waiting on a task group is the last one
+       *
+       * @param concurrency Threads running tasks at once, 0 picks the hardware concurrency and 1 runs every
+       * task inline on the calling thread, in submission order
+       */
+      explicit ThreadPool(unsigned int concurrency = 0);
+      ~ThreadPool();
+
+      ThreadPool(const ThreadPool &) = delete;
+      ThreadPool &operator=(const ThreadPool &) = delete;
+
+      unsigned int getConcurrency() const;
+
+      /**
+       * @brief Whether tasks run inline on the submitting thread, which makes every run deterministic
+       */
+      bool isSerial() const;
+
+      /**
+       * @brief Pool the algorithms run on. Created on first use with the concurrency given by the
+       * COMPGEOM_THREADS environment variable, or the hardware concurrency when it is unset
+       */
+      static ThreadPool &global();
+
+      /**
+       * @brief Replace the global pool. Must not be called while work is running on it
+       *
+       * @param concurrency Same meaning as in the constructor
+       */
+      static void setGlobalConcurrency(unsigned int concurrency);
+
+      /**
+       * @brief Queue a task for group, on the calling worker's own deque or on the shared queue when called
+       * from outside the pool
+       */
+      void submit(Task *task, TaskGroup *group);
+
+      /**
+       * @brief Run one queued task on the calling thread, used by threads waiting on a task group
+       *
+       * @return bool Whether a task was found
+       */
+      bool runPending();
+    private:
+      struct Worker;
+
+      // worker the calling thread runs, NULL outside every pool
+      static thread_local Worker *currentWorker;
+
+      unsigned int concurrency;
+      std::vector<std::unique_ptr<Worker>> workers;
+      std::vector<std::thread> threads;
+
+      // tasks submitted from threads outside the pool
+      std::mutex injectedLock;
+      std::deque<Task *> injected;
+
+      // idle workers sleep here until queued goes above zero
+      std::mutex sleepLock;
+      std::condition_variable wake;
+      std::atomic<size_t> queued;
+      std::atomic<unsigned int> sleeping;
+      std::atomic<bool> stopping;
+
+      Task *findTask(Worker *self);
+      void execute(Task *task);
+      void workerLoop(Worker *self);
+  };
+
+  /**
+   * @brief Fork-join scope: run() forks tasks onto the pool, wait() joins them. The waiting thread executes
+   * queued tasks while it waits rather than blocking, so groups nest freely inside tasks
+   */
+  class TaskGroup {
+    public:
+      explicit TaskGroup(ThreadPool &pool = ThreadPool::global());
+
+      /**
+       * @brief Join any task still running, exceptions they threw are dropped
+       */
+      ~TaskGroup();
+
+      TaskGroup(const TaskGroup &) = delete;
+      TaskGroup &operator=(const TaskGroup &) = delete;
+
+      template <typename Function>
+      void run(Function &&function);
+
+      /**
+       * @brief Block until every task run so far has finished, then rethrow the first exception one of them threw
+       */
+      void wait();
+    private:
+      friend class ThreadPool;
+
+      ThreadPool &pool;
+      std::atomic<size_t> pending;
+      std::mutex errorLock;
+      std::exception_ptr error;
+
+      void join();
+  };
+
+  template <typename Function>
+  void TaskGroup::run(Function &&function) {
+    if (this->pool.isSerial()) {
+      function();
+      return;
+    }
+
+    struct FunctionTask : Task {
+      std::decay_t<Function> function;
+
+      explicit FunctionTask(Function &&function) : function(std::forward<Function>(function)) {}
+      void execute() override { this->function(); }
+    };
+    this->pending.fetch_add(1, std::memory_order_relaxed);
+    this->pool.submit(new FunctionTask(std::forward<Function>(function)), this);
+  }
+
+  /**
+   * @brief Call body(begin, end) over pieces of [first, last) no larger than grain, halving the range
+   * recursively so idle workers steal the largest pieces left
+   *
+   * @param grain Largest piece handed to body, the serial pool takes the whole range in one call
+   */
+  template <typename Body>
+  void parallelFor(size_t first, size_t last, size_t grain, const Body &body, ThreadPool &pool = ThreadPool::global()) {
+    if (first >= last) return;
+    grain = std::max<size_t>(grain, 1);
+    if (pool.isSerial() || last - first <= grain) {
+      body(first, last);
+      return;
+    }
+
+    size_t middle = first + (last - first) / 2;
+    TaskGroup group(pool);
+    group.run([&, first, middle]() { parallelFor(first, middle, grain, body, pool); });
+    parallelFor(middle, last, grain, body, pool);
+    group.wait();
+  }
+
+  /**
+   * @brief Reduce [first, last) by mapping pieces no larger than grain with map(begin, end) and merging the
+   * results with combine(left, right). The split tree depends only on the range and grain, so floating point
+   * results come out bit-identical whatever the concurrency
+   */
+  template <typename Value, typename Map, typename Combine>
+  Value parallelReduce(size_t first, size_t last, size_t grain, const Value &identity, const Map &map, const Combine &combine, ThreadPool &pool = ThreadPool::global()) {
+    if (first >= last) return identity;
+    grain = std::max<size_t>(grain, 1);
+    if (last - first <= grain) return map(first, last);
+
+    size_t middle = first + (last - first) / 2;
+    Value left = identity;
+    TaskGroup group(pool);
+    group.run([&, first, middle]() { left = parallelReduce(first, middle, grain, identity, map, combine, pool); });
+    Value right = parallelReduce(middle, last, grain, identity, map, combine, pool);
+    group.wait();
+    return combine(left, right);
+  }
+
+  /**
+   * @brief Sort [first, last) by splitting it at the median and sorting both halves as tasks, down to ranges
+   * of grain elements that go to std::sort. Not stable, but the result depends only on the input
+   */
+  template <typename Iterator, typename Less>
+  void parallelSort(Iterator first, Iterator last, const Less &less, size_t grain = 1 << 15, ThreadPool &pool = ThreadPool::global()) {
+    size_t count = (size_t) (last - first);
+    if (pool.isSerial() || count <= std::max<size_t>(grain, 2)) {
+      std::sort(first, last, less);
+      return;
+    }
+
+    Iterator middle = first + count / 2;
+    std::nth_element(first, middle, last, less);
+    TaskGroup group(pool);
+    group.run([&, first, middle]() { parallelSort(first, middle, less, grain, pool); });
+    parallelSort(middle + 1, last, less, grain, pool);
+    group.wait();
+  }
+
+  /**
+   * @brief Number of chunks to split count items into for routines that keep per-chunk scratch space
+   *
+   * @param requested Chunks asked for by the caller, 0 takes the pool's concurrency
+   * @param minPerChunk Fewest items worth a chunk of their own
+   */
+  inline unsigned int chunkCount(size_t count, unsigned int requested, size_t minPerChunk, ThreadPool &pool = ThreadPool::global()) {
+    size_t chunks = requested == 0 ? pool.getConcurrency() : requested;
+    return (unsigned int) std::max<size_t>(1, std::min(chunks, count / std::max<size_t>(minPerChunk, 1)));
+  }
+
+  /**
+   * @brief Call work(begin, end, chunk) for each of chunks contiguous, near-equal pieces of [0, count).
+   * Piece boundaries depend only on count and chunks
+   */
+  template <typename Work>
+  void forEachChunk(size_t count, unsigned int chunks, const Work &work, ThreadPool &pool = ThreadPool::global()) {
+    parallelFor(0, chunks, 1, [&](size_t firstChunk, size_t lastChunk) {
+      for (size_t c = firstChunk; c < lastChunk; c++) work(count * c / chunks, count * (c + 1) / chunks, (unsigned int) c);
+    }, pool);
+  }
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "work_stealing_deque.hpp"
+
+namespace Parallel {
+  WorkStealingDeque::Ring::Ring(int64_t capacity) : mask(capacity - 1), slots(new std::atomic<Task *>[capacity]) {}
+
+  Task *WorkStealingDeque::Ring::get(int64_t index) const {
+    return this->slots[index & this->mask].load(std::memory_order_relaxed);
+  }
+
+  void WorkStealingDeque::Ring::put(int64_t index, Task *task) {
+    this->slots[index & this->mask].store(task, std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque::WorkStealingDeque() : top(0), bottom(0) {
+    this->retired.emplace_back(new Ring(INITIAL_CAPACITY));
+    this->ring.store(this->retired.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque::~WorkStealingDeque() {}
+
+  /**
+   * @brief Copy the live range into a ring twice the size. The old ring stays readable for thieves
+   * that loaded it before the switch
+   */
+  WorkStealingDeque::Ring *WorkStealingDeque::grow(Ring *current, int64_t top, int64_t bottom) {
+    Ring *larger = new Ring(2 * (current->mask + 1));
+    for (int64_t i = top; i < bottom; i++) larger->put(i, current->get(i));
+    this->retired.emplace_back(larger);
+    this->ring.store(larger, std::memory_order_release);
+    return larger;
+  }
+
+  /**
+   * @brief Memory orderings follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing
+   * for Weak Memory Models" (PPoPP 2013)
+   */
+  void WorkStealingDeque::push(Task *task) {
+    int64_t b = this->bottom.load(std::memory_order_relaxed);
+    int64_t t = this->top.load(std::memory_order_acquire);
+    Ring *current = this->ring.load(std::memory_order_relaxed);
+    if (b - t > current->mask) current = this->grow(current, t, b);
+    current->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  Task *WorkStealingDeque::pop() {
+    int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    Ring *current = this->ring.load(std::memory_order_relaxed);
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // already empty, undo the reservation
+      this->bottom.store(b + 1, std::memory_order_relaxed);
+      return NULL;
+    }
+    Task *task = current->get(b);
+    if (t == b) {
+      // last task, race the thieves for it
+      if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) task = NULL;
+      this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  Task *WorkStealingDeque::steal() {
+    int64_t t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = this->bottom.load(std::memory_order_acquire);
+    if (t >= b) return NULL;
+
+    Task *task = this->ring.load(std::memory_order_acquire)->get(t);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return NULL;
+    return task;
+  }
+
+  bool WorkStealingDeque::empty() const {
+    int64_t t = this->top.load(std::memory_order_relaxed);
+    int64_t b = this->bottom.load(std::memory_order_relaxed);
+    return t >= b;
+  }
+}
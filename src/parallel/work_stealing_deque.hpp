@@ -0,0 +1,70 @@
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Parallel {
+  class Task;
+
+  /**
+   * @brief Chase-Lev deque of tasks. The owning worker pushes and pops at the bottom without locking,
+   * any other thread may steal from the top; a single compare-and-swap settles the race for the last task
+   */
+  class WorkStealingDeque {
+    public:
+      // initial ring size, must be a power of two
+      static const int64_t INITIAL_CAPACITY = 256;
+
+      WorkStealingDeque();
+      ~WorkStealingDeque();
+
+      WorkStealingDeque(const WorkStealingDeque &) = delete;
+      WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+      /**
+       * @brief Add a task at the bottom, growing the ring when full. Owner only
+       */
+      void push(Task *task);
+
+      /**
+       * @brief Take the most recently pushed task. Owner only
+       *
+       * @return Task* The task, NULL when the deque is empty or a thief won the last one
+       */
+      Task *pop();
+
+      /**
+       * @brief Take the oldest task. Safe from any thread
+       *
+       * @return Task* The task, NULL when the deque is empty or another thread got there first
+       */
+      Task *steal();
+
+      /**
+       * @brief Whether the deque looked empty at the time of the call
+       */
+      bool empty() const;
+    private:
+      struct Ring {
+        int64_t mask;
+        std::unique_ptr<std::atomic<Task *>[]> slots;
+
+        explicit Ring(int64_t capacity);
+        Task *get(int64_t index) const;
+        void put(int64_t index, Task *task);
+      };
+
+      alignas(64) std::atomic<int64_t> top;
+      alignas(64) std::atomic<int64_t> bottom;
+      std::atomic<Ring *> ring;
+      // outgrown rings, kept alive until destruction since a thief may still be reading one
+      std::vector<std::unique_ptr<Ring>> retired;
+
+      Ring *grow(Ring *current, int64_t top, int64_t bottom);
+  };
+}
+
+#endif
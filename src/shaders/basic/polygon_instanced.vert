@@ -0,0 +1,16 @@
+#version 330 core
+
+// per-instance regular polygon, advanced once per instance
+layout (location = 1) in vec2 aCenter;
+layout (location = 2) in float aRadius;
+layout (location = 3) in float aRotation; // degrees
+
+// every instance in a draw shares its side count
+uniform uint uSides;
+
+void main()
+{
+  // same layout as Polygon::calculateVertices, vertex 0 sits at the rotation angle
+  float theta = radians(aRotation + float(gl_VertexID) * 360.0 / float(uSides));
+  gl_Position = vec4(aCenter + aRadius * vec2(cos(theta), sin(theta)), 0.0, 1.0);
+}
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include "kd_tree.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Spatial {
+  /**
+   * @brief Pending subtree during a traversal: node id, its point range and a lower bound on the squared
+   * distance from the query to anything inside it
+   */
+  struct TraversalFrame {
+    uint32_t node;
+    uint32_t low;
+    uint32_t high;
+    float bound;
+  };
+
+  static inline bool closer(const Neighbor &a, const Neighbor &b) {
+    return a.distanceSquared < b.distanceSquared;
+  }
+
+  template <typename Vector>
+  static inline float distanceSquared(const Vector &a, const Vector &b) {
+    float sum = 0.0f;
+    for (unsigned int d = 0; d < KdTree<Vector>::DIMENSIONS; d++) {
+      float delta = a.vector[d] - b.vector[d];
+      sum += delta * delta;
+    }
+    return sum;
+  }
+
+  // fewest points in a subtree worth building as its own task
+  static const size_t MIN_POINTS_PER_TASK = 1 << 14;
+  // fewest queries in a batch chunk
+  static const size_t MIN_QUERIES_PER_TASK = 256;
+
+  template <typename Vector>
+  void KdTree<Vector>::build(std::span<const Vector> input, unsigned int threadCount) {
+    size_t n = input.size();
+    this->indices.resize(n);
+    std::iota(this->indices.begin(), this->indices.end(), 0);
+
+    this->depth = 0;
+    while (((n + ((size_t) 1 << this->depth) - 1) >> this->depth) > LEAF_SIZE) this->depth++;
+    size_t internalCount = ((size_t) 1 << this->depth) - 1;
+    this->splitAxes.assign(internalCount, 0);
+    this->splitValues.assign(internalCount, 0.0f);
+
+    // each parallel level doubles the subtrees built at once, a few per thread lets idle workers steal
+    // from one that is slow to split
+    unsigned int chunks = Parallel::chunkCount(n, threadCount, MIN_POINTS_PER_TASK);
+    unsigned int parallelLevels = 0;
+    while (chunks > 1 && (1u << parallelLevels) < 4 * chunks) parallelLevels++;
+    this->buildNode(input, 0, 0, n, 0, parallelLevels);
+
+    this->points.resize(n);
+    this->slotOf.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      this->points[i] = input[this->indices[i]];
+      this->slotOf[this->indices[i]] = (uint32_t) i;
+    }
+  }
+
+  /**
+   * @brief Split [low, high) at its median along the axis of widest spread, then build both halves, the left
+   * one as a pool task while parallel levels remain
+   */
+  template <typename Vector>
+  void KdTree<Vector>::buildNode(std::span<const Vector> input, size_t node, size_t low, size_t high, unsigned int level, unsigned int parallelLevels) {
+    if (level == this->depth) return;
+
+    float minimum[DIMENSIONS], maximum[DIMENSIONS];
+    for (unsigned int d = 0; d < DIMENSIONS; d++) {
+      minimum[d] = std::numeric_limits<float>::infinity();
+      maximum[d] = -std::numeric_limits<float>::infinity();
+    }
+    for (size_t i = low; i < high; i++) {
+      const Vector &p = input[this->indices[i]];
+      for (unsigned int d = 0; d < DIMENSIONS; d++) {
+        minimum[d] = std::min(minimum[d], p.vector[d]);
+        maximum[d] = std::max(maximum[d], p.vector[d]);
+      }
+    }
+    unsigned int axis = 0;
+    for (unsigned int d = 1; d < DIMENSIONS; d++) {
+      if (maximum[d] - minimum[d] > maximum[axis] - minimum[axis]) axis = d;
+    }
+
+    size_t mid = low + (high - low) / 2;
+    std::nth_element(this->indices.begin() + low, this->indices.begin() + mid, this->indices.begin() + high, [&](uint32_t a, uint32_t b) {
+      return input[a].vector[axis] < input[b].vector[axis];
+    });
+    this->splitAxes[node] = (uint8_t) axis;
+    this->splitValues[node] = high > low ? input[this->indices[mid]].vector[axis] : 0.0f;
+
+    if (parallelLevels > 0) {
+      Parallel::TaskGroup group;
+      group.run([&, node, low, mid, level, parallelLevels]() {
+        this->buildNode(input, 2 * node + 1, low, mid, level + 1, parallelLevels - 1);
+      });
+      this->buildNode(input, 2 * node + 2, mid, high, level + 1, parallelLevels - 1);
+      group.wait();
+    } else {
+      this->buildNode(input, 2 * node + 1, low, mid, level + 1, 0);
+      this->buildNode(input, 2 * node + 2, mid, high, level + 1, 0);
+    }
+  }
+
+  /**
+   * @brief Best first descent with a bounded max-heap of candidates, far subtrees are skipped once their
+   * splitting plane is further away than the current k-th neighbour
+   */
+  template <typename Vector>
+  static void searchNearest(const std::vector<Vector> &points, const std::vector<uint32_t> &indices,
+    const std::vector<uint8_t> &axes, const std::vector<float> &values, const Vector &query, size_t k, std::vector<Neighbor> &heap,
+    std::vector<TraversalFrame> &stack) {
+    heap.clear();
+    stack.clear();
+    if (k == 0 || points.empty()) return;
+
+    uint32_t internalCount = (uint32_t) axes.size();
+    stack.push_back({ 0, 0, (uint32_t) points.size(), 0.0f });
+    while (!stack.empty()) {
+      TraversalFrame frame = stack.back();
+      stack.pop_back();
+      if (heap.size() == k && frame.bound > heap.front().distanceSquared) continue;
+
+      if (frame.node >= internalCount) {
+        for (uint32_t i = frame.low; i < frame.high; i++) {
+          float d = distanceSquared(points[i], query);
+          if (heap.size() < k) {
+            heap.push_back({ indices[i], d });
+            std::push_heap(heap.begin(), heap.end(), closer);
+          } else if (d < heap.front().distanceSquared) {
+            std::pop_heap(heap.begin(), heap.end(), closer);
+            heap.back() = { indices[i], d };
+            std::push_heap(heap.begin(), heap.end(), closer);
+          }
+        }
+        continue;
+      }
+
+      uint32_t mid = frame.low + (frame.high - frame.low) / 2;
+      float diff = query.vector[axes[frame.node]] - values[frame.node];
+      TraversalFrame left = { 2 * frame.node + 1, frame.low, mid, frame.bound };
+      TraversalFrame right = { 2 * frame.node + 2, mid, frame.high, frame.bound };
+      // far side pushed first so the near side is searched first
+      if (diff < 0.0f) {
+        right.bound = std::max(frame.bound, diff * diff);
+        stack.push_back(right);
+        stack.push_back(left);
+      } else {
+        left.bound = std::max(frame.bound, diff * diff);
+        stack.push_back(left);
+        stack.push_back(right);
+      }
+    }
+    std::sort_heap(heap.begin(), heap.end(), closer);
+  }
+
+  template <typename Vector>
+  static void searchRadius(const std::vector<Vector> &points, const std::vector<uint32_t> &indices, const std::vector<uint8_t> &axes,
+    const std::vector<float> &values, const Vector &query, float radius, std::vector<Neighbor> &result, std::vector<TraversalFrame> &stack) {
+    stack.clear();
+    if (points.empty()) return;
+
+    float radiusSquared = radius * radius;
+    uint32_t internalCount = (uint32_t) axes.size();
+    stack.push_back({ 0, 0, (uint32_t) points.size(), 0.0f });
+    while (!stack.empty()) {
+      TraversalFrame frame = stack.back();
+      stack.pop_back();
+
+      if (frame.node >= internalCount) {
+        for (uint32_t i = frame.low; i < frame.high; i++) {
+          float d = distanceSquared(points[i], query);
+          if (d <= radiusSquared) result.push_back({ indices[i], d });
+        }
+        continue;
+      }
+
+      uint32_t mid = frame.low + (frame.high - frame.low) / 2;
+      float diff = query.vector[axes[frame.node]] - values[frame.node];
+      if (diff <= 0.0f || diff * diff <= radiusSquared) stack.push_back({ 2 * frame.node + 1, frame.low, mid, 0.0f });
+      if (diff >= 0.0f || diff * diff <= radiusSquared) stack.push_back({ 2 * frame.node + 2, mid, frame.high, 0.0f });
+    }
+  }
+
+  template <typename Vector>
+  void KdTree<Vector>::nearest(const Vector &query, size_t k, std::vector<Neighbor> &result) const {
+    std::vector<TraversalFrame> stack;
+    searchNearest(this->points, this->indices, this->splitAxes, this->splitValues, query, k, result, stack);
+  }
+
+  template <typename Vector>
+  void KdTree<Vector>::radius(const Vector &query, float radius, std::vector<Neighbor> &result) const {
+    std::vector<TraversalFrame> stack;
+    result.clear();
+    searchRadius(this->points, this->indices, this->splitAxes, this->splitValues, query, radius, result, stack);
+  }
+
+  template <typename Vector>
+  void KdTree<Vector>::range(const Vector &low, const Vector &high, std::vector<uint32_t> &result) const {
+    result.clear();
+    if (this->points.empty()) return;
+
+    std::vector<TraversalFrame> stack;
+    uint32_t internalCount = (uint32_t) this->splitAxes.size();
+    stack.push_back({ 0, 0, (uint32_t) this->points.size(), 0.0f });
+    while (!stack.empty()) {
+      TraversalFrame frame = stack.back();
+      stack.pop_back();
+
+      if (frame.node >= internalCount) {
+        for (uint32_t i = frame.low; i < frame.high; i++) {
+          bool inside = true;
+          for (unsigned int d = 0; d < DIMENSIONS; d++) {
+            float value = this->points[i].vector[d];
+            inside = inside && value >= low.vector[d] && value <= high.vector[d];
+          }
+          if (inside) result.push_back(this->indices[i]);
+        }
+        continue;
+      }
+
+      uint32_t mid = frame.low + (frame.high - frame.low) / 2;
+      unsigned int axis = this->splitAxes[frame.node];
+      float split = this->splitValues[frame.node];
+      if (low.vector[axis] <= split) stack.push_back({ 2 * frame.node + 1, frame.low, mid, 0.0f });
+      if (high.vector[axis] >= split) stack.push_back({ 2 * frame.node + 2, mid, frame.high, 0.0f });
+    }
+  }
+
+  /**
+   * @brief Query indices ordered by the leaf each query descends to (counting sort over leaves)
+   */
+  template <typename Vector>
+  std::vector<uint32_t> KdTree<Vector>::leafOrder(std::span<const Vector> queries) const {
+    size_t internalCount = this->splitAxes.size();
+    std::vector<uint32_t> leaves(queries.size());
+    std::vector<uint32_t> counts(internalCount + 2, 0);
+    for (size_t q = 0; q < queries.size(); q++) {
+      size_t node = 0;
+      while (node < internalCount) {
+        node = queries[q].vector[this->splitAxes[node]] < this->splitValues[node] ? 2 * node + 1 : 2 * node + 2;
+      }
+      leaves[q] = (uint32_t) (node - internalCount);
+      counts[leaves[q] + 1]++;
+    }
+    for (size_t i = 1; i < counts.size(); i++) counts[i] += counts[i - 1];
+
+    std::vector<uint32_t> order(queries.size());
+    for (size_t q = 0; q < queries.size(); q++) order[counts[leaves[q]]++] = (uint32_t) q;
+    return order;
+  }
+
+  template <typename Vector>
+  void KdTree<Vector>::nearestBatch(std::span<const Vector> queries, size_t k, std::vector<Neighbor> &result, unsigned int threadCount) const {
+    result.assign(queries.size() * k, { Neighbor::NONE, std::numeric_limits<float>::infinity() });
+    std::vector<uint32_t> order = this->leafOrder(queries);
+
+    unsigned int chunks = Parallel::chunkCount(order.size(), threadCount, MIN_QUERIES_PER_TASK);
+    Parallel::forEachChunk(order.size(), chunks, [&](size_t first, size_t last, unsigned int) {
+      std::vector<Neighbor> heap;
+      std::vector<TraversalFrame> stack;
+      heap.reserve(k);
+      for (size_t i = first; i < last; i++) {
+        uint32_t q = order[i];
+        searchNearest(this->points, this->indices, this->splitAxes, this->splitValues, queries[q], k, heap, stack);
+        std::copy(heap.begin(), heap.end(), result.begin() + (size_t) q * k);
+      }
+    });
+  }
+
+  template <typename Vector>
+  void KdTree<Vector>::radiusBatch(std::span<const Vector> queries, float radius, std::vector<uint32_t> &offsets, std::vector<Neighbor> &result, unsigned int threadCount) const {
+    std::vector<uint32_t> order = this->leafOrder(queries);
+
+    // every chunk collects into its own buffer, a prefix sum over the counts then places them in query order
+    struct Chunk {
+      std::vector<Neighbor> found;
+      std::vector<uint32_t> starts;
+      size_t first;
+    };
+    std::vector<Chunk> chunks(Parallel::chunkCount(order.size(), threadCount, MIN_QUERIES_PER_TASK));
+    offsets.assign(queries.size() + 1, 0);
+
+    Parallel::forEachChunk(order.size(), (unsigned int) chunks.size(), [&](size_t first, size_t last, unsigned int c) {
+      Chunk &chunk = chunks[c];
+      chunk.first = first;
+      std::vector<TraversalFrame> stack;
+      for (size_t i = first; i < last; i++) {
+        chunk.starts.push_back((uint32_t) chunk.found.size());
+        searchRadius(this->points, this->indices, this->splitAxes, this->splitValues, queries[order[i]], radius, chunk.found, stack);
+        offsets[order[i] + 1] = (uint32_t) (chunk.found.size() - chunk.starts.back());
+      }
+      chunk.starts.push_back((uint32_t) chunk.found.size());
+    });
+
+    for (size_t i = 1; i < offsets.size(); i++) offsets[i] += offsets[i - 1];
+    result.resize(offsets.back());
+    for (const Chunk &chunk : chunks) {
+      for (size_t j = 0; j + 1 < chunk.starts.size(); j++) {
+        uint32_t q = order[chunk.first + j];
+        std::copy(chunk.found.begin() + chunk.starts[j], chunk.found.begin() + chunk.starts[j + 1], result.begin() + offsets[q]);
+      }
+    }
+  }
+
+  template class KdTree<Vector2D>;
+  template class KdTree<Vector3D>;
+}
@@ -0,0 +1,88 @@
+#ifndef KD_TREE_HPP
+#define KD_TREE_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../vectors.hpp"
+#include "neighbor.hpp"
+
+namespace Spatial {
+  /**
+   * @brief Static kd-tree over Vector2D or Vector3D points. The tree is implicit: points are permuted into one
+   * array, every node splits its range at the median and nodes are numbered heap style (children of i are
+   * 2i + 1 and 2i + 2), so only the split axis and value of each internal node are stored. Leaves hold at most
+   * LEAF_SIZE contiguous points.
+   *
+   * Queries return indices into the array the tree was built from.
+   */
+  template <typename Vector>
+  class KdTree {
+    public:
+      static const unsigned int DIMENSIONS = sizeof(Vector) / sizeof(float);
+      static const size_t LEAF_SIZE = 16;
+
+      KdTree() {};
+
+      /**
+       * @brief Build over a copy of points, the top levels split into tasks on the global thread pool
+       *
+       * @param points Points to index
+       * @param threadCount Tasks to split the work into, 0 uses the global pool's concurrency
+       */
+      void build(std::span<const Vector> points, unsigned int threadCount = 0);
+
+      /**
+       * @brief The k points closest to query, nearest first
+       */
+      void nearest(const Vector &query, size_t k, std::vector<Neighbor> &result) const;
+
+      /**
+       * @brief Every point within radius of query, in no particular order
+       */
+      void radius(const Vector &query, float radius, std::vector<Neighbor> &result) const;
+
+      /**
+       * @brief Every point inside the box [low, high], bounds included
+       */
+      void range(const Vector &low, const Vector &high, std::vector<uint32_t> &result) const;
+
+      /**
+       * @brief k nearest neighbours of many queries. Queries are grouped by the leaf they fall in and handed out
+       * to threads in that order, so consecutive searches walk the same nodes and points while they are cached
+       *
+       * @param queries Query points
+       * @param k Neighbours per query
+       * @param result k entries per query in query order, nearest first, padded with Neighbor::NONE
+       * @param threadCount Tasks to split the work into, 0 uses the global pool's concurrency
+       */
+      void nearestBatch(std::span<const Vector> queries, size_t k, std::vector<Neighbor> &result, unsigned int threadCount = 0) const;
+
+      /**
+       * @brief Radius search for many queries, with the same leaf grouping as nearestBatch
+       *
+       * @param offsets Neighbours of query i are result[offsets[i] .. offsets[i + 1])
+       */
+      void radiusBatch(std::span<const Vector> queries, float radius, std::vector<uint32_t> &offsets, std::vector<Neighbor> &result, unsigned int threadCount = 0) const;
+
+      size_t size() const { return this->points.size(); }
+      const Vector &point(size_t index) const { return this->points[this->slotOf[index]]; }
+
+    private:
+      std::vector<Vector> points;
+      // original index of points[i], and the inverse
+      std::vector<uint32_t> indices;
+      std::vector<uint32_t> slotOf;
+      std::vector<uint8_t> splitAxes;
+      std::vector<float> splitValues;
+      unsigned int depth = 0;
+
+      void buildNode(std::span<const Vector> input, size_t node, size_t low, size_t high, unsigned int level, unsigned int parallelLevels);
+      std::vector<uint32_t> leafOrder(std::span<const Vector> queries) const;
+  };
+
+  extern template class KdTree<Vector2D>;
+  extern template class KdTree<Vector3D>;
+}
+
+#endif
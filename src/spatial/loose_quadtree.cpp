@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cmath>
+#include "loose_quadtree.hpp"
+
+using namespace Shapes;
+
+namespace Spatial {
+  LooseQuadtree::LooseQuadtree(Vector2D center, float halfSize, float looseness)
+    : rootCenter(center), rootHalfSize(halfSize), looseness(looseness), nodePool(arena) {
+    this->root = this->createNode(NULL, center, halfSize);
+  }
+
+  QuadtreeNode *LooseQuadtree::createNode(QuadtreeNode *parent, Vector2D center, float halfSize) {
+    QuadtreeNode *node = this->nodePool.create();
+    node->center = center;
+    node->halfSize = halfSize;
+    node->depth = parent == NULL ? 0 : parent->depth + 1;
+    node->parent = parent;
+    std::fill(node->children, node->children + 4, (QuadtreeNode *) NULL);
+    node->firstEntry = NO_ENTRY;
+    node->entryCount = 0;
+    node->subtreeCount = 0;
+    node->split = false;
+    this->nodeCount++;
+    return node;
+  }
+
+  /**
+   * @brief Whether a circle lies inside the loose bounds of a cell
+   */
+  static inline bool circleInLooseCell(Vector2D cellCenter, float looseHalfSize, Vector2D center, float radius) {
+    return std::fabs(center.vector[0] - cellCenter.vector[0]) + radius <= looseHalfSize
+      && std::fabs(center.vector[1] - cellCenter.vector[1]) + radius <= looseHalfSize;
+  }
+
+  bool LooseQuadtree::fitsLoose(const QuadtreeNode *node, Vector2D center, float radius) const {
+    return circleInLooseCell(node->center, node->halfSize * this->looseness, center, radius);
+  }
+
+  /**
+   * @brief Child quadrant holding point: bit 0 set for the right half, bit 1 for the top half
+   */
+  unsigned int LooseQuadtree::quadrantOf(const QuadtreeNode *node, Vector2D point) const {
+    return (point.vector[0] >= node->center.vector[0] ? 1 : 0) | (point.vector[1] >= node->center.vector[1] ? 2 : 0);
+  }
+
+  static inline Vector2D quadrantCenter(const QuadtreeNode *node, unsigned int quadrant) {
+    float offset = node->halfSize * 0.5f;
+    return {
+      node->center.vector[0] + ((quadrant & 1) ? offset : -offset),
+      node->center.vector[1] + ((quadrant & 2) ? offset : -offset)
+    };
+  }
+
+  QuadtreeNode *LooseQuadtree::childFor(QuadtreeNode *node, unsigned int quadrant) {
+    if (node->children[quadrant] == NULL) {
+      node->children[quadrant] = this->createNode(node, quadrantCenter(node, quadrant), node->halfSize * 0.5f);
+    }
+    return node->children[quadrant];
+  }
+
+  /**
+   * @brief Descend from start through split nodes while the child holding the shape's center still contains
+   * its circle, link it there and split the node if it overflows
+   */
+  void LooseQuadtree::place(uint32_t handle, QuadtreeNode *start) {
+    const Entry &entry = this->entries[handle];
+    QuadtreeNode *node = start;
+    while (node->split && node->depth < MAX_DEPTH) {
+      unsigned int quadrant = this->quadrantOf(node, entry.center);
+      if (!circleInLooseCell(quadrantCenter(node, quadrant), node->halfSize * 0.5f * this->looseness, entry.center, entry.radius)) break;
+      node = this->childFor(node, quadrant);
+    }
+
+    this->link(handle, node);
+    if (!node->split && node->entryCount > SPLIT_THRESHOLD && node->depth < MAX_DEPTH) this->splitNode(node);
+  }
+
+  /**
+   * @brief Mark a node as split and push down every shape that fits one of its children
+   */
+  void LooseQuadtree::splitNode(QuadtreeNode *node) {
+    node->split = true;
+    std::vector<uint32_t> moving;
+    for (uint32_t handle = node->firstEntry; handle != NO_ENTRY; handle = this->entries[handle].next) {
+      const Entry &entry = this->entries[handle];
+      unsigned int quadrant = this->quadrantOf(node, entry.center);
+      if (circleInLooseCell(quadrantCenter(node, quadrant), node->halfSize * 0.5f * this->looseness, entry.center, entry.radius)) {
+        moving.push_back(handle);
+      }
+    }
+    for (uint32_t handle : moving) {
+      this->unlink(handle);
+      this->place(handle, node);
+    }
+  }
+
+  void LooseQuadtree::link(uint32_t handle, QuadtreeNode *node) {
+    Entry &entry = this->entries[handle];
+    entry.node = node;
+    entry.previous = NO_ENTRY;
+    entry.next = node->firstEntry;
+    if (node->firstEntry != NO_ENTRY) this->entries[node->firstEntry].previous = handle;
+    node->firstEntry = handle;
+    node->entryCount++;
+    for (QuadtreeNode *ancestor = node; ancestor != NULL; ancestor = ancestor->parent) ancestor->subtreeCount++;
+  }
+
+  void LooseQuadtree::unlink(uint32_t handle) {
+    Entry &entry = this->entries[handle];
+    QuadtreeNode *node = entry.node;
+    if (entry.previous != NO_ENTRY) this->entries[entry.previous].next = entry.next;
+    else node->firstEntry = entry.next;
+    if (entry.next != NO_ENTRY) this->entries[entry.next].previous = entry.previous;
+    node->entryCount--;
+    for (QuadtreeNode *ancestor = node; ancestor != NULL; ancestor = ancestor->parent) ancestor->subtreeCount--;
+    entry.node = NULL;
+  }
+
+  /**
+   * @brief Return empty nodes to the pool, from node up to the first ancestor that still holds a shape
+   */
+  void LooseQuadtree::prune(QuadtreeNode *node) {
+    while (node != this->root && node->subtreeCount == 0) {
+      QuadtreeNode *parent = node->parent;
+      for (unsigned int quadrant = 0; quadrant < 4; quadrant++) {
+        if (parent->children[quadrant] == node) parent->children[quadrant] = NULL;
+      }
+      this->nodePool.release(node);
+      this->nodeCount--;
+      node = parent;
+    }
+  }
+
+  /**
+   * @brief Start tracking a shape's bounding circle
+   *
+   * @param shape Shape with its center point and radius set, owned by the caller
+   */
+  void LooseQuadtree::insertShape(Shape2D *shape) {
+    if (this->handles.count(shape) > 0) return;
+
+    uint32_t handle;
+    if (this->freeEntries.empty()) {
+      handle = (uint32_t) this->entries.size();
+      this->entries.emplace_back();
+    } else {
+      handle = this->freeEntries.back();
+      this->freeEntries.pop_back();
+    }
+    Entry &entry = this->entries[handle];
+    entry.shape = shape;
+    entry.center = shape->getCenterPt();
+    entry.radius = shape->getRadius();
+    this->handles.emplace(shape, handle);
+    this->place(handle, this->root);
+  }
+
+  void LooseQuadtree::removeShape(Shape2D *shape) {
+    auto found = this->handles.find(shape);
+    if (found == this->handles.end()) return;
+
+    uint32_t handle = found->second;
+    QuadtreeNode *node = this->entries[handle].node;
+    this->unlink(handle);
+    this->prune(node);
+    this->freeEntries.push_back(handle);
+    this->handles.erase(found);
+  }
+
+  /**
+   * @brief Re-read a shape's center point and radius after it moved or was resized. While the circle stays inside
+   * its node's loose bounds this is constant time, otherwise the shape climbs to the nearest ancestor containing
+   * it and descends again from there
+   */
+  void LooseQuadtree::updateShape(Shape2D *shape) {
+    auto found = this->handles.find(shape);
+    if (found == this->handles.end()) return;
+
+    uint32_t handle = found->second;
+    Entry &entry = this->entries[handle];
+    entry.center = shape->getCenterPt();
+    entry.radius = shape->getRadius();
+
+    QuadtreeNode *node = entry.node;
+    if (this->fitsLoose(node, entry.center, entry.radius)) return;
+    if (node == this->root) return;
+
+    this->unlink(handle);
+    QuadtreeNode *ancestor = node->parent;
+    while (ancestor != this->root && !this->fitsLoose(ancestor, entry.center, entry.radius)) ancestor = ancestor->parent;
+    this->place(handle, ancestor);
+    this->prune(node);
+  }
+
+  void LooseQuadtree::clear() {
+    std::vector<QuadtreeNode *> stack(this->root->children, this->root->children + 4);
+    while (!stack.empty()) {
+      QuadtreeNode *node = stack.back();
+      stack.pop_back();
+      if (node == NULL) continue;
+      stack.insert(stack.end(), node->children, node->children + 4);
+      this->nodePool.release(node);
+    }
+    this->nodePool.release(this->root);
+    this->nodeCount = 0;
+    this->root = this->createNode(NULL, this->rootCenter, this->rootHalfSize);
+
+    this->entries.clear();
+    this->freeEntries.clear();
+    this->handles.clear();
+  }
+
+  void LooseQuadtree::queryRegion(Vector2D low, Vector2D high, std::vector<Shape2D*> &result) const {
+    result.clear();
+    std::vector<const QuadtreeNode *> stack = { this->root };
+    while (!stack.empty()) {
+      const QuadtreeNode *node = stack.back();
+      stack.pop_back();
+      if (node->subtreeCount == 0) continue;
+
+      // the root also holds shapes outside its loose bounds, so it is never culled
+      float looseHalfSize = node->halfSize * this->looseness;
+      if (node != this->root && (
+        node->center.vector[0] + looseHalfSize < low.vector[0] || node->center.vector[0] - looseHalfSize > high.vector[0] ||
+        node->center.vector[1] + looseHalfSize < low.vector[1] || node->center.vector[1] - looseHalfSize > high.vector[1])) continue;
+
+      for (uint32_t handle = node->firstEntry; handle != NO_ENTRY; handle = this->entries[handle].next) {
+        const Entry &entry = this->entries[handle];
+        float dx = std::max({ low.vector[0] - entry.center.vector[0], 0.0f, entry.center.vector[0] - high.vector[0] });
+        float dy = std::max({ low.vector[1] - entry.center.vector[1], 0.0f, entry.center.vector[1] - high.vector[1] });
+        if (dx * dx + dy * dy <= entry.radius * entry.radius) result.push_back(entry.shape);
+      }
+      for (const QuadtreeNode *child : node->children) {
+        if (child != NULL) stack.push_back(child);
+      }
+    }
+  }
+
+  void LooseQuadtree::queryPoint(Vector2D point, std::vector<Shape2D*> &result) const {
+    result.clear();
+    std::vector<const QuadtreeNode *> stack = { this->root };
+    while (!stack.empty()) {
+      const QuadtreeNode *node = stack.back();
+      stack.pop_back();
+      if (node->subtreeCount == 0) continue;
+      if (node != this->root && !circleInLooseCell(node->center, node->halfSize * this->looseness, point, 0.0f)) continue;
+
+      for (uint32_t handle = node->firstEntry; handle != NO_ENTRY; handle = this->entries[handle].next) {
+        const Entry &entry = this->entries[handle];
+        float dx = point.vector[0] - entry.center.vector[0];
+        float dy = point.vector[1] - entry.center.vector[1];
+        if (dx * dx + dy * dy <= entry.radius * entry.radius) result.push_back(entry.shape);
+      }
+      for (const QuadtreeNode *child : node->children) {
+        if (child != NULL) stack.push_back(child);
+      }
+    }
+  }
+
+  size_t LooseQuadtree::getShapeCount() { return this->handles.size(); }
+  size_t LooseQuadtree::getNodeCount() { return this->nodeCount; }
+}
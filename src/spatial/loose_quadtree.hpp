@@ -0,0 +1,107 @@
+#ifndef LOOSE_QUADTREE_HPP
+#define LOOSE_QUADTREE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../2D/shapes.hpp"
+#include "../memory/arena.hpp"
+
+namespace Spatial {
+  /**
+   * @brief Quadtree cell. Its loose bounds are the cell scaled by the tree's looseness around the same center,
+   * every shape stored here has its bounding circle inside them
+   */
+  struct QuadtreeNode {
+    Vector2D center;
+    float halfSize;
+    unsigned int depth;
+    QuadtreeNode *parent;
+    QuadtreeNode *children[4];
+    uint32_t firstEntry;
+    uint32_t entryCount;
+    // shapes stored in this node and every descendant, empty subtrees are returned to the pool
+    uint32_t subtreeCount;
+    bool split;
+  };
+
+  /**
+   * @brief Loose quadtree over the bounding circles (center point and radius) of moving shapes. A shape lives in
+   * the deepest node whose cell contains its center and whose loose bounds contain its whole circle, and a node
+   * only pushes shapes down once it holds more than SPLIT_THRESHOLD of them. Because loose bounds overlap their
+   * neighbours, a shape that moves a little usually still fits its node and updateShape only refreshes the stored
+   * circle; otherwise it is unlinked and re-placed from the nearest ancestor that still contains it.
+   *
+   * Shapes whose circle leaves the root's loose bounds stay in the root, so queries remain exact for them.
+   */
+  class LooseQuadtree {
+    public:
+      static const unsigned int MAX_DEPTH = 16;
+      static const uint32_t SPLIT_THRESHOLD = 8;
+
+      /**
+       * @param center Center of the root cell
+       * @param halfSize Half the side length of the root cell
+       * @param looseness Ratio between loose bounds and cell, greater than 1
+       */
+      LooseQuadtree(Vector2D center, float halfSize, float looseness = 2.0f);
+      LooseQuadtree(const LooseQuadtree&) = delete;
+      LooseQuadtree &operator=(const LooseQuadtree&) = delete;
+
+      void insertShape(Shapes::Shape2D *shape);
+      void removeShape(Shapes::Shape2D *shape);
+      void updateShape(Shapes::Shape2D *shape);
+      void clear();
+
+      /**
+       * @brief Shapes whose bounding circle overlaps the box [low, high], e.g. to cull against the viewport
+       */
+      void queryRegion(Vector2D low, Vector2D high, std::vector<Shapes::Shape2D*> &result) const;
+
+      /**
+       * @brief Shapes whose bounding circle contains point, e.g. to pick under the cursor
+       */
+      void queryPoint(Vector2D point, std::vector<Shapes::Shape2D*> &result) const;
+
+      size_t getShapeCount();
+      size_t getNodeCount();
+    private:
+      static const uint32_t NO_ENTRY = UINT32_MAX;
+
+      /**
+       * @brief A shape's cached bounding circle and its links in the node's entry list
+       */
+      struct Entry {
+        Shapes::Shape2D *shape;
+        Vector2D center;
+        float radius;
+        QuadtreeNode *node;
+        uint32_t previous;
+        uint32_t next;
+      };
+
+      Vector2D rootCenter;
+      float rootHalfSize;
+      float looseness;
+      Memory::BumpArena arena;
+      Memory::NodePool<QuadtreeNode> nodePool;
+      QuadtreeNode *root;
+      size_t nodeCount = 0;
+
+      std::vector<Entry> entries;
+      std::vector<uint32_t> freeEntries;
+      std::unordered_map<Shapes::Shape2D*, uint32_t> handles;
+
+      QuadtreeNode *createNode(QuadtreeNode *parent, Vector2D center, float halfSize);
+      bool fitsLoose(const QuadtreeNode *node, Vector2D center, float radius) const;
+      unsigned int quadrantOf(const QuadtreeNode *node, Vector2D point) const;
+      QuadtreeNode *childFor(QuadtreeNode *node, unsigned int quadrant);
+      void place(uint32_t handle, QuadtreeNode *start);
+      void link(uint32_t handle, QuadtreeNode *node);
+      void unlink(uint32_t handle);
+      void prune(QuadtreeNode *node);
+      void splitNode(QuadtreeNode *node);
+  };
+}
+
+#endif
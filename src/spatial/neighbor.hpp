@@ -0,0 +1,18 @@
+#ifndef NEIGHBOR_HPP
+#define NEIGHBOR_HPP
+
+#include <cstdint>
+
+namespace Spatial {
+  /**
+   * @brief Result of a nearest neighbour or radius query: index into the indexed array and squared distance to the query
+   */
+  struct Neighbor {
+    static const uint32_t NONE = UINT32_MAX;
+
+    uint32_t index;
+    float distanceSquared;
+  };
+}
+
+#endif
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include "rtree.hpp"
+#include "../math/cpu_features.hpp"
+#include "../parallel/thread_pool.hpp"
+
+#ifdef COMPGEOM_X86
+  # include <immintrin.h>
+#endif
+
+using namespace Geometry;
+using namespace Shapes;
+
+namespace Spatial {
+  static const unsigned int GROUPS = RTreePage::CAPACITY / 8;
+  static_assert(RTreePage::CAPACITY % 8 == 0, "page capacity must be a whole number of 8-box groups");
+
+  // -- page kernels ---------------------------------------------------------------------
+
+  /**
+   * @brief One bit per slot of each 8-box group, set when the slot's box overlaps [low, high]
+   */
+  static void overlapMasksScalar(const RTreePage &page, const BoundingBox &window, uint8_t *masks) {
+    for (unsigned int group = 0; group < GROUPS; group++) {
+      uint8_t mask = 0;
+      for (unsigned int lane = 0; lane < 8; lane++) {
+        unsigned int i = group * 8 + lane;
+        bool overlaps = page.minX[i] <= window.high.vector[0] && page.maxX[i] >= window.low.vector[0]
+          && page.minY[i] <= window.high.vector[1] && page.maxY[i] >= window.low.vector[1];
+        mask |= (uint8_t) (overlaps << lane);
+      }
+      masks[group] = mask;
+    }
+  }
+
+  /**
+   * @brief Squared distance from point to every box of the page, 0 inside a box
+   */
+  static void boxDistancesScalar(const RTreePage &page, Vector2D point, float *distances) {
+    for (unsigned int i = 0; i < RTreePage::CAPACITY; i++) {
+      float dx = std::max({ page.minX[i] - point.vector[0], point.vector[0] - page.maxX[i], 0.0f });
+      float dy = std::max({ page.minY[i] - point.vector[1], point.vector[1] - page.maxY[i], 0.0f });
+      distances[i] = dx * dx + dy * dy;
+    }
+  }
+
+#ifdef COMPGEOM_X86
+  #define AVX_TARGET __attribute__((target("avx")))
+
+  AVX_TARGET static void overlapMasksAvx(const RTreePage &page, const BoundingBox &window, uint8_t *masks) {
+    __m256 lowX = _mm256_set1_ps(window.low.vector[0]), lowY = _mm256_set1_ps(window.low.vector[1]);
+    __m256 highX = _mm256_set1_ps(window.high.vector[0]), highY = _mm256_set1_ps(window.high.vector[1]);
+    for (unsigned int group = 0; group < GROUPS; group++) {
+      unsigned int i = group * 8;
+      __m256 x = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_load_ps(page.minX + i), highX, _CMP_LE_OQ),
+        _mm256_cmp_ps(_mm256_load_ps(page.maxX + i), lowX, _CMP_GE_OQ));
+      __m256 y = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_load_ps(page.minY + i), highY, _CMP_LE_OQ),
+        _mm256_cmp_ps(_mm256_load_ps(page.maxY + i), lowY, _CMP_GE_OQ));
+      masks[group] = (uint8_t) _mm256_movemask_ps(_mm256_and_ps(x, y));
+    }
+  }
+
+  AVX_TARGET static void boxDistancesAvx(const RTreePage &page, Vector2D point, float *distances) {
+    __m256 px = _mm256_set1_ps(point.vector[0]), py = _mm256_set1_ps(point.vector[1]);
+    __m256 zero = _mm256_setzero_ps();
+    for (unsigned int i = 0; i < RTreePage::CAPACITY; i += 8) {
+      __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_load_ps(page.minX + i), px), _mm256_sub_ps(px, _mm256_load_ps(page.maxX + i))), zero);
+      __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_load_ps(page.minY + i), py), _mm256_sub_ps(py, _mm256_load_ps(page.maxY + i))), zero);
+      _mm256_storeu_ps(distances + i, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+    }
+  }
+#endif
+
+  static void overlapMasks(const RTreePage &page, const BoundingBox &window, uint8_t *masks) {
+#ifdef COMPGEOM_X86
+    if (CpuFeatures::detectSimdLevel() >= SIMD_AVX2) return overlapMasksAvx(page, window, masks);
+#endif
+    overlapMasksScalar(page, window, masks);
+  }
+
+  static void boxDistances(const RTreePage &page, Vector2D point, float *distances) {
+#ifdef COMPGEOM_X86
+    if (CpuFeatures::detectSimdLevel() >= SIMD_AVX2) return boxDistancesAvx(page, point, distances);
+#endif
+    boxDistancesScalar(page, point, distances);
+  }
+
+  // -- bulk loading ---------------------------------------------------------------------
+
+  /**
+   * @brief A box waiting to be packed: an entry when building the leaves, a page for the levels above
+   */
+  struct PackItem {
+    BoundingBox box;
+    uint32_t id;
+  };
+
+  static inline float centerOf(const BoundingBox &box, unsigned int axis) {
+    return 0.5f * (box.low.vector[axis] + box.high.vector[axis]);
+  }
+
+  /**
+   * @brief Pack one level with Sort-Tile-Recursive and return the boxes of the pages created for it
+   */
+  static std::vector<PackItem> packLevel(std::vector<PackItem> &items, uint32_t level, std::vector<RTreePage> &pages) {
+    const size_t capacity = RTreePage::CAPACITY;
+    size_t pageCount = (items.size() + capacity - 1) / capacity;
+    size_t sliceCount = (size_t) std::ceil(std::sqrt((double) pageCount));
+    size_t sliceSize = sliceCount * capacity;
+
+    Parallel::parallelSort(items.begin(), items.end(), [](const PackItem &a, const PackItem &b) {
+      return centerOf(a.box, 0) < centerOf(b.box, 0);
+    });
+
+    // a slice holds sliceCount full pages, so every slice knows where its pages go and slices pack independently
+    size_t firstPage = pages.size();
+    pages.resize(firstPage + pageCount);
+    std::vector<PackItem> parents(pageCount);
+    size_t slices = (items.size() + sliceSize - 1) / sliceSize;
+    Parallel::parallelFor(0, slices, 1, [&](size_t firstSlice, size_t lastSlice) {
+      for (size_t s = firstSlice; s < lastSlice; s++) {
+        size_t slice = s * sliceSize;
+        size_t sliceEnd = std::min(items.size(), slice + sliceSize);
+        std::sort(items.begin() + slice, items.begin() + sliceEnd, [](const PackItem &a, const PackItem &b) {
+          return centerOf(a.box, 1) < centerOf(b.box, 1);
+        });
+
+        for (size_t first = slice; first < sliceEnd; first += capacity) {
+          size_t last = std::min(sliceEnd, first + capacity);
+          size_t pageIndex = first / capacity;
+          RTreePage &page = pages[firstPage + pageIndex];
+          std::fill(page.minX, page.minX + capacity, std::numeric_limits<float>::infinity());
+          std::fill(page.minY, page.minY + capacity, std::numeric_limits<float>::infinity());
+          std::fill(page.maxX, page.maxX + capacity, -std::numeric_limits<float>::infinity());
+          std::fill(page.maxY, page.maxY + capacity, -std::numeric_limits<float>::infinity());
+          std::fill(page.children, page.children + capacity, 0);
+          page.count = (uint32_t) (last - first);
+          page.level = level;
+
+          BoundingBox bounds = items[first].box;
+          for (size_t i = first; i < last; i++) {
+            const BoundingBox &box = items[i].box;
+            size_t slot = i - first;
+            page.minX[slot] = box.low.vector[0];
+            page.minY[slot] = box.low.vector[1];
+            page.maxX[slot] = box.high.vector[0];
+            page.maxY[slot] = box.high.vector[1];
+            page.children[slot] = items[i].id;
+            for (unsigned int axis = 0; axis < 2; axis++) {
+              bounds.low.vector[axis] = std::min(bounds.low.vector[axis], box.low.vector[axis]);
+              bounds.high.vector[axis] = std::max(bounds.high.vector[axis], box.high.vector[axis]);
+            }
+          }
+          parents[pageIndex] = { bounds, (uint32_t) (firstPage + pageIndex) };
+        }
+      }
+    });
+    return parents;
+  }
+
+  void RTree::build(std::span<const BoundingBox> boxes) {
+    this->pages.clear();
+    this->entryCount = boxes.size();
+    if (boxes.empty()) return;
+
+    size_t capacity = RTreePage::CAPACITY;
+    size_t estimate = 0;
+    for (size_t level = (boxes.size() + capacity - 1) / capacity; ; level = (level + capacity - 1) / capacity) {
+      estimate += level;
+      if (level <= 1) break;
+    }
+    this->pages.reserve(estimate);
+
+    std::vector<PackItem> items(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) items[i] = { boxes[i], (uint32_t) i };
+
+    uint32_t level = 0;
+    do {
+      items = packLevel(items, level++, this->pages);
+    } while (items.size() > 1);
+  }
+
+  void RTree::buildFromShapes(std::span<Shape2D* const> shapes) {
+    std::vector<BoundingBox> boxes(shapes.size());
+    for (size_t i = 0; i < shapes.size(); i++) boxes[i] = boundsOf(shapes[i]);
+    this->build(boxes);
+  }
+
+  BoundingBox RTree::boundsOf(Shape2D *shape) {
+    Vector2D *vertices = shape->getVertices();
+    unsigned int n = shape->getNumberOfSides();
+    if (vertices == NULL || n == 0) {
+      Vector2D center = shape->getCenterPt();
+      float radius = shape->getRadius();
+      return { { center.vector[0] - radius, center.vector[1] - radius }, { center.vector[0] + radius, center.vector[1] + radius } };
+    }
+
+    BoundingBox box = { vertices[0], vertices[0] };
+    for (unsigned int i = 1; i < n; i++) {
+      for (unsigned int axis = 0; axis < 2; axis++) {
+        box.low.vector[axis] = std::min(box.low.vector[axis], vertices[i].vector[axis]);
+        box.high.vector[axis] = std::max(box.high.vector[axis], vertices[i].vector[axis]);
+      }
+    }
+    return box;
+  }
+
+  // -- queries --------------------------------------------------------------------------
+
+  void RTree::query(const BoundingBox &window, std::vector<uint32_t> &result) const {
+    result.clear();
+    if (this->pages.empty()) return;
+
+    uint8_t masks[GROUPS];
+    std::vector<uint32_t> stack = { (uint32_t) (this->pages.size() - 1) };
+    while (!stack.empty()) {
+      const RTreePage &page = this->pages[stack.back()];
+      stack.pop_back();
+
+      overlapMasks(page, window, masks);
+      std::vector<uint32_t> &output = page.level == 0 ? result : stack;
+      for (unsigned int group = 0; group < GROUPS; group++) {
+        unsigned int mask = masks[group];
+        while (mask) {
+          unsigned int lane = __builtin_ctz(mask);
+          mask &= mask - 1;
+          output.push_back(page.children[group * 8 + lane]);
+        }
+      }
+    }
+  }
+
+  void RTree::queryPoint(Vector2D point, std::vector<uint32_t> &result) const {
+    this->query({ point, point }, result);
+  }
+
+  /**
+   * @brief Best first search: pages and entries share one queue ordered by box distance, so entries come out
+   * in increasing distance and the search stops after the k-th
+   */
+  void RTree::nearest(Vector2D point, size_t k, std::vector<Neighbor> &result) const {
+    result.clear();
+    if (this->pages.empty() || k == 0) return;
+
+    struct Candidate {
+      float distanceSquared;
+      uint32_t id;
+      bool entry;
+      bool operator>(const Candidate &other) const { return this->distanceSquared > other.distanceSquared; }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    queue.push({ 0.0f, (uint32_t) (this->pages.size() - 1), false });
+
+    alignas(32) float distances[RTreePage::CAPACITY];
+    while (!queue.empty() && result.size() < k) {
+      Candidate candidate = queue.top();
+      queue.pop();
+      if (candidate.entry) {
+        result.push_back({ candidate.id, candidate.distanceSquared });
+        continue;
+      }
+
+      const RTreePage &page = this->pages[candidate.id];
+      boxDistances(page, point, distances);
+      for (uint32_t slot = 0; slot < page.count; slot++) {
+        queue.push({ distances[slot], page.children[slot], page.level == 0 });
+      }
+    }
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef RTREE_HPP
+#define RTREE_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../2D/shapes.hpp"
+#include "neighbor.hpp"
+
+namespace Spatial {
+  struct BoundingBox {
+    Vector2D low;
+    Vector2D high;
+  };
+
+  /**
+   * @brief One R-tree node filling a 4 KiB page. Boxes are stored as four coordinate arrays so 8 of them can be
+   * tested per AVX instruction; unused slots hold an empty box (low = +inf, high = -inf) that never overlaps
+   * anything, so every scan runs over whole groups of 8 without a scalar tail.
+   */
+  struct alignas(4096) RTreePage {
+    static const unsigned int CAPACITY = 200;
+
+    float minX[CAPACITY];
+    float minY[CAPACITY];
+    float maxX[CAPACITY];
+    float maxY[CAPACITY];
+    // page index in internal nodes, entry index in leaves
+    uint32_t children[CAPACITY];
+    uint32_t count;
+    uint32_t level;
+  };
+  static_assert(sizeof(RTreePage) == 4096, "an R-tree node must fill exactly one page");
+
+  /**
+   * @brief Static R-tree over axis aligned boxes, bulk loaded with Sort-Tile-Recursive: entries are sorted by x into
+   * vertical slices, each slice by y, and packed into full pages, level by level up to the root. Pages live in one
+   * contiguous array with the leaves first and the root last.
+   *
+   * Queries return indices into the array the tree was built from.
+   */
+  class RTree {
+    public:
+      RTree() {};
+
+      /**
+       * @brief Bulk load boxes, the sorts and the slices of every level run as tasks on the global thread pool
+       */
+      void build(std::span<const BoundingBox> boxes);
+
+      /**
+       * @brief Index the bounding boxes of shapes' vertex arrays (or of their bounding circle when they have no
+       * vertices), results index into shapes
+       */
+      void buildFromShapes(std::span<Shapes::Shape2D* const> shapes);
+
+      /**
+       * @brief Entries whose box overlaps window, e.g. the shapes inside the viewport
+       */
+      void query(const BoundingBox &window, std::vector<uint32_t> &result) const;
+
+      /**
+       * @brief Entries whose box contains point
+       */
+      void queryPoint(Vector2D point, std::vector<uint32_t> &result) const;
+
+      /**
+       * @brief The k entries whose boxes are closest to point (0 for boxes containing it), nearest first
+       */
+      void nearest(Vector2D point, size_t k, std::vector<Neighbor> &result) const;
+
+      static BoundingBox boundsOf(Shapes::Shape2D *shape);
+
+      size_t size() const { return this->entryCount; }
+      size_t getPageCount() const { return this->pages.size(); }
+      unsigned int getHeight() const { return this->pages.empty() ? 0 : this->pages.back().level + 1; }
+    private:
+      std::vector<RTreePage> pages;
+      size_t entryCount = 0;
+  };
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include "spatial_hash.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace Spatial {
+  // below this many points per chunk the pass runs as fewer tasks
+  static const size_t MIN_POINTS_PER_TASK = 16384;
+  // buckets sorted together in the second pass, 16 KiB of counters
+  static const unsigned int LOCAL_BUCKET_BITS = 12;
+
+  /**
+   * @brief Two pass counting sort, so no pass scatters across the whole table: points are first split by the high
+   * bits of their bucket into partitions small enough to stay in cache, then every partition is sorted by bucket
+   * on its own. Both passes are stable, which keeps the result independent of the chunk count.
+   */
+  void SpatialHashGrid::build(std::span<const Vector2D> input, unsigned int threadCount) {
+    size_t n = input.size();
+    unsigned int bucketBits = 0;
+    while (((size_t) 1 << bucketBits) < n) bucketBits++;
+    unsigned int localBits = std::min(bucketBits, LOCAL_BUCKET_BITS);
+    size_t bucketCount = (size_t) 1 << bucketBits;
+    size_t partitionCount = bucketCount >> localBits;
+    this->bucketMask = (uint32_t) bucketCount - 1;
+
+    unsigned int chunks = Parallel::chunkCount(n, threadCount, MIN_POINTS_PER_TASK);
+
+    this->points.resize(n);
+    this->indices.resize(n);
+    this->bucketOfPoint.resize(n);
+    this->staged.resize(n);
+    this->bucketStarts.resize(bucketCount + 1);
+
+    // per chunk histogram of partitions
+    std::vector<uint32_t> cursors(chunks * partitionCount, 0);
+    Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+      uint32_t *histogram = cursors.data() + chunk * partitionCount;
+      for (size_t i = first; i < last; i++) {
+        uint32_t bucket = this->bucketOf(this->cellOf(input[i].vector[0]), this->cellOf(input[i].vector[1]));
+        this->bucketOfPoint[i] = bucket;
+        histogram[bucket >> localBits]++;
+      }
+    });
+
+    // exclusive prefix sum ordered by partition, then chunk
+    std::vector<uint32_t> partitionStarts(partitionCount + 1);
+    uint32_t running = 0;
+    for (size_t partition = 0; partition < partitionCount; partition++) {
+      partitionStarts[partition] = running;
+      for (unsigned int chunk = 0; chunk < chunks; chunk++) {
+        uint32_t count = cursors[chunk * partitionCount + partition];
+        cursors[chunk * partitionCount + partition] = running;
+        running += count;
+      }
+    }
+    partitionStarts[partitionCount] = running;
+
+    Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+      uint32_t *cursor = cursors.data() + chunk * partitionCount;
+      for (size_t i = first; i < last; i++) {
+        uint32_t bucket = this->bucketOfPoint[i];
+        this->staged[cursor[bucket >> localBits]++] = { input[i], (uint32_t) i, bucket };
+      }
+    });
+
+    // every partition owns a contiguous range of buckets and of sorted points
+    Parallel::forEachChunk(partitionCount, chunks, [&](size_t first, size_t last, unsigned int) {
+      size_t localCount = (size_t) 1 << localBits;
+      std::vector<uint32_t> starts(localCount + 1);
+      for (size_t partition = first; partition < last; partition++) {
+        uint32_t begin = partitionStarts[partition], end = partitionStarts[partition + 1];
+        uint32_t bucketBase = (uint32_t) (partition << localBits);
+
+        std::fill(starts.begin(), starts.end(), 0);
+        for (uint32_t i = begin; i < end; i++) starts[(this->staged[i].bucket - bucketBase) + 1]++;
+        starts[0] = begin;
+        for (size_t b = 1; b <= localCount; b++) starts[b] += starts[b - 1];
+        std::copy(starts.begin(), starts.end() - 1, this->bucketStarts.begin() + bucketBase);
+
+        for (uint32_t i = begin; i < end; i++) {
+          const StagedPoint &point = this->staged[i];
+          uint32_t slot = starts[point.bucket - bucketBase]++;
+          this->points[slot] = point.position;
+          this->indices[slot] = point.index;
+        }
+      }
+    });
+    this->bucketStarts[bucketCount] = (uint32_t) n;
+  }
+
+  void SpatialHashGrid::radius(Vector2D query, float radius, std::vector<Neighbor> &result) const {
+    result.clear();
+    this->forEachNeighbor(query, radius, [&](uint32_t index, float distanceSquared) {
+      result.push_back({ index, distanceSquared });
+    });
+  }
+
+  void SpatialHashGrid::radiusAll(float radius, std::vector<uint32_t> &offsets, std::vector<Neighbor> &result, unsigned int threadCount) const {
+    size_t n = this->points.size();
+    unsigned int chunks = Parallel::chunkCount(n, threadCount, MIN_POINTS_PER_TASK);
+
+    // every chunk of the sorted points collects into its own buffer, counts per point then place them
+    std::vector<std::vector<Neighbor>> found(chunks);
+    offsets.assign(n + 1, 0);
+    Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+      std::vector<Neighbor> &buffer = found[chunk];
+      for (size_t i = first; i < last; i++) {
+        size_t before = buffer.size();
+        this->forEachNeighbor(this->points[i], radius, [&](uint32_t index, float distanceSquared) {
+          buffer.push_back({ index, distanceSquared });
+        });
+        offsets[this->indices[i] + 1] = (uint32_t) (buffer.size() - before);
+      }
+    });
+    for (size_t i = 1; i <= n; i++) offsets[i] += offsets[i - 1];
+
+    result.resize(offsets[n]);
+    Parallel::forEachChunk(n, chunks, [&](size_t first, size_t last, unsigned int chunk) {
+      const Neighbor *source = found[chunk].data();
+      for (size_t i = first; i < last; i++) {
+        uint32_t index = this->indices[i];
+        uint32_t count = offsets[index + 1] - offsets[index];
+        std::copy(source, source + count, result.begin() + offsets[index]);
+        source += count;
+      }
+    });
+  }
+}
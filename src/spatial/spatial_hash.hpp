@@ -0,0 +1,130 @@
+#ifndef SPATIAL_HASH_HPP
+#define SPATIAL_HASH_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../vectors.hpp"
+#include "neighbor.hpp"
+
+namespace Spatial {
+  /**
+   * @brief Uniform grid hashed into a table of about one bucket per point, rebuilt from scratch every frame.
+   * The build is a counting sort of the points by bucket (count, prefix sum, scatter) with each pass split
+   * across pool tasks. Points of a bucket are stored contiguously and the cells of a grid row hash to consecutive
+   * buckets, so a neighbour query scans one run of points per row.
+   *
+   * Different cells can share a bucket, so queries check each point's own cell before its distance.
+   */
+  class SpatialHashGrid {
+    public:
+      /**
+       * @param cellSize Side of a grid cell, ideally close to the usual query radius
+       */
+      SpatialHashGrid(float cellSize) : cellSize(cellSize), inverseCellSize(1.0f / cellSize) {};
+
+      /**
+       * @brief Rebuild over the current point positions
+       *
+       * @param points Points to index
+       * @param threadCount Tasks to split the work into, 0 uses the global pool's concurrency
+       */
+      void build(std::span<const Vector2D> points, unsigned int threadCount = 0);
+
+      /**
+       * @brief Call visit(index, distanceSquared) for every point within radius of query
+       */
+      template <typename Visit>
+      void forEachNeighbor(Vector2D query, float radius, Visit visit) const {
+        if (this->points.empty()) return;
+
+        float radiusSquared = radius * radius;
+        int32_t lowX = this->cellOf(query.vector[0] - radius), highX = this->cellOf(query.vector[0] + radius);
+        int32_t lowY = this->cellOf(query.vector[1] - radius), highY = this->cellOf(query.vector[1] + radius);
+        auto scan = [&](uint32_t first, uint32_t last, int32_t cellY) {
+          for (uint32_t i = first; i < last; i++) {
+            const Vector2D &p = this->points[i];
+            int32_t cellX = this->cellOf(p.vector[0]);
+            if (cellX < lowX || cellX > highX || this->cellOf(p.vector[1]) != cellY) continue;
+            float dx = p.vector[0] - query.vector[0];
+            float dy = p.vector[1] - query.vector[1];
+            float distanceSquared = dx * dx + dy * dy;
+            if (distanceSquared <= radiusSquared) visit(this->indices[i], distanceSquared);
+          }
+        };
+
+        // 64-bit row counter and width, highY may be INT32_MAX when the query reaches the clamped range
+        for (int64_t row = lowY; row <= highY; row++) {
+          int32_t cellY = (int32_t) row;
+          // cells of a row hash to consecutive buckets, so a row is one run, or two when it wraps around the table
+          if ((int64_t) highX - lowX >= (int64_t) this->bucketMask) {
+            scan(0, (uint32_t) this->points.size(), cellY);
+            continue;
+          }
+          uint32_t firstBucket = this->bucketOf(lowX, cellY);
+          uint32_t lastBucket = this->bucketOf(highX, cellY);
+          if (firstBucket <= lastBucket) {
+            scan(this->bucketStarts[firstBucket], this->bucketStarts[lastBucket + 1], cellY);
+          } else {
+            scan(this->bucketStarts[firstBucket], (uint32_t) this->points.size(), cellY);
+            scan(0, this->bucketStarts[lastBucket + 1], cellY);
+          }
+        }
+      }
+
+      /**
+       * @brief Every point within radius of query, in no particular order
+       */
+      void radius(Vector2D query, float radius, std::vector<Neighbor> &result) const;
+
+      /**
+       * @brief Neighbours within radius of every indexed point, itself included. Points are visited in bucket order,
+       * so consecutive searches scan the same rows while they are cached, split across pool tasks
+       *
+       * @param offsets Neighbours of point i are result[offsets[i] .. offsets[i + 1])
+       * @param threadCount Tasks to split the work into, 0 uses the global pool's concurrency
+       */
+      void radiusAll(float radius, std::vector<uint32_t> &offsets, std::vector<Neighbor> &result, unsigned int threadCount = 0) const;
+
+      size_t size() const { return this->points.size(); }
+      float getCellSize() const { return this->cellSize; }
+    private:
+      float cellSize;
+      float inverseCellSize;
+      uint32_t bucketMask = 0;
+      // points sorted by bucket, their original index and where each bucket starts (one extra entry at the end)
+      std::vector<Vector2D> points;
+      std::vector<uint32_t> indices;
+      std::vector<uint32_t> bucketStarts;
+      std::vector<uint32_t> bucketOfPoint;
+
+      /**
+       * @brief A point between the two passes of the build
+       */
+      struct StagedPoint {
+        Vector2D position;
+        uint32_t index;
+        uint32_t bucket;
+      };
+      std::vector<StagedPoint> staged;
+
+      /**
+       * @brief Cell index along one axis, floor(coordinate / cellSize) clamped to the int32 range so far away points
+       * and queries near the float limits share the edge cells instead of overflowing the conversion. NaN goes
+       * to the lowest cell
+       */
+      int32_t cellOf(float coordinate) const {
+        // largest floats on either side that convert to int32 exactly
+        const float LOWEST = -2147483648.0f, HIGHEST = 2147483520.0f;
+        float scaled = coordinate * this->inverseCellSize;
+        scaled = !(scaled >= LOWEST) ? LOWEST : scaled > HIGHEST ? HIGHEST : scaled;
+        int32_t truncated = (int32_t) scaled;
+        return truncated - (scaled < (float) truncated);
+      }
+      uint32_t bucketOf(int32_t cellX, int32_t cellY) const {
+        return ((uint32_t) cellY * 2654435761u + (uint32_t) cellX) & this->bucketMask;
+      }
+  };
+}
+
+#endif
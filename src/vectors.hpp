@@ -1,2 +1,7 @@
+#ifndef VECTORS_HPP
+#define VECTORS_HPP
+
 typedef struct Vector2D { float vector[2]; } Vector2D;
-typedef struct Vector3D { float vector[3]; } Vector3D;
\ No newline at end of file
+typedef struct Vector3D { float vector[3]; } Vector3D;
+
+#endif
@@ -0,0 +1,122 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../src/2D/delaunay.hpp"
+#include "../src/math/predicates.hpp"
+
+using namespace Geometry;
+
+/**
+ * @brief Structural checks of Delaunay::triangulate on degenerate input: every triangle counterclockwise, every
+ * interior edge locally Delaunay, the boundary one convex loop through all hull vertices and the triangle count
+ * 2n - h - 2 for n distinct points and h boundary vertices
+ */
+
+static double orient(const Vector2D &a, const Vector2D &b, const Vector2D &c) {
+  return Predicates::orient2d(a.vector[0], a.vector[1], b.vector[0], b.vector[1], c.vector[0], c.vector[1]);
+}
+
+static double incircle(const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D &d) {
+  double pa[2] = { a.vector[0], a.vector[1] }, pb[2] = { b.vector[0], b.vector[1] };
+  double pc[2] = { c.vector[0], c.vector[1] }, pd[2] = { d.vector[0], d.vector[1] };
+  return Predicates::incircle(pa, pb, pc, pd);
+}
+
+static const char *check(const std::vector<Vector2D> &points) {
+  Triangulation mesh = Delaunay::triangulate(points);
+  const std::vector<uint32_t> &v = mesh.triangles;
+  size_t triangleCount = mesh.triangleCount();
+
+  std::set<std::pair<float, float>> distinct;
+  for (const Vector2D &p : points) distinct.insert({ p.vector[0], p.vector[1] });
+
+  std::unordered_map<uint32_t, uint32_t> boundaryNext;
+  for (size_t t = 0; t < triangleCount; t++) {
+    if (orient(points[v[3 * t]], points[v[3 * t + 1]], points[v[3 * t + 2]]) <= 0.0) return "triangle not counterclockwise";
+    for (uint32_t k = 0; k < 3; k++) {
+      uint32_t from = v[3 * t + (k + 1) % 3], to = v[3 * t + (k + 2) % 3];
+      uint32_t neighbor = mesh.adjacency[3 * t + k];
+      if (neighbor == Triangulation::NO_NEIGHBOR) {
+        if (!boundaryNext.emplace(from, to).second) return "boundary vertex left twice";
+        continue;
+      }
+      uint32_t opposite = v[3 * neighbor] + v[3 * neighbor + 1] + v[3 * neighbor + 2] - from - to;
+      if (incircle(points[v[3 * t]], points[v[3 * t + 1]], points[v[3 * t + 2]], points[opposite]) > 0.0) return "edge not locally Delaunay";
+    }
+  }
+
+  // the boundary is a single convex loop
+  if (boundaryNext.empty()) return "no boundary";
+  uint32_t start = boundaryNext.begin()->first, vertex = start;
+  size_t hullCount = 0;
+  do {
+    auto next = boundaryNext.find(vertex);
+    auto afterNext = next == boundaryNext.end() ? next : boundaryNext.find(next->second);
+    if (afterNext == boundaryNext.end()) return "boundary is not closed";
+    if (orient(points[vertex], points[next->second], points[afterNext->second]) < 0.0) return "boundary not convex";
+    vertex = next->second;
+    hullCount++;
+  } while (vertex != start && hullCount <= boundaryNext.size());
+  if (hullCount != boundaryNext.size()) return "boundary is not one loop";
+
+  if (triangleCount != 2 * distinct.size() - hullCount - 2) return "triangle count is not 2n - h - 2";
+  return NULL;
+}
+
+int main() {
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  int failures = 0;
+  auto run = [&](const char *name, unsigned int trial, const std::vector<Vector2D> &points) {
+    const char *error = check(points);
+    if (error == NULL) return;
+    std::printf("FAIL %s #%u (n = %zu): %s\n", name, trial, points.size(), error);
+    failures++;
+  };
+
+  // cocircular points, float rounding leaves them nearly but not exactly on the circle
+  for (unsigned int trial = 0; trial < 30; trial++) {
+    size_t n = 3000 + rng() % 17000;
+    std::vector<Vector2D> points(n);
+    for (Vector2D &p : points) {
+      double angle = 2.0 * M_PI * (unit(rng) * 0.5 + 0.5);
+      p = { { (float) std::cos(angle), (float) std::sin(angle) } };
+    }
+    run("on-circle", trial, points);
+  }
+
+  // short arcs of huge circles: consecutive hull vertices are nearly collinear, their circumcircles reach far out
+  for (unsigned int trial = 0; trial < 20; trial++) {
+    double radius = std::pow(10.0, 2 + trial % 5);
+    std::vector<Vector2D> points(2000);
+    for (Vector2D &p : points) {
+      double angle = unit(rng) / radius;
+      p = { { (float) (radius * std::sin(angle)), (float) (radius * std::cos(angle) - radius) } };
+    }
+    run("arc", trial, points);
+  }
+
+  // exactly cocircular and collinear: integer grids, with duplicates
+  for (unsigned int trial = 0; trial < 20; trial++) {
+    unsigned int side = 2 + trial * 5;
+    std::vector<Vector2D> points;
+    for (unsigned int i = 0; i < side * side; i++) points.push_back({ { (float) (i % side), (float) (i / side) } });
+    for (unsigned int i = 0; i < side; i++) points.push_back(points[rng() % points.size()]);
+    run("grid", trial, points);
+  }
+
+  // uniform points plus points on the hull edges of their bounding square
+  for (unsigned int trial = 0; trial < 20; trial++) {
+    std::vector<Vector2D> points(5000);
+    for (Vector2D &p : points) p = { { unit(rng), unit(rng) } };
+    for (unsigned int i = 0; i < 200; i++) points.push_back({ { unit(rng), i % 2 == 0 ? -1.0f : 1.0f } });
+    run("square", trial, points);
+  }
+
+  if (failures == 0) std::printf("delaunay: all checks passed\n");
+  return failures == 0 ? 0 : 1;
+}